@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "UsdBridgeConnection.h"
+#include "../UsdBridgeTrace.h"
 
 #include <fstream>
 #include <atomic>
@@ -56,6 +57,58 @@ namespace fs = std::filesystem;
     return a;                                                                  \
   }
 
+namespace
+{
+  // Buffers all output in memory, to write it out as a whole on close
+  class UsdBridgeMemoryOutputStream : public UsdBridgeOutputStream
+  {
+  public:
+    UsdBridgeMemoryOutputStream(const char* filePath, bool binary)
+      : FilePath(filePath)
+      , Binary(binary)
+    {}
+
+    std::ostream& GetOutput() override { return Output; }
+
+    std::string FilePath;
+    bool Binary;
+    std::ostringstream Output;
+  };
+
+  class UsdBridgeLocalOutputStream : public UsdBridgeOutputStream
+  {
+  public:
+    UsdBridgeLocalOutputStream()
+      : Output(&FileBuf)
+    {}
+
+    std::ostream& GetOutput() override { return Output; }
+
+    UsdBridgeLocalFileBuf FileBuf;
+    std::ostream Output;
+  };
+
+  class UsdBridgeNullBuf : public std::streambuf
+  {
+  protected:
+    int_type overflow(int_type ch) override { return traits_type::not_eof(ch); }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+  };
+
+  class UsdBridgeVoidOutputStream : public UsdBridgeOutputStream
+  {
+  public:
+    UsdBridgeVoidOutputStream()
+      : Output(&NullBuf)
+    {}
+
+    std::ostream& GetOutput() override { return Output; }
+
+    UsdBridgeNullBuf NullBuf;
+    std::ostream Output;
+  };
+}
+
 UsdBridgeLogCallback UsdBridgeConnection::LogCallback = nullptr;
 void* UsdBridgeConnection::LogUserData = nullptr;
 
@@ -148,42 +201,140 @@ bool UsdBridgeConnection::WriteFile(const char* data, size_t dataSize, const cha
   return false;
 }
 
+bool UsdBridgeConnection::WriteFileGather(const UsdBridgeWriteRange* ranges, size_t numRanges, const char* filePath, bool binary) const
+{
+  try
+  {
+    std::ofstream file(Settings.WorkingDirectory + filePath, std::ios_base::out
+      | std::ios_base::trunc
+      | (binary ? std::ios_base::binary : std::ios_base::out));
+    if (file.is_open())
+    {
+      for (size_t i = 0; i < numRanges; ++i)
+        file.write(ranges[i].Data, ranges[i].Size);
+      file.close();
+      return true;
+    }
+  }
+  CONNECT_CATCH(false)
+
+  return false;
+}
+
 bool UsdBridgeConnection::RemoveFile(const char* filePath) const
 {
   bool success = false;
   try
   {
-    TempUrl = Settings.WorkingDirectory + filePath;
-    if (fs::exists(TempUrl))
-      success = fs::remove(TempUrl);
+    // Files may be removed from another thread, so TempUrl is not used
+    std::string fileUrl = Settings.WorkingDirectory + filePath;
+    if (fs::exists(fileUrl))
+      success = fs::remove(fileUrl);
+  }
+  CONNECT_CATCH(false)
+
+  return success;
+}
+
+bool UsdBridgeConnection::RenameFile(const char* filePath, const char* newFilePath) const
+{
+  try
+  {
+    fs::rename(Settings.WorkingDirectory + filePath, Settings.WorkingDirectory + newFilePath);
+    return true;
+  }
+  CONNECT_CATCH(false)
+}
+
+bool UsdBridgeConnection::ReadFile(const char* filePath, std::string& contents) const
+{
+  try
+  {
+    std::ifstream file(Settings.WorkingDirectory + filePath, std::ios_base::in | std::ios_base::binary);
+    if (file.is_open())
+    {
+      std::stringstream fileContents;
+      fileContents << file.rdbuf();
+      contents = fileContents.str();
+      return !file.bad();
+    }
   }
   CONNECT_CATCH(false)
 
+  return false;
+}
+
+bool UsdBridgeConnection::SyncOutput() const
+{
+  return true;
+}
+
+UsdBridgeOutputStream* UsdBridgeConnection::OpenStream(const char* filePath, bool binary)
+{
+  AcquireStreamSlot();
+  return new UsdBridgeMemoryOutputStream(filePath, binary);
+}
+
+bool UsdBridgeConnection::CloseStream(UsdBridgeOutputStream* stream)
+{
+  UsdBridgeMemoryOutputStream* memoryStream = static_cast<UsdBridgeMemoryOutputStream*>(stream);
+
+  std::string data = memoryStream->Output.str(); // Invokes an extra copy, remove once omniverse supports streaming
+  bool success = !memoryStream->Output.bad()
+    && WriteFile(data.c_str(), data.length(), memoryStream->FilePath.c_str(), memoryStream->Binary);
+
+  delete memoryStream;
+  ReleaseStreamSlot();
+
   return success;
 }
 
+std::ostream* UsdBridgeConnection::GetStream(const char* filePath, bool binary)
+{
+  FlushStream();
+
+  CurrentStream = OpenStream(filePath, binary);
+  return CurrentStream ? &CurrentStream->GetOutput() : nullptr;
+}
+
+void UsdBridgeConnection::FlushStream()
+{
+  if (CurrentStream && !CloseStream(CurrentStream))
+  {
+    UsdBridgeLogMacro(UsdBridgeLogLevel::ERR, "Failed writing stream output, is the disk full?");
+  }
+  CurrentStream = nullptr;
+}
+
 bool UsdBridgeConnection::ProcessUpdates()
 {
   return true;
 }
 
+void UsdBridgeConnection::AcquireStreamSlot()
+{
+  std::unique_lock<std::mutex> lock(StreamSlotMutex);
+  StreamSlotReleased.wait(lock, [this]() { return NumOpenStreams < std::max(Settings.MaxOpenStreams, 1); });
+  ++NumOpenStreams;
+}
+
+void UsdBridgeConnection::ReleaseStreamSlot()
+{
+  {
+    std::lock_guard<std::mutex> lock(StreamSlotMutex);
+    --NumOpenStreams;
+  }
+  StreamSlotReleased.notify_one();
+}
+
 class UsdBridgeRemoteConnectionInternals
 {
 public:
   UsdBridgeRemoteConnectionInternals()
-    : RemoteStream(std::ios::in | std::ios::out)
   {}
   ~UsdBridgeRemoteConnectionInternals()
   {}
 
-  std::ostream* ResetStream(const char * filePath, bool binary)
-  {
-    StreamFilePath = filePath;
-    StreamIsBinary = binary;
-    RemoteStream.clear();
-    return &RemoteStream;
-  }
-
   // To facility the Omniverse path methods
   static constexpr size_t MaxBaseUrlSize = 4096;
   char BaseUrlBuffer[MaxBaseUrlSize];
@@ -192,10 +343,8 @@ public:
   // Status callback handle
   uint32_t StatusCallbackHandle = 0;
 
-  // Stream
-  const char* StreamFilePath;
-  bool StreamIsBinary;
-  std::stringstream RemoteStream;
+  // Serializes use of the url buffers by streams closed from multiple threads
+  std::mutex WriteMutex;
 };
 
 int UsdBridgeRemoteConnection::NumConnInstances = 0;
@@ -209,6 +358,7 @@ UsdBridgeRemoteConnection::UsdBridgeRemoteConnection()
 
 UsdBridgeRemoteConnection::~UsdBridgeRemoteConnection()
 {
+  FlushStream();
   delete Internals;
 }
 
@@ -524,9 +674,13 @@ bool UsdBridgeRemoteConnection::RemoveFolder(const char* dirName) const
 
 bool UsdBridgeRemoteConnection::WriteFile(const char* data, size_t dataSize, const char* filePath, bool binary) const
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeRemoteConnection::WriteFile");
+
   (void)binary;
   UsdBridgeLogMacro(UsdBridgeLogLevel::STATUS, "Copying data to: " << filePath);
 
+  std::lock_guard<std::mutex> lock(Internals->WriteMutex);
+
   DefaultContext context;
 
   const char* fileUrl = this->GetUrl(filePath);
@@ -542,12 +696,25 @@ bool UsdBridgeRemoteConnection::WriteFile(const char* data, size_t dataSize, con
   return context.result == eOmniClientResult_Ok || context.result == eOmniClientResult_OkLatest;
 }
 
+bool UsdBridgeRemoteConnection::WriteFileGather(const UsdBridgeWriteRange* ranges, size_t numRanges, const char* filePath, bool binary) const
+{
+  // The client library writes a file from a single buffer
+  std::string data;
+  for (size_t i = 0; i < numRanges; ++i)
+    data.append(ranges[i].Data, ranges[i].Size);
+
+  return WriteFile(data.data(), data.size(), filePath, binary);
+}
+
 bool UsdBridgeRemoteConnection::RemoveFile(const char* filePath) const
 {
   DefaultContext context;
   UsdBridgeLogMacro(UsdBridgeLogLevel::STATUS, "Removing file: " << filePath);
 
-  const char* fileUrl = this->GetUrl(filePath);
+  // Files may be removed from another thread, so the url is not combined into TempUrlBuffer
+  char fileUrlBuffer[UsdBridgeRemoteConnectionInternals::MaxBaseUrlSize];
+  size_t parsedBufSize = Internals->MaxBaseUrlSize;
+  const char* fileUrl = omniClientCombineUrls(Internals->BaseUrlBuffer, filePath, fileUrlBuffer, &parsedBufSize);
   omniClientWait(omniClientDelete(fileUrl, &context, [](void* userData, OmniClientResult result) OMNICLIENT_NOEXCEPT
     {
       auto& context = *(DefaultContext*)(userData);
@@ -559,6 +726,27 @@ bool UsdBridgeRemoteConnection::RemoveFile(const char* filePath) const
   return context.result == eOmniClientResult_Ok || context.result == eOmniClientResult_OkLatest;
 }
 
+bool UsdBridgeRemoteConnection::RenameFile(const char* filePath, const char* newFilePath) const
+{
+  DefaultContext context;
+
+  char srcUrlBuffer[UsdBridgeRemoteConnectionInternals::MaxBaseUrlSize];
+  char dstUrlBuffer[UsdBridgeRemoteConnectionInternals::MaxBaseUrlSize];
+  size_t srcBufSize = Internals->MaxBaseUrlSize;
+  size_t dstBufSize = Internals->MaxBaseUrlSize;
+  const char* srcUrl = omniClientCombineUrls(Internals->BaseUrlBuffer, filePath, srcUrlBuffer, &srcBufSize);
+  const char* dstUrl = omniClientCombineUrls(Internals->BaseUrlBuffer, newFilePath, dstUrlBuffer, &dstBufSize);
+  omniClientWait(omniClientMove(srcUrl, dstUrl, &context, [](void* userData, OmniClientResult result, bool copied) OMNICLIENT_NOEXCEPT
+    {
+      auto& context = *(DefaultContext*)(userData);
+      context.result = result;
+      context.done = true;
+    }, eOmniClientCopy_Overwrite)
+  );
+
+  return context.result == eOmniClientResult_Ok || context.result == eOmniClientResult_OkLatest;
+}
+
 bool UsdBridgeRemoteConnection::LockFile(const char* filePath) const
 {
   const char* fileUrl = this->GetUrl(filePath);
@@ -581,15 +769,62 @@ bool UsdBridgeRemoteConnection::UnlockFile(const char* filePath) const
   return true;
 }
 
+bool UsdBridgeRemoteConnection::ReadFile(const char* filePath, std::string& contents) const
+{
+  struct ReadFileContext : public DefaultContext
+  {
+    std::string* contents;
+  } context;
+  context.contents = &contents;
+
+  std::lock_guard<std::mutex> lock(Internals->WriteMutex);
+
+  const char* fileUrl = this->GetUrl(filePath);
+  omniClientWait(omniClientReadFile(fileUrl, &context,
+    [](void* userData, OmniClientResult result, char const* version, struct OmniClientContent* content) OMNICLIENT_NOEXCEPT
+    {
+      auto& context = *(ReadFileContext*)(userData);
+      context.result = result;
+      if (result == eOmniClientResult_Ok && content)
+        context.contents->assign((const char*)content->buffer, content->size);
+      context.done = true;
+    })
+  );
+
+  return context.result == eOmniClientResult_Ok;
+}
+
+bool UsdBridgeRemoteConnection::SyncOutput() const
+{
+  return true; // Durability is up to the server
+}
+
+UsdBridgeOutputStream* UsdBridgeRemoteConnection::OpenStream(const char* filePath, bool binary)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeRemoteConnection::OpenStream");
+
+  return UsdBridgeConnection::OpenStream(filePath, binary);
+}
+
+bool UsdBridgeRemoteConnection::CloseStream(UsdBridgeOutputStream* stream)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeRemoteConnection::CloseStream");
+
+  return UsdBridgeConnection::CloseStream(stream);
+}
+
 std::ostream * UsdBridgeRemoteConnection::GetStream(const char * filePath, bool binary)
 {
-  return Internals->ResetStream(filePath, binary);
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeRemoteConnection::GetStream");
+
+  return UsdBridgeConnection::GetStream(filePath, binary);
 }
 
 void UsdBridgeRemoteConnection::FlushStream()
 {
-  std::string data = Internals->RemoteStream.str();// Invokes an extra copy, remove once omniverse supports streaming
-  WriteFile(data.c_str(), data.length(), Internals->StreamFilePath, Internals->StreamIsBinary);
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeRemoteConnection::FlushStream");
+
+  UsdBridgeConnection::FlushStream();
 }
 
 bool UsdBridgeRemoteConnection::ProcessUpdates()
@@ -659,14 +894,28 @@ bool UsdBridgeRemoteConnection::RemoveFolder(const char* dirName) const
 
 bool UsdBridgeRemoteConnection::WriteFile(const char* data, size_t dataSize, const char* filePath, bool binary) const
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeRemoteConnection::WriteFile");
+
   return UsdBridgeConnection::WriteFile(data, dataSize, filePath, binary);
 }
 
+bool UsdBridgeRemoteConnection::WriteFileGather(const UsdBridgeWriteRange* ranges, size_t numRanges, const char* filePath, bool binary) const
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeRemoteConnection::WriteFileGather");
+
+  return UsdBridgeConnection::WriteFileGather(ranges, numRanges, filePath, binary);
+}
+
 bool UsdBridgeRemoteConnection::RemoveFile(const char* filePath) const
 {
   return UsdBridgeConnection::RemoveFile(filePath);
 }
 
+bool UsdBridgeRemoteConnection::RenameFile(const char* filePath, const char* newFilePath) const
+{
+  return UsdBridgeConnection::RenameFile(filePath, newFilePath);
+}
+
 bool UsdBridgeRemoteConnection::LockFile(const char* filePath) const
 {
   return true;
@@ -677,13 +926,42 @@ bool UsdBridgeRemoteConnection::UnlockFile(const char* filePath) const
   return true;
 }
 
+bool UsdBridgeRemoteConnection::ReadFile(const char* filePath, std::string& contents) const
+{
+  return UsdBridgeConnection::ReadFile(filePath, contents);
+}
+
+bool UsdBridgeRemoteConnection::SyncOutput() const
+{
+  return true;
+}
+
+UsdBridgeOutputStream* UsdBridgeRemoteConnection::OpenStream(const char* filePath, bool binary)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeRemoteConnection::OpenStream");
+
+  return UsdBridgeConnection::OpenStream(filePath, binary);
+}
+
+bool UsdBridgeRemoteConnection::CloseStream(UsdBridgeOutputStream* stream)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeRemoteConnection::CloseStream");
+
+  return UsdBridgeConnection::CloseStream(stream);
+}
+
 std::ostream * UsdBridgeRemoteConnection::GetStream(const char * filePath, bool binary)
 {
-  return Internals->ResetStream(filePath, binary);
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeRemoteConnection::GetStream");
+
+  return UsdBridgeConnection::GetStream(filePath, binary);
 }
 
 void UsdBridgeRemoteConnection::FlushStream()
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeRemoteConnection::FlushStream");
+
+  UsdBridgeConnection::FlushStream();
 }
 
 bool UsdBridgeRemoteConnection::ProcessUpdates()
@@ -716,6 +994,7 @@ UsdBridgeLocalConnection::UsdBridgeLocalConnection()
 
 UsdBridgeLocalConnection::~UsdBridgeLocalConnection()
 {
+  FlushStream();
 }
 
 const char* UsdBridgeLocalConnection::GetBaseUrl() const
@@ -778,7 +1057,21 @@ bool UsdBridgeLocalConnection::RemoveFolder(const char* dirName) const
 
 bool UsdBridgeLocalConnection::WriteFile(const char* data, size_t dataSize, const char* filePath, bool binary) const
 {
-  return UsdBridgeConnection::WriteFile(data, dataSize, filePath, binary);
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeLocalConnection::WriteFile");
+
+  UsdBridgeWriteRange range = { data, dataSize };
+  return WriteFileGather(&range, 1, filePath, binary);
+}
+
+bool UsdBridgeLocalConnection::WriteFileGather(const UsdBridgeWriteRange* ranges, size_t numRanges, const char* filePath, bool binary) const
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeLocalConnection::WriteFileGather");
+
+  // Always binary, text files are written with unix line endings on all platforms
+  (void)binary;
+  std::string fullPath = Settings.WorkingDirectory + filePath;
+  return UsdBridgeWriteLocalFile(fullPath.c_str(), ranges, numRanges, Settings.DirectIO,
+    Settings.SyncPolicy == UsdBridgeSyncPolicy::ALWAYS);
 }
 
 bool UsdBridgeLocalConnection::RemoveFile(const char* filePath) const
@@ -786,6 +1079,11 @@ bool UsdBridgeLocalConnection::RemoveFile(const char* filePath) const
   return UsdBridgeConnection::RemoveFile(filePath);
 }
 
+bool UsdBridgeLocalConnection::RenameFile(const char* filePath, const char* newFilePath) const
+{
+  return UsdBridgeConnection::RenameFile(filePath, newFilePath);
+}
+
 bool UsdBridgeLocalConnection::LockFile(const char* filePath) const
 {
   return true;
@@ -796,26 +1094,72 @@ bool UsdBridgeLocalConnection::UnlockFile(const char* filePath) const
   return true;
 }
 
-std::ostream * UsdBridgeLocalConnection::GetStream(const char* filePath, bool binary)
+bool UsdBridgeLocalConnection::ReadFile(const char* filePath, std::string& contents) const
+{
+  return UsdBridgeConnection::ReadFile(filePath, contents);
+}
+
+bool UsdBridgeLocalConnection::SyncOutput() const
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeLocalConnection::SyncOutput");
+
+  if (Settings.SyncPolicy == UsdBridgeSyncPolicy::NONE)
+    return true;
+
+  bool success = UsdBridgeSyncLocalFileSystem(Settings.WorkingDirectory.c_str());
+  if (!success)
+  {
+    UsdBridgeLogMacro(UsdBridgeLogLevel::WARNING, "Could not flush output to storage in " << Settings.WorkingDirectory);
+  }
+  return success;
+}
+
+UsdBridgeOutputStream* UsdBridgeLocalConnection::OpenStream(const char* filePath, bool binary)
 {
-  if (LocalStream.is_open())
-    LocalStream.close();
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeLocalConnection::OpenStream");
 
-  LocalStream.open(Settings.WorkingDirectory + filePath,
-    std::ios_base::out
-    | std::ios_base::trunc
-    | (binary ? std::ios_base::binary : std::ios_base::out));
+  (void)binary;
+  AcquireStreamSlot();
 
-  if (!LocalStream.is_open())
+  UsdBridgeLocalOutputStream* stream = new UsdBridgeLocalOutputStream();
+  std::string fullPath = Settings.WorkingDirectory + filePath;
+  if (!stream->FileBuf.Open(fullPath.c_str(), Settings.DirectIO))
+  {
+    delete stream;
+    ReleaseStreamSlot();
     return nullptr;
+  }
+
+  return stream;
+}
+
+bool UsdBridgeLocalConnection::CloseStream(UsdBridgeOutputStream* stream)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeLocalConnection::CloseStream");
+
+  UsdBridgeLocalOutputStream* localStream = static_cast<UsdBridgeLocalOutputStream*>(stream);
+  localStream->Output.flush();
+  bool success = localStream->FileBuf.Close(Settings.SyncPolicy == UsdBridgeSyncPolicy::ALWAYS)
+    && !localStream->Output.bad();
+
+  delete localStream;
+  ReleaseStreamSlot();
+
+  return success;
+}
+
+std::ostream * UsdBridgeLocalConnection::GetStream(const char* filePath, bool binary)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeLocalConnection::GetStream");
 
-  return &LocalStream;
+  return UsdBridgeConnection::GetStream(filePath, binary);
 }
 
 void UsdBridgeLocalConnection::FlushStream()
 {
-  if (LocalStream.is_open())
-    LocalStream.close();
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeLocalConnection::FlushStream");
+
+  UsdBridgeConnection::FlushStream();
 }
 
 bool UsdBridgeLocalConnection::ProcessUpdates()
@@ -832,6 +1176,7 @@ UsdBridgeVoidConnection::UsdBridgeVoidConnection()
 
 UsdBridgeVoidConnection::~UsdBridgeVoidConnection()
 {
+  FlushStream();
 }
 
 const char* UsdBridgeVoidConnection::GetBaseUrl() const
@@ -876,11 +1221,21 @@ bool UsdBridgeVoidConnection::WriteFile(const char* data, size_t dataSize, const
   return true;
 }
 
+bool UsdBridgeVoidConnection::WriteFileGather(const UsdBridgeWriteRange* ranges, size_t numRanges, const char* filePath, bool binary) const
+{
+  return true;
+}
+
 bool UsdBridgeVoidConnection::RemoveFile(const char* filePath) const
 {
   return true;
 }
 
+bool UsdBridgeVoidConnection::RenameFile(const char* filePath, const char* newFilePath) const
+{
+  return true;
+}
+
 bool UsdBridgeVoidConnection::LockFile(const char* filePath) const
 {
   return true;
@@ -891,14 +1246,35 @@ bool UsdBridgeVoidConnection::UnlockFile(const char* filePath) const
   return true;
 }
 
+bool UsdBridgeVoidConnection::ReadFile(const char* filePath, std::string& contents) const
+{
+  return false;
+}
+
+bool UsdBridgeVoidConnection::SyncOutput() const
+{
+  return true;
+}
+
+UsdBridgeOutputStream* UsdBridgeVoidConnection::OpenStream(const char* filePath, bool binary)
+{
+  return new UsdBridgeVoidOutputStream();
+}
+
+bool UsdBridgeVoidConnection::CloseStream(UsdBridgeOutputStream* stream)
+{
+  delete stream;
+  return true;
+}
+
 std::ostream * UsdBridgeVoidConnection::GetStream(const char* filePath, bool binary)
 {
-  DummyStream.clear();
-  return &DummyStream;
+  return UsdBridgeConnection::GetStream(filePath, binary);
 }
 
 void UsdBridgeVoidConnection::FlushStream()
 {
+  UsdBridgeConnection::FlushStream();
 }
 
 bool UsdBridgeVoidConnection::ProcessUpdates()
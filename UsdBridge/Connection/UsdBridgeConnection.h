@@ -5,10 +5,13 @@
 #define UsdBridgeConnection_h
 
 #include "../UsdBridgeData.h"
+#include "UsdBridgeLocalFile.h"
 
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <mutex>
+#include <condition_variable>
 
 class UsdBridgeRemoteConnectionInternals;
 
@@ -16,6 +19,18 @@ struct UsdBridgeConnectionSettings
 {
   std::string HostName;
   std::string WorkingDirectory;
+  bool DirectIO = false; // Bypass the page cache for local output
+  UsdBridgeSyncPolicy SyncPolicy = UsdBridgeSyncPolicy::NONE;
+  int MaxOpenStreams = 16; // Bound on concurrently open output streams, which each hold a file and write buffer
+};
+
+// Independent output stream to a single file, see UsdBridgeConnection::OpenStream()
+class UsdBridgeOutputStream
+{
+public:
+  virtual ~UsdBridgeOutputStream() {}
+
+  virtual std::ostream& GetOutput() = 0;
 };
 
 class UsdBridgeConnection
@@ -36,10 +51,23 @@ public:
   virtual bool CreateFolder(const char* dirName, bool mayExist) const = 0;
   virtual bool RemoveFolder(const char* dirName) const = 0;
   virtual bool WriteFile(const char* data, size_t dataSize, const char* filePath, bool binary = true) const = 0;
-  virtual bool RemoveFile(const char* filePath) const = 0;
+  virtual bool WriteFileGather(const UsdBridgeWriteRange* ranges, size_t numRanges, const char* filePath, bool binary = true) const = 0;
+  virtual bool RemoveFile(const char* filePath) const = 0; // May be called concurrently with the other functions
+  virtual bool RenameFile(const char* filePath, const char* newFilePath) const = 0; // Replaces any file at newFilePath, may be called concurrently
   virtual bool LockFile(const char* filePath) const = 0;
   virtual bool UnlockFile(const char* filePath) const = 0;
+  virtual bool ReadFile(const char* filePath, std::string& contents) const = 0;
+
+  // Flushes all completed output to storage, for Settings.SyncPolicy == UsdBridgeSyncPolicy::CHECKPOINT
+  virtual bool SyncOutput() const = 0;
 
+  // Opens an output stream that is independent of any other open stream, so multiple files can be written concurrently,
+  // each from its own thread. Blocks while Settings.MaxOpenStreams streams are open, until one of them is closed.
+  virtual UsdBridgeOutputStream* OpenStream(const char* filePath, bool binary = true) = 0;
+  // Writes out any remaining data and invalidates the stream. Returns false if any output to the stream failed.
+  virtual bool CloseStream(UsdBridgeOutputStream* stream) = 0;
+
+  // Single-stream convenience interface on top of OpenStream/CloseStream; the next GetStream() flushes the previous one.
   virtual std::ostream* GetStream(const char* filePath, bool binary = true) = 0;
   virtual void FlushStream() = 0;
 
@@ -52,7 +80,16 @@ public:
 
 protected:
 
+  void AcquireStreamSlot();
+  void ReleaseStreamSlot();
+
   mutable std::string TempUrl;
+
+  UsdBridgeOutputStream* CurrentStream = nullptr; // Stream of GetStream()
+
+  std::mutex StreamSlotMutex;
+  std::condition_variable StreamSlotReleased;
+  int NumOpenStreams = 0;
 };
 
 
@@ -74,18 +111,22 @@ public:
   bool CreateFolder(const char* dirName, bool mayExist) const override;
   bool RemoveFolder(const char* dirName) const override;
   bool WriteFile(const char* data, size_t dataSize, const char* filePath, bool binary = true) const override;
+  bool WriteFileGather(const UsdBridgeWriteRange* ranges, size_t numRanges, const char* filePath, bool binary = true) const override;
   bool RemoveFile(const char* filePath) const override;
+  bool RenameFile(const char* filePath, const char* newFilePath) const override;
   bool LockFile(const char* filePath) const override;
   bool UnlockFile(const char* filePath) const override;
+  bool ReadFile(const char* filePath, std::string& contents) const override;
+
+  bool SyncOutput() const override;
+
+  UsdBridgeOutputStream* OpenStream(const char* filePath, bool binary = true) override;
+  bool CloseStream(UsdBridgeOutputStream* stream) override;
 
   std::ostream* GetStream(const char* filePath, bool binary = true) override;
   void FlushStream() override;
 
   bool ProcessUpdates() override;
-
-protected:
-
-  std::fstream LocalStream;
 };
 
 class UsdBridgeRemoteConnection : public UsdBridgeConnection
@@ -106,9 +147,17 @@ public:
   bool CreateFolder(const char* dirName, bool mayExist) const override;
   bool RemoveFolder(const char* dirName) const override;
   bool WriteFile(const char* data, size_t dataSize, const char* filePath, bool binary = true) const override;
+  bool WriteFileGather(const UsdBridgeWriteRange* ranges, size_t numRanges, const char* filePath, bool binary = true) const override;
   bool RemoveFile(const char* filePath) const override;
+  bool RenameFile(const char* filePath, const char* newFilePath) const override;
   bool LockFile(const char* filePath) const override;
   bool UnlockFile(const char* filePath) const override;
+  bool ReadFile(const char* filePath, std::string& contents) const override;
+
+  bool SyncOutput() const override;
+
+  UsdBridgeOutputStream* OpenStream(const char* filePath, bool binary = true) override;
+  bool CloseStream(UsdBridgeOutputStream* stream) override;
 
   std::ostream* GetStream(const char* filePath, bool binary = true) override;
   void FlushStream() override;
@@ -149,18 +198,22 @@ public:
   bool CreateFolder(const char* dirName, bool mayExist) const override;
   bool RemoveFolder(const char* dirName) const override;
   bool WriteFile(const char* data, size_t dataSize, const char* filePath, bool binary = true) const override;
+  bool WriteFileGather(const UsdBridgeWriteRange* ranges, size_t numRanges, const char* filePath, bool binary = true) const override;
   bool RemoveFile(const char* filePath) const override;
+  bool RenameFile(const char* filePath, const char* newFilePath) const override;
   bool LockFile(const char* filePath) const override;
   bool UnlockFile(const char* filePath) const override;
+  bool ReadFile(const char* filePath, std::string& contents) const override;
+
+  bool SyncOutput() const override;
+
+  UsdBridgeOutputStream* OpenStream(const char* filePath, bool binary = true) override;
+  bool CloseStream(UsdBridgeOutputStream* stream) override;
 
   std::ostream* GetStream(const char* filePath, bool binary = true) override;
   void FlushStream() override;
 
   bool ProcessUpdates() override;
-
-protected:
-
-  std::stringstream DummyStream;
 };
 
 
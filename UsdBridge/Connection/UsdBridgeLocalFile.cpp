@@ -0,0 +1,429 @@
+// Copyright 2020 The Khronos Group
+// SPDX-License-Identifier: Apache-2.0
+
+#include "UsdBridgeLocalFile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+#endif
+
+namespace
+{
+  constexpr size_t minPreallocSize = 1 << 20; // Below this, preallocation costs more than it saves
+  constexpr size_t maxBufferSize = 1 << 30;   // Keeps pbump() arguments within int range
+  const char* const tempFileSuffix = ".partial";
+
+  void* AllocAligned(size_t size, size_t alignment)
+  {
+#ifdef WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    void* mem = nullptr;
+    return posix_memalign(&mem, alignment, size) == 0 ? mem : nullptr;
+#endif
+  }
+
+  void FreeAligned(void* mem)
+  {
+#ifdef WIN32
+    _aligned_free(mem);
+#else
+    free(mem);
+#endif
+  }
+
+  int OpenForWriting(const char* filePath, bool& directIO)
+  {
+#ifdef WIN32
+    directIO = false;
+    return _open(filePath, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+#ifdef O_DIRECT
+    if (directIO)
+    {
+      int fileDesc = open(filePath, flags | O_DIRECT, 0666);
+      if (fileDesc >= 0 || errno != EINVAL)
+        return fileDesc;
+      // Filesystem doesn't support O_DIRECT (tmpfs, some network filesystems)
+    }
+#endif
+    directIO = false;
+    return open(filePath, flags, 0666);
+#endif
+  }
+
+  void Preallocate(int fileDesc, size_t size)
+  {
+#ifdef __linux__
+    // Not posix_fallocate, which falls back to writing zeros on filesystems without support
+    if (size >= minPreallocSize)
+      fallocate(fileDesc, 0, 0, size);
+#endif
+  }
+
+  void DropCachedPages(int fileDesc)
+  {
+#if defined(__linux__) || defined(__FreeBSD__)
+    posix_fadvise(fileDesc, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+  }
+
+  bool CloseFile(int fileDesc)
+  {
+#ifdef WIN32
+    return _close(fileDesc) == 0;
+#else
+    return close(fileDesc) == 0;
+#endif
+  }
+
+  bool SyncFile(int fileDesc)
+  {
+#ifdef WIN32
+    return _commit(fileDesc) == 0;
+#elif defined(__APPLE__)
+    return fcntl(fileDesc, F_FULLFSYNC) != -1 || fsync(fileDesc) == 0;
+#else
+    return fsync(fileDesc) == 0;
+#endif
+  }
+
+  // Makes a preceding rename into the directory of filePath durable
+  bool SyncParentDirectory(const std::string& filePath)
+  {
+#ifdef WIN32
+    return true; // The rename itself is flushed with MOVEFILE_WRITE_THROUGH
+#else
+    size_t sepPos = filePath.find_last_of('/');
+    std::string dirPath = (sepPos == std::string::npos) ? std::string(".") : filePath.substr(0, sepPos + 1);
+    int dirDesc = open(dirPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (dirDesc < 0)
+      return false;
+    bool success = fsync(dirDesc) == 0;
+    return CloseFile(dirDesc) && success;
+#endif
+  }
+
+  // Atomically replaces filePath with tempFilePath, or removes tempFilePath if the write had already failed
+  bool CommitTempFile(const std::string& tempFilePath, const std::string& filePath, bool success, bool syncToStorage)
+  {
+#ifdef WIN32
+    DWORD moveFlags = MOVEFILE_REPLACE_EXISTING | (syncToStorage ? MOVEFILE_WRITE_THROUGH : 0);
+    success = success && MoveFileExA(tempFilePath.c_str(), filePath.c_str(), moveFlags);
+    if (!success)
+      _unlink(tempFilePath.c_str());
+#else
+    success = success && rename(tempFilePath.c_str(), filePath.c_str()) == 0;
+    if (!success)
+      unlink(tempFilePath.c_str());
+    else if (syncToStorage)
+      success = SyncParentDirectory(filePath);
+#endif
+    return success;
+  }
+
+  // Returns the number of bytes written, or -1 on error
+  long long WriteSome(int fileDesc, const char* data, size_t size)
+  {
+#ifdef WIN32
+    return _write(fileDesc, data, (unsigned int)std::min<size_t>(size, INT_MAX));
+#else
+    ssize_t numWritten;
+    do
+    {
+      numWritten = write(fileDesc, data, std::min<size_t>(size, SSIZE_MAX));
+    } while (numWritten < 0 && errno == EINTR);
+    return numWritten;
+#endif
+  }
+}
+
+constexpr size_t UsdBridgeLocalFileBuf::DefaultBufferSize;
+constexpr size_t UsdBridgeLocalFileBuf::BufferAlignment;
+
+UsdBridgeLocalFileBuf::UsdBridgeLocalFileBuf(size_t bufferSize)
+  : BufferSize(std::min(std::max(bufferSize, BufferAlignment), maxBufferSize) & ~(BufferAlignment - 1))
+{
+}
+
+UsdBridgeLocalFileBuf::~UsdBridgeLocalFileBuf()
+{
+  Close();
+  FreeAligned(Buffer);
+}
+
+bool UsdBridgeLocalFileBuf::Open(const char* filePath, bool directIO, size_t sizeHint)
+{
+  Close();
+
+  if (!Buffer)
+  {
+    Buffer = static_cast<char*>(AllocAligned(BufferSize, BufferAlignment));
+    if (!Buffer)
+      return false;
+  }
+
+  FilePath = filePath;
+  TempFilePath = FilePath + tempFileSuffix;
+
+  DirectIO = directIO;
+  FileDesc = OpenForWriting(TempFilePath.c_str(), DirectIO);
+  if (FileDesc < 0)
+    return false;
+
+  DropPageCache = directIO && !DirectIO;
+  WriteFailed = false;
+  BytesWritten = 0;
+  PreallocatedSize = 0;
+
+  if (sizeHint)
+  {
+    Preallocate(FileDesc, sizeHint);
+    PreallocatedSize = sizeHint;
+  }
+
+  setp(Buffer, Buffer + BufferSize);
+
+  return true;
+}
+
+bool UsdBridgeLocalFileBuf::Close(bool syncToStorage)
+{
+  if (FileDesc < 0)
+    return true;
+
+  FlushBuffer(true);
+
+#ifndef WIN32
+  // Trim any preallocated storage that wasn't written to
+  if (PreallocatedSize > BytesWritten && ftruncate(FileDesc, BytesWritten) != 0)
+    WriteFailed = true;
+#endif
+
+  if (syncToStorage && !WriteFailed && !SyncFile(FileDesc))
+    WriteFailed = true;
+
+  if (DropPageCache)
+    DropCachedPages(FileDesc);
+
+  if (!CloseFile(FileDesc))
+    WriteFailed = true;
+  FileDesc = -1;
+
+  setp(nullptr, nullptr);
+
+  WriteFailed = !CommitTempFile(TempFilePath, FilePath, !WriteFailed, syncToStorage);
+
+  return !WriteFailed;
+}
+
+UsdBridgeLocalFileBuf::int_type UsdBridgeLocalFileBuf::overflow(int_type ch)
+{
+  if (FileDesc < 0 || !FlushBuffer(false))
+    return traits_type::eof();
+
+  if (!traits_type::eq_int_type(ch, traits_type::eof()))
+  {
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+  }
+  return traits_type::not_eof(ch);
+}
+
+std::streamsize UsdBridgeLocalFileBuf::xsputn(const char* s, std::streamsize n)
+{
+  if (FileDesc < 0)
+    return 0;
+
+  std::streamsize numPut = 0;
+  while (numPut < n)
+  {
+    size_t numRemaining = n - numPut;
+
+    // Large writes skip the staging buffer, unless O_DIRECT requires aligned memory
+    if (!DirectIO && pptr() == pbase() && numRemaining >= BufferSize)
+    {
+      if (!WriteOut(s + numPut, numRemaining))
+      {
+        WriteFailed = true;
+        break;
+      }
+      numPut = n;
+      break;
+    }
+
+    size_t numFree = epptr() - pptr();
+    if (numFree == 0)
+    {
+      if (!FlushBuffer(false))
+        break;
+      continue;
+    }
+
+    size_t numCopied = std::min(numFree, numRemaining);
+    std::memcpy(pptr(), s + numPut, numCopied);
+    pbump((int)numCopied);
+    numPut += numCopied;
+  }
+
+  return numPut;
+}
+
+int UsdBridgeLocalFileBuf::sync()
+{
+  return (FileDesc < 0 || FlushBuffer(false)) ? 0 : -1;
+}
+
+bool UsdBridgeLocalFileBuf::FlushBuffer(bool finalFlush)
+{
+  size_t numPending = pptr() - pbase();
+  size_t numOut = DirectIO ? (numPending & ~(BufferAlignment - 1)) : numPending;
+
+  bool success = WriteOut(pbase(), numOut);
+
+#if !defined(WIN32) && defined(O_DIRECT)
+  if (success && finalFlush && numOut < numPending)
+  {
+    // The unaligned tail can only be written with O_DIRECT switched off
+    int flags = fcntl(FileDesc, F_GETFL);
+    success = flags != -1 && fcntl(FileDesc, F_SETFL, flags & ~O_DIRECT) != -1;
+    DirectIO = false;
+    success = success && WriteOut(pbase() + numOut, numPending - numOut);
+    numOut = numPending;
+  }
+#endif
+
+  if (!success)
+  {
+    WriteFailed = true;
+    numOut = numPending; // Discard, the file is invalid anyway
+  }
+
+  size_t numKept = numPending - numOut;
+  if (numKept)
+    std::memmove(Buffer, pbase() + numOut, numKept);
+  setp(Buffer, Buffer + BufferSize);
+  pbump((int)numKept);
+
+  return success;
+}
+
+bool UsdBridgeLocalFileBuf::WriteOut(const char* data, size_t size)
+{
+  while (size > 0)
+  {
+    long long numWritten = WriteSome(FileDesc, data, size);
+    if (numWritten <= 0)
+      return false;
+    data += numWritten;
+    size -= numWritten;
+    BytesWritten += numWritten;
+  }
+  return true;
+}
+
+bool UsdBridgeWriteLocalFile(const char* filePath, const UsdBridgeWriteRange* ranges, size_t numRanges, bool directIO,
+  bool syncToStorage)
+{
+  size_t totalSize = 0;
+  for (size_t i = 0; i < numRanges; ++i)
+    totalSize += ranges[i].Size;
+
+#ifndef WIN32
+  if (!directIO)
+  {
+    std::string tempFilePath = std::string(filePath) + tempFileSuffix;
+    int fileDesc = open(tempFilePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (fileDesc < 0)
+      return false;
+
+    Preallocate(fileDesc, totalSize);
+
+    std::vector<struct iovec> ioVecs;
+    ioVecs.reserve(numRanges);
+    for (size_t i = 0; i < numRanges; ++i)
+    {
+      if (ranges[i].Size)
+        ioVecs.push_back({ const_cast<char*>(ranges[i].Data), ranges[i].Size });
+    }
+
+    bool success = true;
+    struct iovec* nextVec = ioVecs.data();
+    struct iovec* endVec = nextVec + ioVecs.size();
+    while (success && nextVec != endVec)
+    {
+      int numVecs = (int)std::min<ptrdiff_t>(endVec - nextVec, IOV_MAX);
+      ssize_t numWritten = writev(fileDesc, nextVec, numVecs);
+      if (numWritten < 0 && errno == EINTR)
+        continue;
+      success = numWritten > 0;
+
+      // Advance past fully written ranges, and into a partially written one
+      size_t numLeft = success ? (size_t)numWritten : 0;
+      while (nextVec != endVec && numLeft >= nextVec->iov_len)
+        numLeft -= (nextVec++)->iov_len;
+      if (numLeft)
+      {
+        nextVec->iov_base = static_cast<char*>(nextVec->iov_base) + numLeft;
+        nextVec->iov_len -= numLeft;
+      }
+    }
+
+    if (success && syncToStorage)
+      success = SyncFile(fileDesc);
+    success = CloseFile(fileDesc) && success;
+
+    return CommitTempFile(tempFilePath, filePath, success, syncToStorage);
+  }
+#endif
+
+  UsdBridgeLocalFileBuf fileBuf(std::min(totalSize, UsdBridgeLocalFileBuf::DefaultBufferSize));
+  if (!fileBuf.Open(filePath, directIO, totalSize))
+    return false;
+
+  for (size_t i = 0; i < numRanges; ++i)
+  {
+    if (fileBuf.sputn(ranges[i].Data, ranges[i].Size) != (std::streamsize)ranges[i].Size)
+      break;
+  }
+
+  return fileBuf.Close(syncToStorage);
+}
+
+bool UsdBridgeSyncLocalFileSystem(const char* dirPath)
+{
+#if defined(__linux__)
+  int dirDesc = open(dirPath, O_RDONLY | O_CLOEXEC);
+  if (dirDesc < 0)
+    return false;
+  bool success = syncfs(dirDesc) == 0;
+  return CloseFile(dirDesc) && success;
+#elif defined(WIN32)
+  (void)dirPath;
+  return true; // No per-filesystem flush without elevated rights, use the ALWAYS policy instead
+#else
+  (void)dirPath;
+  sync();
+  return true;
+#endif
+}
@@ -0,0 +1,68 @@
+// Copyright 2020 The Khronos Group
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UsdBridgeLocalFile_h
+#define UsdBridgeLocalFile_h
+
+#include <cstddef>
+#include <streambuf>
+#include <string>
+
+struct UsdBridgeWriteRange
+{
+  const char* Data;
+  size_t Size;
+};
+
+// Output stream buffer writing to a local file descriptor through a large aligned staging buffer,
+// avoiding the small default buffers and extra copies of std::fstream. With direct I/O, writes bypass the page cache
+// (O_DIRECT where the filesystem supports it, otherwise the written pages are dropped from the cache on close).
+// Output goes to a temporary file next to the target, which atomically replaces the target on a successful Close(),
+// so readers and restarted sessions never observe a partially written file.
+class UsdBridgeLocalFileBuf : public std::streambuf
+{
+  public:
+    static constexpr size_t DefaultBufferSize = 4 << 20;
+    static constexpr size_t BufferAlignment = 4096; // Satisfies O_DIRECT alignment of buffer, offsets and sizes
+
+    UsdBridgeLocalFileBuf(size_t bufferSize = DefaultBufferSize);
+    ~UsdBridgeLocalFileBuf() override;
+
+    // A nonzero sizeHint preallocates the file's storage up front
+    bool Open(const char* filePath, bool directIO, size_t sizeHint = 0);
+    // Returns false if any write since Open() failed, in which case the target file is left untouched.
+    // With syncToStorage, the file's data and its directory entry are flushed to storage before returning.
+    bool Close(bool syncToStorage = false);
+    bool IsOpen() const { return FileDesc >= 0; }
+
+  protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char* s, std::streamsize n) override;
+    int sync() override;
+
+    bool FlushBuffer(bool finalFlush);
+    bool WriteOut(const char* data, size_t size);
+
+    std::string FilePath;
+    std::string TempFilePath;
+
+    char* Buffer = nullptr;
+    size_t BufferSize;
+
+    int FileDesc = -1;
+    bool DirectIO = false;      // O_DIRECT currently active on FileDesc
+    bool DropPageCache = false; // Direct I/O requested, but not supported by the filesystem
+    bool WriteFailed = false;
+    size_t BytesWritten = 0;
+    size_t PreallocatedSize = 0;
+};
+
+// Writes the concatenation of ranges to a file in a single gathering pass (writev), preallocating its storage.
+// Like UsdBridgeLocalFileBuf, the file is written to a temporary and then atomically replaces filePath.
+bool UsdBridgeWriteLocalFile(const char* filePath, const UsdBridgeWriteRange* ranges, size_t numRanges, bool directIO,
+  bool syncToStorage = false);
+
+// Flushes all output to the filesystem containing dirPath to storage
+bool UsdBridgeSyncLocalFileSystem(const char* dirPath);
+
+#endif
@@ -5,6 +5,8 @@
 
 #include "UsdBridgeUsdWriter.h"
 #include "UsdBridgeCaches.h"
+#include "UsdBridgeTrace.h"
+#include "UsdBridgeGeometryRegistry.h"
 
 #include <string>
 
@@ -23,6 +25,8 @@ namespace
   const char* const fieldPathCp = "spatialfields";
   const char* const materialPathCp = "materials";
   const char* const samplerPathCp = "samplers";
+  const char* const prototypePathCp = "prototypes";
+  const char* const groupInstancerPathCp = "pointinstancers";
 
   // Parent path extensions for references in parent classes (Reference path)
   const char* const surfacePathRp = "surfaces";
@@ -31,14 +35,21 @@ namespace
   const char* const fieldPathRp = "spatialfield"; // created in volumes parent class
   const char* const materialPathRp = "material"; // created in surfaces parent class
   const char* const samplerPathRp = "samplers"; // created in material parent class (separation from other UsdShader prims in material)
+  const char* const groupInstancerProtoPathRp = "prototypes"; // created in point instancer parent class
 
   // Postfixes for prim stage names
   const char* const geomPrimStagePf = "_Geom";
   const char* const fieldPrimStagePf = "_Field";
   const char* const materialPrimStagePf = "_Material";
 
+  // Postfixes for names of world point instancers
+  const char* const groupInstancerPf = "_PointInstancer";
+
   // Postfixes for clip stage names
   const char* const geomClipPf = "_Geom_";
+
+  // Prefix for names of geometry prototypes
+  const char* const geomPrototypePrefix = "geomproto_";
 }
 
 typedef UsdBridgeTemporalCache::PrimCacheIterator PrimCacheIterator;
@@ -48,6 +59,7 @@ struct UsdBridgeInternals
 {
   UsdBridgeInternals(const UsdBridgeSettings& settings)
     : UsdWriter(settings)
+    , DedupGeometry(settings.DedupGeometry)
   {
     RefModCallbacks.AtNewRef = [this](UsdBridgePrimCache* parentCache, UsdBridgePrimCache* childCache){
 #ifdef TIME_BASED_CACHING
@@ -68,6 +80,23 @@ struct UsdBridgeInternals
   BoolEntryPair FindOrCreatePrim(const char* category, const char* name, ResourceCollectFunc collectFunc = nullptr);
   void FindAndDeletePrim(const UsdBridgeHandle& handle);
 
+  // Aliases the geometry data to its prototype, which is authored instead of the geometry's own prim
+  template<typename GeomDataType>
+  void DedupGeometryData(UsdBridgePrimCache* geomCache, const GeomDataType& geomData, double timeStep);
+  // Returns whether the geometry was aliased to any prototype
+  bool ReleaseGeometryPrototypes(UsdBridgePrimCache* geomCache);
+  template<typename GeomDataType>
+  UsdBridgePrimCache* CreateGeometryPrototype(const UsdBridgeGeometryKey& key, const GeomDataType& geomData);
+
+  // References the geometry (or its prototype) and material from the surface
+  void SetGeometryMaterialRef(UsdBridgePrimCache* surfaceCache, UsdBridgePrimCache* geometryCache, UsdBridgePrimCache* materialCache,
+    double timeStep, double geomTimeStep, double matTimeStep);
+  // Re-references the surfaces of a geometry timestep after its prototype has changed
+  void UpdateGeometrySurfaceRefs(UsdBridgePrimCache* geomCache, double geomTimeStep);
+
+  // Returns the point instancer of the world, with its prototypes and instances updated to groupInstances
+  UsdBridgePrimCache* UpdateGroupInstancer(UsdBridgePrimCache* worldCache, const UsdBridgeGroupInstancesData& groupInstances, bool timeVarying, double timeStep);
+
   template<class T>
   const UsdBridgePrimCacheList& ExtractPrimCaches(const UsdBridgeTemporalCache& Cache, const T* handles, uint64_t numHandles);
 
@@ -80,6 +109,10 @@ struct UsdBridgeInternals
   // Callbacks
   UsdBridgeUsdWriter::RefModFuncs RefModCallbacks;
 
+  // Geometry deduplication
+  bool DedupGeometry;
+  UsdBridgeGeometryRegistry GeometryRegistry;
+
   // Temp arrays
   UsdBridgePrimCacheList TempPrimCaches;
 };
@@ -117,10 +150,132 @@ void UsdBridgeInternals::FindAndDeletePrim(const UsdBridgeHandle& handle)
   UsdBridgePrimCache* cacheEntry = (*it).second.get();
 
   UsdWriter.DeletePrim(cacheEntry);
+  GeometryRegistry.RemovePrimCache(cacheEntry);
 
   Cache.RemovePrimCache(it);
 }
 
+template<typename GeomDataType>
+void UsdBridgeInternals::DedupGeometryData(UsdBridgePrimCache* geomCache, const GeomDataType& geomData, double timeStep)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::DedupGeometryData");
+
+  UsdBridgeGeometryKey key = UsdBridgeHashGeometry(geomData);
+
+  UsdBridgePrimCache* protoCache = nullptr;
+  UsdBridgePrimCache* releasedProtoCache = nullptr;
+  UsdBridgeGeometryRegistry::Action action = GeometryRegistry.Update(geomCache, timeStep, key, protoCache, releasedProtoCache);
+
+  // The geometry holds a reference to each prototype it is aliased to, keeping the prototype alive
+#ifdef TIME_BASED_CACHING
+  if (releasedProtoCache)
+    Cache.RemoveChild(geomCache, releasedProtoCache);
+#endif
+
+  switch (action)
+  {
+  case UsdBridgeGeometryRegistry::Action::SKIP:
+    return;
+  case UsdBridgeGeometryRegistry::Action::CREATE_PROTOTYPE:
+    protoCache = CreateGeometryPrototype(key, geomData);
+    GeometryRegistry.SetPrototype(geomCache, timeStep, key, protoCache);
+    break;
+  default:
+    break;
+  }
+
+#ifdef TIME_BASED_CACHING
+  Cache.AddChild(geomCache, protoCache);
+#endif
+
+  UpdateGeometrySurfaceRefs(geomCache, timeStep);
+}
+
+bool UsdBridgeInternals::ReleaseGeometryPrototypes(UsdBridgePrimCache* geomCache)
+{
+  std::vector<UsdBridgePrimCache*> releasedProtoCaches;
+  GeometryRegistry.RemoveGeometry(geomCache, releasedProtoCaches);
+
+#ifdef TIME_BASED_CACHING
+  for (UsdBridgePrimCache* releasedProtoCache : releasedProtoCaches)
+    Cache.RemoveChild(geomCache, releasedProtoCache);
+#endif
+
+  return !releasedProtoCaches.empty();
+}
+
+template<typename GeomDataType>
+UsdBridgePrimCache* UsdBridgeInternals::CreateGeometryPrototype(const UsdBridgeGeometryKey& key, const GeomDataType& geomData)
+{
+  std::string protoName = geomPrototypePrefix + key.ToString();
+  UsdBridgePrimCache* protoCache = FindOrCreatePrim(prototypePathCp, protoName.c_str()).second;
+
+  // Prototypes are immutable, so all their data is authored as time-uniform
+  GeomDataType protoData = geomData;
+  protoData.UpdatesToPerform = GeomDataType::DataMemberId::ALL;
+  protoData.TimeVarying = GeomDataType::DataMemberId::NONE;
+
+  UsdStageRefPtr sceneStage = UsdWriter.GetSceneStage();
+  UsdWriter.InitializeUsdGeometry(sceneStage, protoCache->PrimPath, protoData, true);
+  UsdWriter.UpdateUsdGeometry(sceneStage, protoCache->PrimPath, protoData, 0.0);
+
+  return protoCache;
+}
+
+void UsdBridgeInternals::SetGeometryMaterialRef(UsdBridgePrimCache* surfaceCache, UsdBridgePrimCache* geometryCache, UsdBridgePrimCache* materialCache,
+  double timeStep, double geomTimeStep, double matTimeStep)
+{
+  // Update the references. Geometry with deduplicated data references its prototype through an instanceable prim instead.
+  UsdBridgePrimCache* protoCache = DedupGeometry ? GeometryRegistry.FindPrototype(geometryCache, geomTimeStep) : nullptr;
+  SdfPath refGeomPath = protoCache ?
+    UsdWriter.AddInstanceableRef(surfaceCache, geometryCache, protoCache, geometryPathRp, timeStep, RefModCallbacks) :
+    UsdWriter.AddRef(surfaceCache, geometryCache, geometryPathRp, false, true, true, geomClipPf, timeStep, geomTimeStep, true, RefModCallbacks); // Can technically be timeVarying, but would be a bit confusing. Instead, timevary the surface.
+  SdfPath refMatPath = UsdWriter.AddRef(surfaceCache, materialCache, materialPathRp, false, true, false, nullptr, timeStep, matTimeStep, true, RefModCallbacks);
+
+  // Bind the referencing material to the referencing geom prim (as they are within same scope in this usd prim)
+  UsdWriter.BindMaterialToGeom(refGeomPath, refMatPath);
+}
+
+void UsdBridgeInternals::UpdateGeometrySurfaceRefs(UsdBridgePrimCache* geomCache, double geomTimeStep)
+{
+  std::vector<UsdBridgeGeometryRegistry::SurfaceRef> surfaceRefs;
+  GeometryRegistry.GetSurfaceRefs(geomCache, geomTimeStep, surfaceRefs);
+
+  for (const UsdBridgeGeometryRegistry::SurfaceRef& surfaceRef : surfaceRefs)
+  {
+    SetGeometryMaterialRef(surfaceRef.Surface, geomCache, surfaceRef.Material,
+      surfaceRef.TimeStep, surfaceRef.GeomTimeStep, surfaceRef.MatTimeStep);
+  }
+}
+
+UsdBridgePrimCache* UsdBridgeInternals::UpdateGroupInstancer(UsdBridgePrimCache* worldCache, const UsdBridgeGroupInstancesData& groupInstances, bool timeVarying, double timeStep)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::UpdateGroupInstancer");
+
+  std::string instancerName = worldCache->Name.GetString() + groupInstancerPf;
+  BoolEntryPair createResult = FindOrCreatePrim(groupInstancerPathCp, instancerName.c_str());
+  UsdBridgePrimCache* instancerCache = createResult.second;
+
+  if (createResult.first)
+  {
+    UsdWriter.InitializeUsdGroupInstancer(instancerCache);
+  }
+
+  const UsdBridgePrimCacheList& protoCaches = ExtractPrimCaches<UsdGroupHandle>(Cache, groupInstances.Groups, groupInstances.NumGroups);
+
+  // The prototype indices of other timesteps refer to the existing prototypes, so those are only removed from uniform instancers
+  if (!timeVarying)
+    UsdWriter.ManageUnusedRefs(instancerCache, protoCaches, groupInstancerProtoPathRp, false, timeStep, RefModCallbacks.AtRemoveRef);
+  for (UsdBridgePrimCache* protoCache : protoCaches)
+  {
+    UsdWriter.AddRef_NoClip(instancerCache, protoCache, groupInstancerProtoPathRp, false, timeStep, timeStep, false, RefModCallbacks);
+  }
+
+  UsdWriter.UpdateUsdGroupInstancer(instancerCache, groupInstancerProtoPathRp, protoCaches, groupInstances, timeVarying, timeStep);
+
+  return instancerCache;
+}
+
 template<class T>
 const UsdBridgePrimCacheList& UsdBridgeInternals::ExtractPrimCaches(const UsdBridgeTemporalCache& Cache, const T* handles, uint64_t numHandles)
 {
@@ -151,6 +306,31 @@ void UsdBridge::SetEnableSaving(bool enableSaving)
   BRIDGE_USDWRITER.SetEnableSaving(enableSaving);
 }
 
+void UsdBridge::SetBatchChanges(bool batchChanges)
+{
+  BRIDGE_USDWRITER.SetBatchChanges(batchChanges);
+}
+
+void UsdBridge::SetParallelWrites(bool parallelWrites)
+{
+  BRIDGE_USDWRITER.SetParallelWrites(parallelWrites);
+}
+
+void UsdBridge::SetMemoryBudget(uint64_t budgetMB)
+{
+  BRIDGE_USDWRITER.SetMemoryBudget(budgetMB);
+}
+
+uint64_t UsdBridge::GetMemoryFootprint() const
+{
+  return BRIDGE_USDWRITER.GetTimeVarBytes();
+}
+
+void UsdBridge::SetTimeSampleTolerance(double tolerance)
+{
+  BRIDGE_USDWRITER.SetTimeSampleTolerance(tolerance);
+}
+
 bool UsdBridge::OpenSession(UsdBridgeLogCallback logCallback, void* logUserData)
 {
   BRIDGE_USDWRITER.LogUserData = logUserData;
@@ -174,6 +354,8 @@ UsdBridge::~UsdBridge()
 
 bool UsdBridge::CreateWorld(const char* name, UsdWorldHandle& handle)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::CreateWorld");
+
   if (!SessionValid) return false;
 
   // Find or create a cache entry belonging to a prim located under worldPathCp in the usd.
@@ -194,6 +376,8 @@ bool UsdBridge::CreateWorld(const char* name, UsdWorldHandle& handle)
 
 bool UsdBridge::CreateInstance(const char* name, UsdInstanceHandle& handle)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::CreateInstance");
+
   if (!SessionValid) return false;
 
   BoolEntryPair createResult = Internals->FindOrCreatePrim(instancePathCp, name);
@@ -211,6 +395,8 @@ bool UsdBridge::CreateInstance(const char* name, UsdInstanceHandle& handle)
 
 bool UsdBridge::CreateGroup(const char* name, UsdGroupHandle& handle)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::CreateGroup");
+
   if (!SessionValid) return false;
 
   BoolEntryPair createResult = Internals->FindOrCreatePrim(groupPathCp, name);
@@ -228,6 +414,8 @@ bool UsdBridge::CreateGroup(const char* name, UsdGroupHandle& handle)
 
 bool UsdBridge::CreateSurface(const char* name, UsdSurfaceHandle& handle)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::CreateSurface");
+
   if (!SessionValid) return false;
 
   // Although surface doesn't support transform operations, a transform prim supports timevarying visibility.
@@ -246,6 +434,8 @@ bool UsdBridge::CreateSurface(const char* name, UsdSurfaceHandle& handle)
 
 bool UsdBridge::CreateVolume(const char * name, UsdVolumeHandle& handle)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::CreateVolume");
+
   if (!SessionValid) return false;
 
   BoolEntryPair createResult = Internals->FindOrCreatePrim(volumePathCp, name);
@@ -264,6 +454,8 @@ bool UsdBridge::CreateVolume(const char * name, UsdVolumeHandle& handle)
 template<typename GeomDataType>
 bool UsdBridge::CreateGeometryTemplate(const char* name, const GeomDataType& geomData, UsdGeometryHandle& handle)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::CreateGeometry");
+
   if (!SessionValid) return false;
 
   BoolEntryPair createResult = Internals->FindOrCreatePrim(geometryPathCp, name);
@@ -273,18 +465,20 @@ bool UsdBridge::CreateGeometryTemplate(const char* name, const GeomDataType& geo
   if (newPrim)
   {
 #ifdef VALUE_CLIP_RETIMING
-    BRIDGE_USDWRITER.OpenPrimStage(name, geomPrimStagePf, cacheEntry
-
+    if (BRIDGE_USDWRITER.UsesClipStages())
+    {
+      BRIDGE_USDWRITER.OpenPrimStage(name, geomPrimStagePf, cacheEntry, true);
 #ifdef TIME_CLIP_STAGES
-      , true);
-
-    BRIDGE_USDWRITER.CreateUsdGeometryManifest(name, cacheEntry, geomData);
-#else
-      , false);
-
-    UsdStageRefPtr geomStage = cacheEntry->PrimStage.second;
-    BRIDGE_USDWRITER.InitializeUsdGeometry(geomStage, cacheEntry->PrimPath, geomData, false);
+      BRIDGE_USDWRITER.CreateUsdGeometryManifest(name, cacheEntry, geomData);
+      cacheEntry->ManifestTimeVarying = static_cast<uint32_t>(geomData.TimeVarying);
 #endif
+    }
+    else if (BRIDGE_USDWRITER.UsesPrimStages())
+    {
+      BRIDGE_USDWRITER.OpenPrimStage(name, geomPrimStagePf, cacheEntry, false);
+      UsdStageRefPtr geomStage = cacheEntry->PrimStage.second;
+      BRIDGE_USDWRITER.InitializeUsdGeometry(geomStage, cacheEntry->PrimPath, geomData, false);
+    }
 #endif
 
     BRIDGE_USDWRITER.InitializeUsdGeometry(BRIDGE_USDWRITER.GetSceneStage(), cacheEntry->PrimPath, geomData, true);
@@ -311,6 +505,8 @@ bool UsdBridge::CreateGeometry(const char* name, const UsdBridgeCurveData& curve
 
 bool UsdBridge::CreateSpatialField(const char * name, UsdSpatialFieldHandle& handle)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::CreateSpatialField");
+
   if (!SessionValid) return false;
 
   BoolEntryPair createResult = Internals->FindOrCreatePrim(fieldPathCp, name, &ResourceCollectVolume);
@@ -321,9 +517,12 @@ bool UsdBridge::CreateSpatialField(const char * name, UsdSpatialFieldHandle& han
   {
 #ifdef VALUE_CLIP_RETIMING
     // Create a separate stage to be referenced by the value clips
-    BRIDGE_USDWRITER.OpenPrimStage(name, fieldPrimStagePf, cacheEntry, false);
-    UsdStageRefPtr volumeStage = cacheEntry->PrimStage.second;
-    BRIDGE_USDWRITER.InitializeUsdVolume(volumeStage, cacheEntry->PrimPath, false);
+    if (BRIDGE_USDWRITER.UsesPrimStages())
+    {
+      BRIDGE_USDWRITER.OpenPrimStage(name, fieldPrimStagePf, cacheEntry, false);
+      UsdStageRefPtr volumeStage = cacheEntry->PrimStage.second;
+      BRIDGE_USDWRITER.InitializeUsdVolume(volumeStage, cacheEntry->PrimPath, false);
+    }
 #endif   
 
     BRIDGE_USDWRITER.InitializeUsdVolume(BRIDGE_USDWRITER.GetSceneStage(), cacheEntry->PrimPath, true);
@@ -335,6 +534,8 @@ bool UsdBridge::CreateSpatialField(const char * name, UsdSpatialFieldHandle& han
 
 bool UsdBridge::CreateMaterial(const char* name, UsdMaterialHandle& handle)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::CreateMaterial");
+
   if (!SessionValid) return false;
 
   // Create the material
@@ -348,9 +549,12 @@ bool UsdBridge::CreateMaterial(const char* name, UsdMaterialHandle& handle)
   {
 #ifdef VALUE_CLIP_RETIMING
     // Create a separate stage to be referenced by the value clips
-    BRIDGE_USDWRITER.OpenPrimStage(name, materialPrimStagePf, matCacheEntry, false);
-    UsdStageRefPtr materialStage = matCacheEntry->PrimStage.second;
-    BRIDGE_USDWRITER.InitializeUsdMaterial(materialStage, matCacheEntry->PrimPath, false);
+    if (BRIDGE_USDWRITER.UsesPrimStages())
+    {
+      BRIDGE_USDWRITER.OpenPrimStage(name, materialPrimStagePf, matCacheEntry, false);
+      UsdStageRefPtr materialStage = matCacheEntry->PrimStage.second;
+      BRIDGE_USDWRITER.InitializeUsdMaterial(materialStage, matCacheEntry->PrimPath, false);
+    }
 #endif
 
     UsdShadeMaterial matPrim = BRIDGE_USDWRITER.InitializeUsdMaterial(BRIDGE_USDWRITER.GetSceneStage(), matCacheEntry->PrimPath, true);
@@ -362,6 +566,8 @@ bool UsdBridge::CreateMaterial(const char* name, UsdMaterialHandle& handle)
 
 bool UsdBridge::CreateSampler(const char* name, UsdSamplerHandle& handle)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::CreateSampler");
+
   if (!SessionValid) return false;
 
   BoolEntryPair createResult = Internals->FindOrCreatePrim(samplerPathCp, name, &ResourceCollectSampler);
@@ -447,20 +653,37 @@ void UsdBridge::DeleteSampler(UsdSamplerHandle handle)
 
 void UsdBridge::SetInstanceRefs(UsdWorldHandle world, const UsdInstanceHandle* instances, uint64_t numInstances, bool timeVarying, double timeStep)
 {
+  SetInstanceRefs(world, instances, numInstances, UsdBridgeGroupInstancesData(), timeVarying, timeStep);
+}
+
+void UsdBridge::SetInstanceRefs(UsdWorldHandle world, const UsdInstanceHandle* instances, uint64_t numInstances, const UsdBridgeGroupInstancesData& groupInstances, bool timeVarying, double timeStep)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::SetInstanceRefs");
+
   if (world.value == nullptr) return;
 
   UsdBridgePrimCache* worldCache = BRIDGE_CACHE.ConvertToPrimCache(world);
+
+  UsdBridgePrimCache* instancerCache = nullptr;
+  if (groupInstances.NumInstances)
+    instancerCache = Internals->UpdateGroupInstancer(worldCache, groupInstances, timeVarying, timeStep);
+
+  // The point instancer is referenced from the world like any of its instances
   const UsdBridgePrimCacheList& instanceCaches = Internals->ExtractPrimCaches<UsdInstanceHandle>(BRIDGE_CACHE, instances, numInstances);
+  if (instancerCache)
+    Internals->TempPrimCaches.push_back(instancerCache);
 
   BRIDGE_USDWRITER.ManageUnusedRefs(worldCache, instanceCaches, nullptr, timeVarying, timeStep, Internals->RefModCallbacks.AtRemoveRef);
-  for (uint64_t i = 0; i < numInstances; ++i)
+  for (UsdBridgePrimCache* instanceCache : instanceCaches)
   {
-    BRIDGE_USDWRITER.AddRef_NoClip(worldCache, instanceCaches[i], nullptr, timeVarying, timeStep, timeStep, false, Internals->RefModCallbacks);
+    BRIDGE_USDWRITER.AddRef_NoClip(worldCache, instanceCache, nullptr, timeVarying, timeStep, timeStep, false, Internals->RefModCallbacks);
   }
 }
 
 void UsdBridge::SetGroupRef(UsdInstanceHandle instance, UsdGroupHandle group, bool timeVarying, double timeStep)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::SetGroupRef");
+
   if (instance.value == nullptr) return;
 
   UsdBridgePrimCache* instanceCache = BRIDGE_CACHE.ConvertToPrimCache(instance);
@@ -471,6 +694,8 @@ void UsdBridge::SetGroupRef(UsdInstanceHandle instance, UsdGroupHandle group, bo
 
 void UsdBridge::SetSurfaceRefs(UsdGroupHandle group, const UsdSurfaceHandle* surfaces, uint64_t numSurfaces, bool timeVarying, double timeStep)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::SetSurfaceRefs");
+
   if (group.value == nullptr) return;
 
   UsdBridgePrimCache* groupCache = BRIDGE_CACHE.ConvertToPrimCache(group);
@@ -485,6 +710,8 @@ void UsdBridge::SetSurfaceRefs(UsdGroupHandle group, const UsdSurfaceHandle* sur
 
 void UsdBridge::SetVolumeRefs(UsdGroupHandle group, const UsdVolumeHandle* volumes, uint64_t numVolumes, bool timeVarying, double timeStep)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::SetVolumeRefs");
+
   if (group.value == nullptr) return;
 
   UsdBridgePrimCache* groupCache = BRIDGE_CACHE.ConvertToPrimCache(group);
@@ -497,24 +724,108 @@ void UsdBridge::SetVolumeRefs(UsdGroupHandle group, const UsdVolumeHandle* volum
   }
 }
 
+void UsdBridge::AddInstanceRefs(UsdWorldHandle world, const UsdInstanceHandle* instances, uint64_t numInstances, bool timeVarying, double timeStep)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::AddInstanceRefs");
+
+  if (world.value == nullptr) return;
+
+  UsdBridgePrimCache* worldCache = BRIDGE_CACHE.ConvertToPrimCache(world);
+  const UsdBridgePrimCacheList& instanceCaches = Internals->ExtractPrimCaches<UsdInstanceHandle>(BRIDGE_CACHE, instances, numInstances);
+
+  for (UsdBridgePrimCache* instanceCache : instanceCaches)
+  {
+    BRIDGE_USDWRITER.AddRef_NoClip(worldCache, instanceCache, nullptr, timeVarying, timeStep, timeStep, false, Internals->RefModCallbacks);
+  }
+}
+
+void UsdBridge::RemoveInstanceRefs(UsdWorldHandle world, const UsdInstanceHandle* instances, uint64_t numInstances, bool timeVarying, double timeStep)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::RemoveInstanceRefs");
+
+  if (world.value == nullptr) return;
+
+  UsdBridgePrimCache* worldCache = BRIDGE_CACHE.ConvertToPrimCache(world);
+  const UsdBridgePrimCacheList& instanceCaches = Internals->ExtractPrimCaches<UsdInstanceHandle>(BRIDGE_CACHE, instances, numInstances);
+
+  BRIDGE_USDWRITER.RemoveRefs(worldCache, instanceCaches, nullptr, timeVarying, timeStep, Internals->RefModCallbacks.AtRemoveRef);
+}
+
+void UsdBridge::AddSurfaceRefs(UsdGroupHandle group, const UsdSurfaceHandle* surfaces, uint64_t numSurfaces, bool timeVarying, double timeStep)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::AddSurfaceRefs");
+
+  if (group.value == nullptr) return;
+
+  UsdBridgePrimCache* groupCache = BRIDGE_CACHE.ConvertToPrimCache(group);
+  const UsdBridgePrimCacheList& surfaceCaches = Internals->ExtractPrimCaches<UsdSurfaceHandle>(BRIDGE_CACHE, surfaces, numSurfaces);
+
+  for (uint64_t i = 0; i < numSurfaces; ++i)
+  {
+    BRIDGE_USDWRITER.AddRef_NoClip(groupCache, surfaceCaches[i], surfacePathRp, timeVarying, timeStep, timeStep, false, Internals->RefModCallbacks);
+  }
+}
+
+void UsdBridge::RemoveSurfaceRefs(UsdGroupHandle group, const UsdSurfaceHandle* surfaces, uint64_t numSurfaces, bool timeVarying, double timeStep)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::RemoveSurfaceRefs");
+
+  if (group.value == nullptr) return;
+
+  UsdBridgePrimCache* groupCache = BRIDGE_CACHE.ConvertToPrimCache(group);
+  const UsdBridgePrimCacheList& surfaceCaches = Internals->ExtractPrimCaches<UsdSurfaceHandle>(BRIDGE_CACHE, surfaces, numSurfaces);
+
+  BRIDGE_USDWRITER.RemoveRefs(groupCache, surfaceCaches, surfacePathRp, timeVarying, timeStep, Internals->RefModCallbacks.AtRemoveRef);
+}
+
+void UsdBridge::AddVolumeRefs(UsdGroupHandle group, const UsdVolumeHandle* volumes, uint64_t numVolumes, bool timeVarying, double timeStep)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::AddVolumeRefs");
+
+  if (group.value == nullptr) return;
+
+  UsdBridgePrimCache* groupCache = BRIDGE_CACHE.ConvertToPrimCache(group);
+  const UsdBridgePrimCacheList& volumeCaches = Internals->ExtractPrimCaches<UsdVolumeHandle>(BRIDGE_CACHE, volumes, numVolumes);
+
+  for (uint64_t i = 0; i < numVolumes; ++i)
+  {
+    BRIDGE_USDWRITER.AddRef_NoClip(groupCache, volumeCaches[i], volumePathRp, timeVarying, timeStep, timeStep, false, Internals->RefModCallbacks);
+  }
+}
+
+void UsdBridge::RemoveVolumeRefs(UsdGroupHandle group, const UsdVolumeHandle* volumes, uint64_t numVolumes, bool timeVarying, double timeStep)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::RemoveVolumeRefs");
+
+  if (group.value == nullptr) return;
+
+  UsdBridgePrimCache* groupCache = BRIDGE_CACHE.ConvertToPrimCache(group);
+  const UsdBridgePrimCacheList& volumeCaches = Internals->ExtractPrimCaches<UsdVolumeHandle>(BRIDGE_CACHE, volumes, numVolumes);
+
+  BRIDGE_USDWRITER.RemoveRefs(groupCache, volumeCaches, volumePathRp, timeVarying, timeStep, Internals->RefModCallbacks.AtRemoveRef);
+}
+
 void UsdBridge::SetGeometryMaterialRef(UsdSurfaceHandle surface, UsdGeometryHandle geometry, UsdMaterialHandle material, double timeStep, double geomTimeStep, double matTimeStep)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::SetGeometryMaterialRef");
+
   if (surface.value == nullptr) return;
 
   UsdBridgePrimCache* surfaceCache = BRIDGE_CACHE.ConvertToPrimCache(surface);
   UsdBridgePrimCache* geometryCache = BRIDGE_CACHE.ConvertToPrimCache(geometry);
   UsdBridgePrimCache* materialCache = BRIDGE_CACHE.ConvertToPrimCache(material);
 
-  // Update the references
-  SdfPath refGeomPath = BRIDGE_USDWRITER.AddRef(surfaceCache, geometryCache, geometryPathRp, false, true, true, geomClipPf, timeStep, geomTimeStep, true, Internals->RefModCallbacks); // Can technically be timeVarying, but would be a bit confusing. Instead, timevary the surface.
-  SdfPath refMatPath = BRIDGE_USDWRITER.AddRef(surfaceCache, materialCache, materialPathRp, false, true, false, nullptr, timeStep, matTimeStep, true, Internals->RefModCallbacks);
+  // Geometry commits re-reference the surface when the geometry's prototype changes
+  if (Internals->DedupGeometry)
+    Internals->GeometryRegistry.SetSurfaceRef(geometryCache, { surfaceCache, materialCache, timeStep, geomTimeStep, matTimeStep });
 
-  // Bind the referencing material to the referencing geom prim (as they are within same scope in this usd prim)
-  BRIDGE_USDWRITER.BindMaterialToGeom(refGeomPath, refMatPath);
+  Internals->SetGeometryMaterialRef(surfaceCache, geometryCache, materialCache, timeStep, geomTimeStep, matTimeStep);
 }
 
 void UsdBridge::SetSpatialFieldRef(UsdVolumeHandle volume, UsdSpatialFieldHandle field, double timeStep, double fieldTimeStep)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::SetSpatialFieldRef");
+
   if (volume.value == nullptr) return;
 
   UsdBridgePrimCache* volumeCache = BRIDGE_CACHE.ConvertToPrimCache(volume);
@@ -525,6 +836,8 @@ void UsdBridge::SetSpatialFieldRef(UsdVolumeHandle volume, UsdSpatialFieldHandle
 
 void UsdBridge::SetSamplerRef(UsdMaterialHandle material, UsdSamplerHandle sampler, const char* texfileName, double timeStep)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::SetSamplerRef");
+
   if (material.value == nullptr) return;
 
   UsdBridgePrimCache* matCache = BRIDGE_CACHE.ConvertToPrimCache(material);
@@ -539,10 +852,8 @@ void UsdBridge::SetSamplerRef(UsdMaterialHandle material, UsdSamplerHandle sampl
 
   BRIDGE_USDWRITER.BindSamplerToMaterial(materialStage, matPrimPath, refSamplerPath, texfileName);
 
-#ifdef VALUE_CLIP_RETIMING
-  if(this->EnableSaving)
-    materialStage->Save();
-#endif
+  if(this->EnableSaving && BRIDGE_USDWRITER.UsesPrimStages())
+    BRIDGE_USDWRITER.SaveTimeVarStage(materialStage);
 }
 
 void UsdBridge::DeleteInstanceRefs(UsdWorldHandle world, bool timeVarying, double timeStep)
@@ -630,6 +941,8 @@ void UsdBridge::UpdateBeginEndTime(double timeStep)
 
 void UsdBridge::SetInstanceTransform(UsdInstanceHandle instance, float* transform, bool timeVarying, double timeStep)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::SetInstanceTransform");
+
   if (instance.value == nullptr) return;
 
   UsdBridgePrimCache* cache = BRIDGE_CACHE.ConvertToPrimCache(instance);
@@ -639,15 +952,50 @@ void UsdBridge::SetInstanceTransform(UsdInstanceHandle instance, float* transfor
   BRIDGE_USDWRITER.UpdateUsdTransform(transformPath, transform, timeVarying, timeStep);
 }
 
+void UsdBridge::SetInstanceTransforms(const UsdInstanceHandle* instances, const float* transforms, uint64_t numInstances, bool timeVarying, double timeStep)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::SetInstanceTransforms");
+
+  const UsdBridgePrimCacheList& instanceCaches = Internals->ExtractPrimCaches<UsdInstanceHandle>(BRIDGE_CACHE, instances, numInstances);
+
+  BRIDGE_USDWRITER.UpdateUsdTransforms(instanceCaches, transforms, timeVarying, timeStep);
+}
+
 template<typename GeomDataType>
 void UsdBridge::SetGeometryDataTemplate(UsdGeometryHandle geometry, const GeomDataType& geomData, double timeStep)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::SetGeometryData");
+
   if (geometry.value == nullptr) return;
 
   UsdBridgePrimCache* cache = BRIDGE_CACHE.ConvertToPrimCache(geometry);
 
+  // Prototypes are time-uniform and replace the geometry reference of a surface at all times,
+  // so only geometries without timevarying data are deduplicated
+  bool releasedPrototypes = false;
+  if (Internals->DedupGeometry)
+  {
+    if (geomData.TimeVarying == GeomDataType::DataMemberId::NONE)
+    {
+      Internals->DedupGeometryData(cache, geomData, timeStep);
+      return;
+    }
+    releasedPrototypes = Internals->ReleaseGeometryPrototypes(cache);
+  }
+
   SdfPath& geomPath = cache->PrimPath;
 
+#ifdef TIME_CLIP_STAGES
+  // Members that became timevarying after the manifest was created are added to it; clips copied
+  // from the older manifest get them when updated (see UsdBridgeUsdWriter::GetTimeVarStage)
+  uint32_t timeVarying = static_cast<uint32_t>(geomData.TimeVarying);
+  if (BRIDGE_USDWRITER.UsesClipStages() && (timeVarying & ~cache->ManifestTimeVarying))
+  {
+    BRIDGE_USDWRITER.CreateUsdGeometryManifest(cache->Name.GetText(), cache, geomData);
+    cache->ManifestTimeVarying |= timeVarying;
+  }
+#endif
+
   std::pair<UsdStageRefPtr, bool> stageCreatePair = BRIDGE_USDWRITER.GetTimeVarStage(cache
 #ifdef TIME_CLIP_STAGES
     , true, geomClipPf, timeStep
@@ -661,10 +1009,19 @@ void UsdBridge::SetGeometryDataTemplate(UsdGeometryHandle geometry, const GeomDa
 
   BRIDGE_USDWRITER.UpdateUsdGeometry(geomStage, geomPath, geomData, timeStep);
 
-#ifdef VALUE_CLIP_RETIMING
-  if(this->EnableSaving)
-    geomStage->Save();
+  // Surfaces of other timesteps keep referencing the prototypes, as the geometry's own prim has no data for them
+  if (releasedPrototypes)
+    Internals->UpdateGeometrySurfaceRefs(cache, timeStep);
+
+  if(this->EnableSaving && BRIDGE_USDWRITER.UsesPrimStages())
+  {
+    BRIDGE_USDWRITER.SaveTimeVarStage(geomStage);
+#ifdef TIME_CLIP_STAGES
+    BRIDGE_USDWRITER.ReleasePrimClipStage(cache, timeStep);
 #endif
+  }
+
+  BRIDGE_USDWRITER.UpdateTimeVarFootprint(cache, geomData, timeStep);
 }
 
 void UsdBridge::SetGeometryData(UsdGeometryHandle geometry, const UsdBridgeMeshData& meshData, double timeStep)
@@ -684,6 +1041,8 @@ void UsdBridge::SetGeometryData(UsdGeometryHandle geometry, const UsdBridgeCurve
 
 void UsdBridge::SetVolumeData(UsdSpatialFieldHandle field, const UsdBridgeVolumeData & volumeData, double timeStep)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::SetVolumeData");
+
   if (field.value == nullptr) return;
 
   UsdBridgePrimCache* cache = BRIDGE_CACHE.ConvertToPrimCache(field);
@@ -693,14 +1052,34 @@ void UsdBridge::SetVolumeData(UsdSpatialFieldHandle field, const UsdBridgeVolume
   // To avoid data duplication when using of clip stages, we need to potentially use the scenestage prim for time-uniform data.
   BRIDGE_USDWRITER.UpdateUsdVolume(volumeStage, cache->PrimPath, cache->Name.GetString(), volumeData, timeStep);
 
-#ifdef VALUE_CLIP_RETIMING
-  if(this->EnableSaving)
-    volumeStage->Save();
-#endif
+  if(this->EnableSaving && BRIDGE_USDWRITER.UsesPrimStages())
+    BRIDGE_USDWRITER.SaveTimeVarStage(volumeStage);
+}
+
+void UsdBridge::SetVolumeRegionData(UsdSpatialFieldHandle field, const UsdBridgeVolumeData& volumeData, const size_t* regionOffset, const size_t* regionDims, double timeStep)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::SetVolumeRegionData");
+
+  if (field.value == nullptr) return;
+
+  UsdBridgePrimCache* cache = BRIDGE_CACHE.ConvertToPrimCache(field);
+
+  UsdStageRefPtr volumeStage = BRIDGE_USDWRITER.GetTimeVarStage(cache).first;
+
+  if (!cache->VolumeRegions)
+    cache->VolumeRegions = std::make_unique<UsdBridgeVolumeRegions>();
+
+  BRIDGE_USDWRITER.UpdateUsdVolumeRegion(volumeStage, cache->PrimPath, cache->Name.GetString(), *cache->VolumeRegions,
+    volumeData, regionOffset, regionDims, timeStep);
+
+  if(this->EnableSaving && BRIDGE_USDWRITER.UsesPrimStages())
+    BRIDGE_USDWRITER.SaveTimeVarStage(volumeStage);
 }
 
 void UsdBridge::SetMaterialData(UsdMaterialHandle material, const UsdBridgeMaterialData& matData, double timeStep)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::SetMaterialData");
+
   if (material.value == nullptr) return;
 
   UsdBridgePrimCache* matCache = BRIDGE_CACHE.ConvertToPrimCache(material);
@@ -710,14 +1089,14 @@ void UsdBridge::SetMaterialData(UsdMaterialHandle material, const UsdBridgeMater
 
   BRIDGE_USDWRITER.UpdateUsdMaterial(materialStage, matPrimPath, matData, timeStep);
 
-#ifdef VALUE_CLIP_RETIMING
-  if(this->EnableSaving)
-    materialStage->Save();
-#endif
+  if(this->EnableSaving && BRIDGE_USDWRITER.UsesPrimStages())
+    BRIDGE_USDWRITER.SaveTimeVarStage(materialStage);
 }
 
 void UsdBridge::SetSamplerData(UsdSamplerHandle sampler, const UsdBridgeSamplerData& samplerData, double timeStep)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::SetSamplerData");
+
   if (sampler.value == nullptr) return;
 
   UsdBridgePrimCache* cache = BRIDGE_CACHE.ConvertToPrimCache(sampler);
@@ -729,16 +1108,34 @@ void UsdBridge::SetSamplerData(UsdSamplerHandle sampler, const UsdBridgeSamplerD
 
 void UsdBridge::SaveScene()
 {
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::SaveScene");
+
   if (!SessionValid) return;
 
+  // Only the timestep that was current before the saves is journaled, as later data may not be part of them
+  double savedTimeStep = BRIDGE_USDWRITER.GetCurrentTimeStep();
+
+  // Saves deferred by parallel writes were issued while saving was enabled
+  BRIDGE_USDWRITER.FlushStageSaves();
+
   if(this->EnableSaving)
-    BRIDGE_USDWRITER.GetSceneStage()->Save();
+  {
+    BRIDGE_USDWRITER.SaveSceneStage();
+    BRIDGE_USDWRITER.CommitSessionJournal(savedTimeStep);
+  }
 }
 
-void UsdBridge::GarbageCollect()
+bool UsdBridge::GetResumeTimeStep(double& timeStep)
+{
+  if (!SessionValid) return false;
+
+  return BRIDGE_USDWRITER.GetResumeTimeStep(timeStep);
+}
+
+bool UsdBridge::RemoveUnreferencedPrims(uint64_t maxNumPrims)
 {
 #ifdef TIME_BASED_CACHING
-  BRIDGE_CACHE.RemoveUnreferencedPrimCaches(
+  return BRIDGE_CACHE.RemoveUnreferencedPrimCaches(
     [this](ConstPrimCacheIterator it) 
     { 
       UsdBridgePrimCache* cacheEntry = (*it).second.get();
@@ -747,13 +1144,35 @@ void UsdBridge::GarbageCollect()
         cacheEntry->ResourceCollect(cacheEntry, BRIDGE_USDWRITER);
 
       BRIDGE_USDWRITER.DeletePrim(cacheEntry);
-    }
+      Internals->GeometryRegistry.RemovePrimCache(cacheEntry);
+    },
+    size_t(maxNumPrims)
   );
+#else
+  return false;
+#endif
+}
+
+void UsdBridge::GarbageCollect()
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::GarbageCollect");
+
+#ifdef TIME_BASED_CACHING
+  RemoveUnreferencedPrims(0);
   if(this->EnableSaving)
     BRIDGE_USDWRITER.GetSceneStage()->Save();
 #endif
 }
 
+bool UsdBridge::GarbageCollectStep(uint64_t maxNumPrims)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridge::GarbageCollectStep");
+
+  if (!SessionValid || maxNumPrims == 0) return false;
+
+  return RemoveUnreferencedPrims(maxNumPrims);
+}
+
 void UsdBridge::SetConnectionLogVerbosity(int logVerbosity)
 {
   int logLevel = UsdBridgeRemoteConnection::GetConnectionLogLevelMax() - logVerbosity; // Just invert verbosity to get the level
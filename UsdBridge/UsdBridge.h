@@ -18,6 +18,11 @@ class UsdBridge
 
     void SetExternalSceneStage(SceneStagePtr sceneStage);
     void SetEnableSaving(bool enableSaving);
+    void SetBatchChanges(bool batchChanges);
+    void SetTimeSampleTolerance(double tolerance);
+    void SetParallelWrites(bool parallelWrites);
+    void SetMemoryBudget(uint64_t budgetMB);
+    uint64_t GetMemoryFootprint() const; // Estimated bytes of timevarying data held in memory, see SetMemoryBudget
   
     bool OpenSession(UsdBridgeLogCallback logCallback, void* logUserData);
     bool GetSessionValid() const { return SessionValid; }
@@ -46,9 +51,18 @@ class UsdBridge
     void DeleteSampler(UsdSamplerHandle handle);
   
     void SetInstanceRefs(UsdWorldHandle world, const UsdInstanceHandle* instances, uint64_t numInstances, bool timeVarying, double timeStep);
+    // Additionally references a point instancer of the world, holding the instances of groupInstances
+    void SetInstanceRefs(UsdWorldHandle world, const UsdInstanceHandle* instances, uint64_t numInstances, const UsdBridgeGroupInstancesData& groupInstances, bool timeVarying, double timeStep);
     void SetGroupRef(UsdInstanceHandle instance, UsdGroupHandle group, bool timeVarying, double timeStep);
     void SetSurfaceRefs(UsdGroupHandle group, const UsdSurfaceHandle* surfaces, uint64_t numSurfaces, bool timeVarying, double timeStep);
     void SetVolumeRefs(UsdGroupHandle group, const UsdVolumeHandle* volumes, uint64_t numVolumes, bool timeVarying, double timeStep);
+    // Incremental counterparts of the Set*Refs functions above, leaving all other references of the parent untouched
+    void AddInstanceRefs(UsdWorldHandle world, const UsdInstanceHandle* instances, uint64_t numInstances, bool timeVarying, double timeStep);
+    void RemoveInstanceRefs(UsdWorldHandle world, const UsdInstanceHandle* instances, uint64_t numInstances, bool timeVarying, double timeStep);
+    void AddSurfaceRefs(UsdGroupHandle group, const UsdSurfaceHandle* surfaces, uint64_t numSurfaces, bool timeVarying, double timeStep);
+    void RemoveSurfaceRefs(UsdGroupHandle group, const UsdSurfaceHandle* surfaces, uint64_t numSurfaces, bool timeVarying, double timeStep);
+    void AddVolumeRefs(UsdGroupHandle group, const UsdVolumeHandle* volumes, uint64_t numVolumes, bool timeVarying, double timeStep);
+    void RemoveVolumeRefs(UsdGroupHandle group, const UsdVolumeHandle* volumes, uint64_t numVolumes, bool timeVarying, double timeStep);
     void SetGeometryMaterialRef(UsdSurfaceHandle surface, UsdGeometryHandle geometry, UsdMaterialHandle material, double timeStep, double geomTimeStep, double matTimeStep);
     void SetSpatialFieldRef(UsdVolumeHandle volume, UsdSpatialFieldHandle field, double timeStep, double fieldTimeStep);
     void SetSamplerRef(UsdMaterialHandle material, UsdSamplerHandle sampler, const char* texfileName, double timeStep);
@@ -64,16 +78,24 @@ class UsdBridge
   
     void UpdateBeginEndTime(double timeStep);
     void SetInstanceTransform(UsdInstanceHandle instance, float* transform, bool timeVarying, double timeStep);
+    // Sets the transforms of many instances at once, with a column-major 3x4 matrix per instance in transforms
+    void SetInstanceTransforms(const UsdInstanceHandle* instances, const float* transforms, uint64_t numInstances, bool timeVarying, double timeStep);
     void SetGeometryData(UsdGeometryHandle geometry, const UsdBridgeMeshData& meshData, double timeStep);
     void SetGeometryData(UsdGeometryHandle geometry, const UsdBridgeInstancerData& instancerData, double timeStep);
     void SetGeometryData(UsdGeometryHandle geometry, const UsdBridgeCurveData& curveData, double timeStep);
     void SetVolumeData(UsdSpatialFieldHandle field, const UsdBridgeVolumeData& volumeData, double timeStep);
+    // Submits part of a volume; volumeData describes the full volume, with Data pointing to the region of regionDims at regionOffset.
+    // The volume is output once its (disjoint) regions of the same timeStep cover the full volume.
+    void SetVolumeRegionData(UsdSpatialFieldHandle field, const UsdBridgeVolumeData& volumeData, const size_t* regionOffset, const size_t* regionDims, double timeStep);
     void SetMaterialData(UsdMaterialHandle material, const UsdBridgeMaterialData& matData, double timeStep);
     void SetSamplerData(UsdSamplerHandle sampler, const UsdBridgeSamplerData& samplerData, double timeStep);
   
     void SaveScene();
+    bool GetResumeTimeStep(double& timeStep); // Last saved timestep of a resumed session, if any
 
     void GarbageCollect();
+    // Removes at most maxNumPrims unreferenced prims, without saving; returns whether unreferenced prims remain
+    bool GarbageCollectStep(uint64_t maxNumPrims);
 
     //
     // Static parameter interface
@@ -89,6 +111,8 @@ class UsdBridge
     template<typename GeomDataType>
     void SetGeometryDataTemplate(UsdGeometryHandle geometry, const GeomDataType& geomData, double timeStep);
 
+    bool RemoveUnreferencedPrims(uint64_t maxNumPrims);
+
     UsdBridgeInternals* Internals;
   
     bool EnableSaving;
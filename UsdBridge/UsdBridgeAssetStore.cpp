@@ -0,0 +1,147 @@
+// Copyright 2020 The Khronos Group
+// SPDX-License-Identifier: Apache-2.0
+
+#include "UsdBridgeAssetStore.h"
+#include "UsdBridgeUtils.h"
+#include "UsdBridgeTrace.h"
+#include "UsdBridgeConnection.h"
+
+namespace
+{
+  // Forwards output to another stream buffer, hashing it on the way
+  class UsdBridgeHashingBuf : public std::streambuf
+  {
+  public:
+    UsdBridgeHashingBuf(std::streambuf* output) : Output(output) {}
+
+    UsdBridgeContentHasher Hasher;
+
+  protected:
+    int_type overflow(int_type ch) override
+    {
+      if (traits_type::eq_int_type(ch, traits_type::eof()))
+        return traits_type::not_eof(ch);
+
+      char c = traits_type::to_char_type(ch);
+      return xsputn(&c, 1) == 1 ? ch : traits_type::eof();
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize n) override
+    {
+      std::streamsize numWritten = Output->sputn(data, n);
+      Hasher.Update(data, size_t(numWritten));
+      return numWritten;
+    }
+
+    std::streambuf* Output;
+  };
+}
+
+UsdBridgeAssetStore::UsdBridgeAssetStore(UsdBridgeConnection* connect, const std::string& sessionDirectory, const char* storeFolder)
+  : Connect(connect)
+  , SessionDirectory(sessionDirectory)
+  , StoreFolder(storeFolder)
+{
+}
+
+bool UsdBridgeAssetStore::AddAsset(const char* data, size_t dataSize, const char* extension, std::string& assetPath)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeAssetStore::AddAsset");
+
+  assetPath = StoreFolder + UsdBridgeContentHash(data, dataSize) + extension;
+
+  std::lock_guard<std::mutex> lock(AssetsMutex);
+
+  if (AddAssetRef(assetPath, dataSize))
+    return true;
+
+  // An untracked file with the same name (from a previous run) has the same contents, so overwriting is harmless
+  if (!Connect->WriteFile(data, dataSize, (SessionDirectory + assetPath).c_str()))
+    return false;
+
+  Assets.emplace(assetPath, AssetEntry{ dataSize, 1 });
+  NumStoredBytes += dataSize;
+
+  return true;
+}
+
+bool UsdBridgeAssetStore::AddAsset(const AssetWriteFunc& writeAsset, const char* extension, std::string& assetPath)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeAssetStore::AddAsset");
+
+  // The content hash is only known once the asset is written, under a temporary name that is unique among concurrent writers
+  std::string tempPath = SessionDirectory + StoreFolder + "tmp_" + std::to_string(NextTempId++) + extension;
+
+  UsdBridgeOutputStream* output = Connect->OpenStream(tempPath.c_str());
+  if (!output)
+    return false;
+
+  UsdBridgeHashingBuf hashingBuf(output->GetOutput().rdbuf());
+  std::ostream hashingOutput(&hashingBuf);
+  writeAsset(hashingOutput);
+  hashingOutput.flush();
+
+  bool written = !hashingOutput.bad() && Connect->CloseStream(output);
+  size_t dataSize = size_t(hashingBuf.Hasher.GetNumBytes());
+  assetPath = StoreFolder + hashingBuf.Hasher.Finish() + extension;
+
+  std::lock_guard<std::mutex> lock(AssetsMutex);
+
+  if (!written || AddAssetRef(assetPath, dataSize))
+  {
+    Connect->RemoveFile(tempPath.c_str());
+    return written;
+  }
+
+  // As above, an untracked file with the same name has the same contents
+  if (!Connect->RenameFile(tempPath.c_str(), (SessionDirectory + assetPath).c_str()))
+  {
+    Connect->RemoveFile(tempPath.c_str());
+    return false;
+  }
+
+  Assets.emplace(assetPath, AssetEntry{ dataSize, 1 });
+  NumStoredBytes += dataSize;
+
+  return true;
+}
+
+bool UsdBridgeAssetStore::AddAssetRef(const std::string& assetPath, size_t dataSize)
+{
+  auto assetIt = Assets.find(assetPath);
+  if (assetIt == Assets.end())
+    return false;
+
+  ++assetIt->second.RefCount;
+  NumSharedBytes += dataSize;
+  return true;
+}
+
+bool UsdBridgeAssetStore::AddAssetRef(const std::string& assetPath)
+{
+  std::lock_guard<std::mutex> lock(AssetsMutex);
+
+  auto assetIt = Assets.find(assetPath);
+  if (assetIt == Assets.end())
+    return false;
+
+  ++assetIt->second.RefCount;
+  NumSharedBytes += assetIt->second.Size;
+  return true;
+}
+
+void UsdBridgeAssetStore::ReleaseAsset(const std::string& assetPath)
+{
+  std::lock_guard<std::mutex> lock(AssetsMutex);
+
+  auto assetIt = Assets.find(assetPath);
+  if (assetIt == Assets.end())
+    return;
+
+  if (--assetIt->second.RefCount == 0)
+  {
+    Connect->RemoveFile((SessionDirectory + assetPath).c_str());
+    NumStoredBytes -= assetIt->second.Size;
+    Assets.erase(assetIt);
+  }
+}
@@ -0,0 +1,60 @@
+// Copyright 2020 The Khronos Group
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UsdBridgeAssetStore_h
+#define UsdBridgeAssetStore_h
+
+#include <atomic>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <mutex>
+
+class UsdBridgeConnection;
+
+// Content-addressed store for asset files within a session directory. Assets are named after the hash of their contents,
+// so identical payloads are written only once and shared by all references to them. Each AddAsset() has to be balanced
+// by a ReleaseAsset() of the returned path; the file is removed when its last reference is released.
+class UsdBridgeAssetStore
+{
+  public:
+    using AssetWriteFunc = std::function<void(std::ostream&)>;
+
+    UsdBridgeAssetStore(UsdBridgeConnection* connect, const std::string& sessionDirectory, const char* storeFolder);
+
+    // Outputs the path of the stored asset relative to the session directory
+    bool AddAsset(const char* data, size_t dataSize, const char* extension, std::string& assetPath);
+    // Streams the asset to a temporary file through the connection while hashing it, then renames the file to its
+    // content-addressed path, or removes it if that asset is already stored. Hashes differ from those of the overload above.
+    bool AddAsset(const AssetWriteFunc& writeAsset, const char* extension, std::string& assetPath);
+    // Adds a reference to an asset that is already stored, returns false for paths not created by this store
+    bool AddAssetRef(const std::string& assetPath);
+    // Paths not created by this store (ie. from a previous run of a resumed session) are ignored
+    void ReleaseAsset(const std::string& assetPath);
+
+    size_t GetNumStoredBytes() const { return NumStoredBytes; }
+    size_t GetNumSharedBytes() const { return NumSharedBytes; }
+
+  protected:
+    struct AssetEntry
+    {
+      size_t Size;
+      int RefCount;
+    };
+
+    bool AddAssetRef(const std::string& assetPath, size_t dataSize); // Returns false if the asset is not stored yet
+
+    UsdBridgeConnection* Connect;
+    std::string SessionDirectory;
+    std::string StoreFolder;
+
+    std::unordered_map<std::string, AssetEntry> Assets;
+    std::mutex AssetsMutex;
+    std::atomic<uint64_t> NextTempId{0};
+
+    size_t NumStoredBytes = 0; // Currently in the store
+    size_t NumSharedBytes = 0; // Written as references to existing assets over the lifetime of the store
+};
+
+#endif
@@ -24,9 +24,20 @@ UsdBridgeTemporalCache::ConstPrimCacheIterator UsdBridgeTemporalCache::CreatePri
 
   // Create new cache entry
   std::unique_ptr<UsdBridgePrimCache> cacheEntry = std::make_unique<UsdBridgePrimCache>(primPath, nameSuffix, collectFunc);
+#ifdef TIME_BASED_CACHING
+  UnreferencedCaches.insert(cacheEntry.get());
+#endif
   return UsdPrimCaches.emplace(name, std::move(cacheEntry)).first;
 }
 
+void UsdBridgeTemporalCache::RemovePrimCache(ConstPrimCacheIterator it)
+{
+#ifdef TIME_BASED_CACHING
+  UnreferencedCaches.erase(it->second.get());
+#endif
+  UsdPrimCaches.erase(it);
+}
+
 void UsdBridgeTemporalCache::InitializeWorldPrim(UsdBridgePrimCache* worldCache)
 {
 #ifdef TIME_BASED_CACHING
@@ -37,56 +48,57 @@ void UsdBridgeTemporalCache::InitializeWorldPrim(UsdBridgePrimCache* worldCache)
 #ifdef TIME_BASED_CACHING
 void UsdBridgeTemporalCache::AddChild(UsdBridgePrimCache* parent, UsdBridgePrimCache* child)
 {
-  parent->Children.push_back(child);
+  ++parent->Children[child];
   child->IncRef();
 }
 
 void UsdBridgeTemporalCache::RemoveChild(UsdBridgePrimCache* parent, UsdBridgePrimCache* child)
 {
-  auto it = std::find(parent->Children.begin(), parent->Children.end(), child);
+  auto it = parent->Children.find(child);
+  assert(it != parent->Children.end());
   child->DecRef();
-  *it = parent->Children.back();
-  parent->Children.pop_back();
+  if (--it->second == 0)
+    parent->Children.erase(it);
+
+  if (child->RefCount == 0)
+    UnreferencedCaches.insert(child);
 }
 
-void UsdBridgeTemporalCache::RemoveUnreferencedChildTree(UsdBridgePrimCache* parent)
+void UsdBridgeTemporalCache::ReleaseChildren(UsdBridgePrimCache* parent)
 {
-  for (UsdBridgePrimCache* child : parent->Children)
+  for (const auto& childRefs : parent->Children)
   {
-    child->DecRef();
+    UsdBridgePrimCache* child = childRefs.first;
+    child->DecRef(childRefs.second);
     if(child->RefCount == 0)
-      RemoveUnreferencedChildTree(child);
+      UnreferencedCaches.insert(child);
   }
   parent->Children.clear();
 }
 
-void UsdBridgeTemporalCache::RemoveUnreferencedPrimCaches(std::function<void(ConstPrimCacheIterator)> atRemove)
+bool UsdBridgeTemporalCache::RemoveUnreferencedPrimCaches(std::function<void(ConstPrimCacheIterator)> atRemove, size_t maxNumRemoved)
 {
-  // First recursively remove all the child references for unreferenced prims
-  // Can only be performed at garbage collect. 
+  // The child references of an unreferenced prim can only be released at garbage collect.
   // If this is done during RemoveChild, an unreferenced parent cannot subsequently be revived with an AddChild.
-  PrimCacheContainer::iterator it = UsdPrimCaches.begin();
-  while (it != UsdPrimCaches.end())
+  size_t numRemoved = 0;
+  while (!UnreferencedCaches.empty() && (maxNumRemoved == 0 || numRemoved < maxNumRemoved))
   {
-    if (it->second->RefCount == 0)
-    {
-      RemoveUnreferencedChildTree(it->second.get());
-    }
-    ++it;
-  }
+    UsdBridgePrimCache* cache = *UnreferencedCaches.begin();
+    UnreferencedCaches.erase(UnreferencedCaches.begin());
 
-  // Now delete all prims without references from the cache
-  it = UsdPrimCaches.begin();
-  while (it != UsdPrimCaches.end())
-  {
-    if (it->second->RefCount == 0)
-    {
-      atRemove(it);
-
-      it = UsdPrimCaches.erase(it);
-    }
-    else
-      ++it;
+    if (cache->RefCount != 0)
+      continue; // Revived
+
+    ReleaseChildren(cache);
+
+    PrimCacheIterator it = UsdPrimCaches.find(cache->Name.GetString());
+    assert(it != UsdPrimCaches.end() && it->second.get() == cache);
+    atRemove(it);
+    UsdPrimCaches.erase(it);
+
+    ++numRemoved;
   }
+
+  return !UnreferencedCaches.empty();
 }
 #endif
\ No newline at end of file
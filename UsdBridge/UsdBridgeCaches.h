@@ -4,10 +4,15 @@
 #ifndef OmniBridgeCaches_h
 #define OmniBridgeCaches_h
 
+#include <array>
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "UsdBridgeData.h"
+#include "UsdBridgeVolumeWriter.h"
 
 struct UsdBridgePrimCache;
 class UsdBridgeUsdWriter;
@@ -18,6 +23,16 @@ typedef std::pair<bool, UsdBridgePrimCache*> BoolEntryPair;
 typedef void (*ResourceCollectFunc)(const UsdBridgePrimCache*, const UsdBridgeUsdWriter&);
 typedef std::vector<UsdBridgePrimCache*> UsdBridgePrimCacheList;
 
+// Regions of a volume field submitted in parts, until they cover the full volume
+struct UsdBridgeVolumeRegions
+{
+  UsdBridgeVolumeData Layout; // Full volume, without data
+  double TimeStep = 0.0;
+  size_t NumCoveredElements = 0;
+  std::vector<std::array<size_t, 6>> Covered; // Offset and dims of each region added, to reject overlaps
+  UsdBridgeVolumeGridsPtr Grids;
+};
+
 #ifdef TIME_BASED_CACHING
 struct UsdBridgeRefCache
 {
@@ -26,10 +41,10 @@ public:
 
 protected:
   void IncRef() { ++RefCount; }
-  void DecRef() { --RefCount; }
+  void DecRef(unsigned int numRefs = 1) { RefCount -= numRefs; }
 
   unsigned int RefCount = 0;
-  std::vector<UsdBridgePrimCache*> Children;
+  std::unordered_map<UsdBridgePrimCache*, unsigned int> Children; // Number of references to each child
   //Could also contain a mapping from child to an array of (parentTime,childTime) 
   //This would allow single timesteps to be removed in case of unused/replaced references at a parentTime (instead of removal of child if visible), without breaking garbage collection.
   //Additionally, a refcount per timestep would help to perform garbage collection of individual child clip stages/files, 
@@ -60,8 +75,11 @@ struct UsdBridgePrimCache
 
 #ifdef TIME_CLIP_STAGES
   std::unordered_map<double, UsdStagePair> ClipStages;
+  uint32_t ManifestTimeVarying = 0; // Timevarying members declared by the manifest of the clip stages
 #endif
 
+  std::unique_ptr<UsdBridgeVolumeRegions> VolumeRegions;
+
 #ifndef NDEBUG
   std::string Debug_Name;
 #endif
@@ -89,20 +107,30 @@ public:
   inline bool ValidIterator(ConstPrimCacheIterator it) const { return it != UsdPrimCaches.end(); }
 
   ConstPrimCacheIterator CreatePrimCache(const std::string& name, const std::string& fullPath, ResourceCollectFunc collectFunc = nullptr);
-  void RemovePrimCache(ConstPrimCacheIterator it) { UsdPrimCaches.erase(it); }
+  void RemovePrimCache(ConstPrimCacheIterator it);
 
   void InitializeWorldPrim(UsdBridgePrimCache* worldCache);
 
 #ifdef TIME_BASED_CACHING
   void AddChild(UsdBridgePrimCache* parent, UsdBridgePrimCache* child);
   void RemoveChild(UsdBridgePrimCache* parent, UsdBridgePrimCache* child);
-  void RemoveUnreferencedChildTree(UsdBridgePrimCache* parent);
-  void RemoveUnreferencedPrimCaches(std::function<void(ConstPrimCacheIterator)> atRemove);
+  // Removes at most maxNumRemoved unreferenced prim caches (0 removes all), including caches that become unreferenced as a result.
+  // Returns whether unreferenced caches remain for a subsequent call.
+  bool RemoveUnreferencedPrimCaches(std::function<void(ConstPrimCacheIterator)> atRemove, size_t maxNumRemoved = 0);
 #endif
 
 protected:
+#ifdef TIME_BASED_CACHING
+  void ReleaseChildren(UsdBridgePrimCache* parent);
+#endif
 
   PrimCacheContainer UsdPrimCaches;
+
+#ifdef TIME_BASED_CACHING
+  // Caches that have been without references since their creation or their last RemoveChild().
+  // They may have been referenced again since, which is checked at removal.
+  std::unordered_set<UsdBridgePrimCache*> UnreferencedCaches;
+#endif
 };
 
 #endif
\ No newline at end of file
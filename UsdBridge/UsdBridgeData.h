@@ -113,12 +113,62 @@ enum class UsdBridgeLogLevel
 };
 typedef void(*UsdBridgeLogCallback)(UsdBridgeLogLevel, void*, const char*);
 
+// Output files always atomically replace their previous version, the policy determines when they reach storage.
+enum class UsdBridgeSyncPolicy
+{
+  NONE,       // Left to the OS; survives process crashes, but not system failure
+  CHECKPOINT, // All output is flushed to storage before each session journal update
+  ALWAYS      // Each file is flushed to storage when it replaces its previous version
+};
+
+// Where timevarying data is written; layouts that are not compiled in (see UsdBridgeMacros.h) fall back to the nearest one that is
+enum class UsdBridgeTimeLayout
+{
+  SCENE_STAGE, // Time samples within the scene stage, with all timesteps global
+  PRIM_STAGES, // A separate stage per geometry, field and material, referenced through value clips that allow for retiming
+  CLIP_STAGES  // As PRIM_STAGES, with geometry data in a separate clip stage per timestep
+};
+
+enum class UsdBridgeVolumeLodFilter
+{
+  BOX,
+  MAX
+};
+
+enum class UsdBridgeVolumeCompression
+{
+  DEFAULT, // OpenVDB default (blosc if available, otherwise zip)
+  NONE,
+  ZIP,
+  BLOSC
+};
+
+constexpr int UsdBridgeMaxVolumeLodLevels = 3;
+
+struct UsdBridgeVolumeOutputSettings
+{
+  UsdBridgeVolumeCompression Compression = UsdBridgeVolumeCompression::DEFAULT;
+  bool HalfPrecision = false;     // Store float density and color grids as 16-bit half floats
+  bool QuantizeIntegers = false;  // Store 32/64-bit integer sources normalized to their value range, instead of as Int32/Int64 grids
+  bool BrickDeltas = false;       // Write only the bricks changed since the last keyframe, to a separate delta field
+  float MaxDeltaFraction = 0.25f; // Fraction of changed bricks above which a new keyframe is written instead of a delta
+  int LodLevels = 0;              // Number of additional levels downsampled by 2x, 4x, 8x, up to UsdBridgeMaxVolumeLodLevels
+  UsdBridgeVolumeLodFilter LodFilter = UsdBridgeVolumeLodFilter::BOX;
+};
+
 struct UsdBridgeSettings
 {
   const char* HostName;             // Name of the remote server 
   const char* OutputPath;           // Directory for output (on server if HostName is not empty) 
   bool CreateNewSession;            // Find a new session directory on creation of the bridge, or re-use the last opened one. 
   bool BinaryOutput;                // Select usda or usd output.
+  bool DirectIO;                    // Bypass the OS page cache for local output, to sustain throughput with large outputs.
+  UsdBridgeSyncPolicy SyncPolicy;   // When local output is flushed to storage, see UsdBridgeSyncPolicy.
+  bool DedupAssets;                 // Store volume files by content hash, so identical payloads are written only once.
+  bool DedupGeometry;               // Author bit-identical geometry data once, as a prototype referenced by instanceable prims.
+  UsdBridgeVolumeOutputSettings VolumeOutput; // Encoding of .vdb volume files
+  UsdBridgeTimeLayout TimeLayout;   // Output layout of timevarying data, fixed for the lifetime of the session
+  bool MappedArrays;                // With BinaryOutput, release saved clip stages and reopen their files memory-mapped when accessed again.
 };
 
 struct UsdBridgeMeshData
@@ -145,16 +195,22 @@ struct UsdBridgeMeshData
   //Mesh data
   uint64_t NumPoints = 0;
 
+  // Byte strides between consecutive elements of the per-vertex/per-prim arrays; 0 means tightly packed.
+  // Allows interleaved (array-of-structs) vertex buffers to be passed without repacking.
   const void* Points = nullptr;
   UsdBridgeType PointsType = UsdBridgeType::UNDEFINED;
+  int64_t PointsStride = 0;
   const void* Normals = nullptr;
   UsdBridgeType NormalsType = UsdBridgeType::UNDEFINED;
+  int64_t NormalsStride = 0;
   bool PerPrimNormals = false;
   const void* TexCoords = nullptr;
   UsdBridgeType TexCoordsType = UsdBridgeType::UNDEFINED;
+  int64_t TexCoordsStride = 0;
   bool PerPrimTexCoords = false;
   const void* Colors = nullptr;
   UsdBridgeType ColorsType = UsdBridgeType::UNDEFINED;
+  int64_t ColorsStride = 0;
   bool PerPrimColors = false;
 
   const void* Indices = nullptr;
@@ -203,20 +259,26 @@ struct UsdBridgeInstancerData
 
   bool UsePointInstancer = true;
 
+  // Strides as in UsdBridgeMeshData
   uint64_t NumPoints = 0;
   const void* Points = nullptr;
   UsdBridgeType PointsType = UsdBridgeType::UNDEFINED;
+  int64_t PointsStride = 0;
   const int* ShapeIndices = nullptr; //if set, one for every point
   const void* Scales = nullptr;// 3-vector scale
   UsdBridgeType ScalesType = UsdBridgeType::UNDEFINED;
+  int64_t ScalesStride = 0;
   double UniformScale = 1;// In case no scales are given
   const void* Orientations = nullptr;
   UsdBridgeType OrientationsType = UsdBridgeType::UNDEFINED;
+  int64_t OrientationsStride = 0;
   const void* TexCoords = nullptr;
   UsdBridgeType TexCoordsType = UsdBridgeType::UNDEFINED;
+  int64_t TexCoordsStride = 0;
   static constexpr bool PerPrimTexCoords = false; // For compatibility
   const void* Colors = nullptr;
   UsdBridgeType ColorsType = UsdBridgeType::UNDEFINED;
+  int64_t ColorsStride = 0;
   static constexpr bool PerPrimColors = false; // For compatibility
   const float* LinearVelocities = nullptr;
   const float* AngularVelocities = nullptr;
@@ -252,19 +314,25 @@ struct UsdBridgeCurveData
 
   uint64_t NumPoints = 0;
 
+  // Strides as in UsdBridgeMeshData
   const void* Points = nullptr;
   UsdBridgeType PointsType = UsdBridgeType::UNDEFINED;
+  int64_t PointsStride = 0;
   const void* Normals = nullptr;
   UsdBridgeType NormalsType = UsdBridgeType::UNDEFINED;
+  int64_t NormalsStride = 0;
   bool PerPrimNormals = false;
   const void* TexCoords = nullptr;
   UsdBridgeType TexCoordsType = UsdBridgeType::UNDEFINED;
+  int64_t TexCoordsStride = 0;
   bool PerPrimTexCoords = false;
   const void* Colors = nullptr;
   UsdBridgeType ColorsType = UsdBridgeType::UNDEFINED;
+  int64_t ColorsStride = 0;
   bool PerPrimColors = false; // One prim would be a full curve
   const void* Scales = nullptr; // Used for line width, typically 1-component
   UsdBridgeType ScalesType = UsdBridgeType::UNDEFINED;
+  int64_t ScalesStride = 0;
   double UniformScale = 1;// In case no scales are given
 
   const int* CurveLengths = nullptr;
@@ -298,6 +366,7 @@ struct UsdBridgeVolumeData
   const void* Data = nullptr;
   UsdBridgeType DataType = UsdBridgeType::UNDEFINED; // Same timeVarying rule as 'Data'
   size_t NumElements[3] = { 0,0,0 }; // Same timeVarying rule as 'Data'
+  int64_t DataStrides[3] = { 0,0,0 }; // Byte strides along x, y and z; 0 means tightly packed along that axis
   float Origin[3] = { 0,0,0 };
   float CellDimensions[3] = { 1,1,1 };
 
@@ -310,6 +379,26 @@ struct UsdBridgeVolumeData
   double TfValueRange[2] = { 0, 1 };
 };
 
+// Selection of bricks of a volume's dense data, with the brick size of an openvdb leaf node
+struct UsdBridgeVolumeBrickMask
+{
+  static constexpr size_t BrickDim = 8;
+
+  size_t NumBricks[3] = { 0,0,0 };
+  std::vector<bool> Bricks; // x fastest
+};
+
+// Instances of groups, authored in bulk as a single point instancer with a prototype per group
+struct UsdBridgeGroupInstancesData
+{
+  const UsdGroupHandle* Groups = nullptr; // Prototypes
+  uint64_t NumGroups = 0;
+
+  const int* GroupIndices = nullptr;      // Per instance, index into Groups
+  const float* Transforms = nullptr;      // Per instance, a column-major 3x4 matrix (linear part followed by translation)
+  uint64_t NumInstances = 0;
+};
+
 struct UsdBridgeMaterialData
 {
   enum class DataMemberId : uint32_t
@@ -0,0 +1,62 @@
+// Copyright 2020 The Khronos Group
+// SPDX-License-Identifier: Apache-2.0
+
+#include "UsdBridgeFileRemover.h"
+#include "UsdBridgeConnection.h"
+
+#include <algorithm>
+
+UsdBridgeFileRemover::UsdBridgeFileRemover(const UsdBridgeConnection* connect)
+  : Connect(connect)
+{
+  RemoverThread = std::thread(&UsdBridgeFileRemover::Run, this);
+}
+
+UsdBridgeFileRemover::~UsdBridgeFileRemover()
+{
+  {
+    std::lock_guard<std::mutex> lock(RemoverMutex);
+    Stopping = true;
+  }
+  PendingCondition.notify_one();
+  RemoverThread.join();
+}
+
+void UsdBridgeFileRemover::RemoveFile(const std::string& filePath)
+{
+  {
+    std::lock_guard<std::mutex> lock(RemoverMutex);
+    PendingFiles.push_back(filePath);
+  }
+  PendingCondition.notify_one();
+}
+
+void UsdBridgeFileRemover::CancelRemoval(const std::string& filePath)
+{
+  std::unique_lock<std::mutex> lock(RemoverMutex);
+
+  PendingFiles.erase(std::remove(PendingFiles.begin(), PendingFiles.end(), filePath), PendingFiles.end());
+
+  RemovedCondition.wait(lock, [this, &filePath]() { return RemovingFile != filePath; });
+}
+
+void UsdBridgeFileRemover::Run()
+{
+  std::unique_lock<std::mutex> lock(RemoverMutex);
+  while (true)
+  {
+    PendingCondition.wait(lock, [this]() { return Stopping || !PendingFiles.empty(); });
+    if (PendingFiles.empty())
+      break; // Only stops once all pending files are removed
+
+    RemovingFile = std::move(PendingFiles.front());
+    PendingFiles.pop_front();
+
+    lock.unlock();
+    Connect->RemoveFile(RemovingFile.c_str());
+    lock.lock();
+
+    RemovingFile.clear();
+    RemovedCondition.notify_all();
+  }
+}
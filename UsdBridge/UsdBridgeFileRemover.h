@@ -0,0 +1,42 @@
+// Copyright 2020 The Khronos Group
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UsdBridgeFileRemover_h
+#define UsdBridgeFileRemover_h
+
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+class UsdBridgeConnection;
+
+// Removes files on a background thread, so garbage collection does not have to wait for the storage.
+// A file that is about to be written again has to be passed to CancelRemoval() first.
+class UsdBridgeFileRemover
+{
+  public:
+    UsdBridgeFileRemover(const UsdBridgeConnection* connect);
+    ~UsdBridgeFileRemover(); // Finishes all pending removals
+
+    void RemoveFile(const std::string& filePath);
+    // Drops a pending removal of filePath, or waits until its removal has finished
+    void CancelRemoval(const std::string& filePath);
+
+  protected:
+    void Run();
+
+    const UsdBridgeConnection* Connect;
+
+    std::deque<std::string> PendingFiles;
+    std::string RemovingFile;
+    bool Stopping = false;
+
+    std::mutex RemoverMutex;
+    std::condition_variable PendingCondition;
+    std::condition_variable RemovedCondition;
+    std::thread RemoverThread;
+};
+
+#endif
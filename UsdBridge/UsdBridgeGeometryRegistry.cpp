@@ -0,0 +1,297 @@
+// Copyright 2020 The Khronos Group
+// SPDX-License-Identifier: Apache-2.0
+
+#include "UsdBridgeGeometryRegistry.h"
+#include "UsdBridgeUtils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace
+{
+  // Arrays are hashed in chunks of whole elements, so strided and packed arrays with the same contents hash alike
+  const size_t hashChunkSize = 1 << 16;
+
+  class GeometryHasher
+  {
+    public:
+      GeometryHasher(UsdBridgeGeomType geomType)
+      {
+        AddValue(geomType);
+      }
+
+      template<typename ValueType>
+      void AddValue(const ValueType& value)
+      {
+        UsdBridgeHash128(&value, sizeof(ValueType), Key.Hash);
+      }
+
+      void AddArray(const void* data, UsdBridgeType type, uint64_t numElements, int64_t stride = 0)
+      {
+        size_t eltSize = UsdBridgeTypeSize(type);
+        bool hasData = (data != nullptr) && (eltSize > 0);
+
+        AddValue(hasData);
+        if (!hasData)
+          return;
+        AddValue(type);
+        AddValue(numElements);
+
+        const char* bytes = static_cast<const char*>(data);
+        if (stride == 0)
+          stride = int64_t(eltSize);
+
+        size_t chunkElts = std::max(hashChunkSize / eltSize, size_t(1));
+        for (uint64_t chunkStart = 0; chunkStart < numElements; chunkStart += chunkElts)
+        {
+          size_t numChunkElts = size_t(std::min<uint64_t>(chunkElts, numElements - chunkStart));
+          const char* chunkBytes = bytes + int64_t(chunkStart) * stride;
+
+          if (stride == int64_t(eltSize))
+          {
+            UsdBridgeHash128(chunkBytes, numChunkElts * eltSize, Key.Hash);
+          }
+          else
+          {
+            GatherBuffer.resize(numChunkElts * eltSize);
+            for (size_t i = 0; i < numChunkElts; ++i)
+              std::memcpy(GatherBuffer.data() + i * eltSize, chunkBytes + int64_t(i) * stride, eltSize);
+            UsdBridgeHash128(GatherBuffer.data(), GatherBuffer.size(), Key.Hash);
+          }
+        }
+      }
+
+      UsdBridgeGeometryKey Key;
+
+    protected:
+      std::vector<char> GatherBuffer;
+  };
+}
+
+std::string UsdBridgeGeometryKey::ToString() const
+{
+  static const char hexDigits[] = "0123456789abcdef";
+  std::string keyStr(32, '0');
+  for (int i = 0; i < 16; ++i)
+  {
+    keyStr[15 - i] = hexDigits[(Hash[0] >> (i * 4)) & 0xf];
+    keyStr[31 - i] = hexDigits[(Hash[1] >> (i * 4)) & 0xf];
+  }
+  return keyStr;
+}
+
+UsdBridgeGeometryKey UsdBridgeHashGeometry(const UsdBridgeMeshData& geomData)
+{
+  GeometryHasher hasher(UsdBridgeMeshData::GeomType);
+
+  uint64_t numPrims = geomData.FaceVertexCount ? geomData.NumIndices / geomData.FaceVertexCount : 0;
+
+  hasher.AddValue(geomData.TimeVarying);
+  hasher.AddValue(geomData.NumPoints);
+  hasher.AddValue(geomData.NumIndices); // Indices may be implicit
+  hasher.AddValue(geomData.FaceVertexCount);
+  hasher.AddValue(geomData.PerPrimNormals);
+  hasher.AddValue(geomData.PerPrimTexCoords);
+  hasher.AddValue(geomData.PerPrimColors);
+
+  hasher.AddArray(geomData.Points, geomData.PointsType, geomData.NumPoints, geomData.PointsStride);
+  hasher.AddArray(geomData.Normals, geomData.NormalsType, geomData.PerPrimNormals ? numPrims : geomData.NumPoints, geomData.NormalsStride);
+  hasher.AddArray(geomData.TexCoords, geomData.TexCoordsType, geomData.PerPrimTexCoords ? numPrims : geomData.NumPoints, geomData.TexCoordsStride);
+  hasher.AddArray(geomData.Colors, geomData.ColorsType, geomData.PerPrimColors ? numPrims : geomData.NumPoints, geomData.ColorsStride);
+  hasher.AddArray(geomData.Indices, geomData.IndicesType, geomData.NumIndices);
+
+  return hasher.Key;
+}
+
+UsdBridgeGeometryKey UsdBridgeHashGeometry(const UsdBridgeInstancerData& geomData)
+{
+  GeometryHasher hasher(UsdBridgeInstancerData::GeomType);
+
+  hasher.AddValue(geomData.TimeVarying);
+  hasher.AddValue(geomData.NumPoints);
+  hasher.AddValue(geomData.UsePointInstancer);
+  hasher.AddValue(geomData.UniformScale);
+
+  hasher.AddArray(geomData.Shapes, UsdBridgeType::INT, geomData.NumShapes);
+  hasher.AddArray(geomData.Points, geomData.PointsType, geomData.NumPoints, geomData.PointsStride);
+  hasher.AddArray(geomData.ShapeIndices, UsdBridgeType::INT, geomData.NumPoints);
+  hasher.AddArray(geomData.Scales, geomData.ScalesType, geomData.NumPoints, geomData.ScalesStride);
+  hasher.AddArray(geomData.Orientations, geomData.OrientationsType, geomData.NumPoints, geomData.OrientationsStride);
+  hasher.AddArray(geomData.TexCoords, geomData.TexCoordsType, geomData.NumPoints, geomData.TexCoordsStride);
+  hasher.AddArray(geomData.Colors, geomData.ColorsType, geomData.NumPoints, geomData.ColorsStride);
+  hasher.AddArray(geomData.LinearVelocities, UsdBridgeType::FLOAT3, geomData.NumPoints);
+  hasher.AddArray(geomData.AngularVelocities, UsdBridgeType::FLOAT3, geomData.NumPoints);
+  hasher.AddArray(geomData.InstanceIds, geomData.InstanceIdsType, geomData.NumPoints);
+  hasher.AddArray(geomData.InvisibleIds, geomData.InvisibleIdsType, geomData.NumInvisibleIds);
+
+  return hasher.Key;
+}
+
+UsdBridgeGeometryKey UsdBridgeHashGeometry(const UsdBridgeCurveData& geomData)
+{
+  GeometryHasher hasher(UsdBridgeCurveData::GeomType);
+
+  uint64_t numPrims = geomData.NumCurveLengths;
+
+  hasher.AddValue(geomData.TimeVarying);
+  hasher.AddValue(geomData.NumPoints);
+  hasher.AddValue(geomData.UniformScale);
+  hasher.AddValue(geomData.PerPrimNormals);
+  hasher.AddValue(geomData.PerPrimTexCoords);
+  hasher.AddValue(geomData.PerPrimColors);
+
+  hasher.AddArray(geomData.Points, geomData.PointsType, geomData.NumPoints, geomData.PointsStride);
+  hasher.AddArray(geomData.Normals, geomData.NormalsType, geomData.PerPrimNormals ? numPrims : geomData.NumPoints, geomData.NormalsStride);
+  hasher.AddArray(geomData.TexCoords, geomData.TexCoordsType, geomData.PerPrimTexCoords ? numPrims : geomData.NumPoints, geomData.TexCoordsStride);
+  hasher.AddArray(geomData.Colors, geomData.ColorsType, geomData.PerPrimColors ? numPrims : geomData.NumPoints, geomData.ColorsStride);
+  hasher.AddArray(geomData.Scales, geomData.ScalesType, geomData.NumPoints, geomData.ScalesStride);
+  hasher.AddArray(geomData.CurveLengths, UsdBridgeType::INT, geomData.NumCurveLengths);
+
+  return hasher.Key;
+}
+
+UsdBridgeGeometryRegistry::Action UsdBridgeGeometryRegistry::Update(UsdBridgePrimCache* geomCache, double timeStep, const UsdBridgeGeometryKey& key,
+  UsdBridgePrimCache*& prototype, UsdBridgePrimCache*& releasedPrototype)
+{
+  prototype = nullptr;
+  releasedPrototype = nullptr;
+
+  GeometryTimeSteps& timeSteps = Geometries[geomCache];
+  auto stateIt = timeSteps.find(timeStep);
+  if (stateIt != timeSteps.end())
+  {
+    GeometryState& prevState = stateIt->second;
+    if (prevState.Key == key && prevState.Prototype)
+    {
+      prototype = prevState.Prototype;
+      return Action::SKIP;
+    }
+
+    releasedPrototype = prevState.Prototype;
+  }
+  else
+    stateIt = timeSteps.emplace(timeStep, GeometryState()).first;
+
+  GeometryState& state = stateIt->second;
+  state.Key = key;
+  state.Prototype = nullptr;
+
+  auto protoIt = Payloads.find(key);
+  if (protoIt == Payloads.end())
+    return Action::CREATE_PROTOTYPE;
+
+  state.Prototype = protoIt->second;
+  prototype = protoIt->second;
+  return Action::ALIAS;
+}
+
+void UsdBridgeGeometryRegistry::SetPrototype(UsdBridgePrimCache* geomCache, double timeStep, const UsdBridgeGeometryKey& key, UsdBridgePrimCache* protoCache)
+{
+  Payloads[key] = protoCache;
+  Prototypes[protoCache] = key;
+
+  Geometries[geomCache][timeStep].Prototype = protoCache;
+}
+
+UsdBridgePrimCache* UsdBridgeGeometryRegistry::FindPrototype(const UsdBridgePrimCache* geomCache, double timeStep) const
+{
+  auto geomIt = Geometries.find(geomCache);
+  if (geomIt == Geometries.end())
+    return nullptr;
+
+  auto stateIt = geomIt->second.find(timeStep);
+  return (stateIt != geomIt->second.end()) ? stateIt->second.Prototype : nullptr;
+}
+
+void UsdBridgeGeometryRegistry::SetSurfaceRef(UsdBridgePrimCache* geomCache, const SurfaceRef& surfaceRef)
+{
+  SurfaceTimeStep surfaceTimeStep(surfaceRef.Surface, surfaceRef.TimeStep);
+
+  auto prevGeomIt = SurfaceGeometries.find(surfaceTimeStep);
+  if (prevGeomIt != SurfaceGeometries.end() && prevGeomIt->second != geomCache)
+  {
+    auto prevSurfacesIt = GeometrySurfaces.find(prevGeomIt->second);
+    if (prevSurfacesIt != GeometrySurfaces.end())
+    {
+      prevSurfacesIt->second.erase(surfaceTimeStep);
+      if (prevSurfacesIt->second.empty())
+        GeometrySurfaces.erase(prevSurfacesIt);
+    }
+  }
+
+  SurfaceGeometries[surfaceTimeStep] = geomCache;
+  GeometrySurfaces[geomCache][surfaceTimeStep] = surfaceRef;
+}
+
+void UsdBridgeGeometryRegistry::GetSurfaceRefs(const UsdBridgePrimCache* geomCache, double geomTimeStep, std::vector<SurfaceRef>& surfaceRefs) const
+{
+  surfaceRefs.clear();
+
+  auto surfacesIt = GeometrySurfaces.find(geomCache);
+  if (surfacesIt == GeometrySurfaces.end())
+    return;
+
+  for (const auto& surfaceTimeStepRef : surfacesIt->second)
+  {
+    if (surfaceTimeStepRef.second.GeomTimeStep == geomTimeStep)
+      surfaceRefs.push_back(surfaceTimeStepRef.second);
+  }
+}
+
+void UsdBridgeGeometryRegistry::RemoveSurfaceRefs(const UsdBridgePrimCache* surfaceCache)
+{
+  auto geomIt = SurfaceGeometries.lower_bound(SurfaceTimeStep(surfaceCache, -std::numeric_limits<double>::infinity()));
+  while (geomIt != SurfaceGeometries.end() && geomIt->first.first == surfaceCache)
+  {
+    auto surfacesIt = GeometrySurfaces.find(geomIt->second);
+    if (surfacesIt != GeometrySurfaces.end())
+    {
+      surfacesIt->second.erase(geomIt->first);
+      if (surfacesIt->second.empty())
+        GeometrySurfaces.erase(surfacesIt);
+    }
+    geomIt = SurfaceGeometries.erase(geomIt);
+  }
+}
+
+void UsdBridgeGeometryRegistry::RemovePrimCache(const UsdBridgePrimCache* cache)
+{
+  auto protoIt = Prototypes.find(cache);
+  if (protoIt != Prototypes.end())
+  {
+    Payloads.erase(protoIt->second);
+    Prototypes.erase(protoIt);
+    return;
+  }
+
+  RemoveSurfaceRefs(cache);
+
+  auto surfacesIt = GeometrySurfaces.find(cache);
+  if (surfacesIt != GeometrySurfaces.end())
+  {
+    for (const auto& surfaceTimeStepRef : surfacesIt->second)
+      SurfaceGeometries.erase(surfaceTimeStepRef.first);
+    GeometrySurfaces.erase(surfacesIt);
+  }
+
+  std::vector<UsdBridgePrimCache*> releasedPrototypes;
+  RemoveGeometry(cache, releasedPrototypes);
+}
+
+void UsdBridgeGeometryRegistry::RemoveGeometry(const UsdBridgePrimCache* geomCache, std::vector<UsdBridgePrimCache*>& releasedPrototypes)
+{
+  releasedPrototypes.clear();
+
+  auto geomIt = Geometries.find(geomCache);
+  if (geomIt == Geometries.end())
+    return;
+
+  for (const auto& timeStepState : geomIt->second)
+  {
+    if (timeStepState.second.Prototype)
+      releasedPrototypes.push_back(timeStepState.second.Prototype);
+  }
+  Geometries.erase(geomIt);
+}
@@ -0,0 +1,104 @@
+// Copyright 2020 The Khronos Group
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UsdBridgeGeometryRegistry_h
+#define UsdBridgeGeometryRegistry_h
+
+#include "UsdBridgeData.h"
+
+#include <cstdint>
+#include <string>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+struct UsdBridgePrimCache;
+
+// Content hash of a geometry's data, including its layout and timevarying flags
+struct UsdBridgeGeometryKey
+{
+  uint64_t Hash[2] = { 0, 0 };
+
+  bool operator==(const UsdBridgeGeometryKey& other) const { return Hash[0] == other.Hash[0] && Hash[1] == other.Hash[1]; }
+  bool operator!=(const UsdBridgeGeometryKey& other) const { return !(*this == other); }
+
+  std::string ToString() const;
+};
+
+UsdBridgeGeometryKey UsdBridgeHashGeometry(const UsdBridgeMeshData& geomData);
+UsdBridgeGeometryKey UsdBridgeHashGeometry(const UsdBridgeInstancerData& geomData);
+UsdBridgeGeometryKey UsdBridgeHashGeometry(const UsdBridgeCurveData& geomData);
+
+// Detects geometries with bit-identical data. Each payload is authored once, as a prototype prim, to which all
+// geometries (timesteps) committing it are aliased instead of authoring the data themselves.
+// Each geometry timestep is aliased to at most one prototype; prototypes are immutable.
+// Also records the geometry referenced by each surface, so surfaces can be re-referenced when the alias changes.
+class UsdBridgeGeometryRegistry
+{
+  public:
+    enum class Action
+    {
+      SKIP,             // The geometry is already aliased to the payload's prototype at the timestep
+      ALIAS,            // The geometry is aliased to the returned prototype
+      CREATE_PROTOTYPE  // A prototype has to be created for the payload and passed to SetPrototype()
+    };
+
+    struct SurfaceRef
+    {
+      UsdBridgePrimCache* Surface;
+      UsdBridgePrimCache* Material;
+      double TimeStep;
+      double GeomTimeStep;
+      double MatTimeStep;
+    };
+
+    // Records key as the data of geomCache at timeStep. releasedPrototype returns the prototype the timestep was
+    // aliased to before, if that has changed.
+    Action Update(UsdBridgePrimCache* geomCache, double timeStep, const UsdBridgeGeometryKey& key,
+      UsdBridgePrimCache*& prototype, UsdBridgePrimCache*& releasedPrototype);
+    // Completes Action::CREATE_PROTOTYPE, aliasing geomCache at timeStep to protoCache
+    void SetPrototype(UsdBridgePrimCache* geomCache, double timeStep, const UsdBridgeGeometryKey& key, UsdBridgePrimCache* protoCache);
+
+    // Prototype geomCache is aliased to at timeStep, or nullptr if it holds its own data
+    UsdBridgePrimCache* FindPrototype(const UsdBridgePrimCache* geomCache, double timeStep) const;
+
+    // Records that surface references geomCache at the surface ref's timestep, replacing its previous geometry
+    void SetSurfaceRef(UsdBridgePrimCache* geomCache, const SurfaceRef& surfaceRef);
+    // Surfaces referencing geomCache at geomTimeStep
+    void GetSurfaceRefs(const UsdBridgePrimCache* geomCache, double geomTimeStep, std::vector<SurfaceRef>& surfaceRefs) const;
+
+    // Removes all records of a geometry or prototype cache that is deleted
+    void RemovePrimCache(const UsdBridgePrimCache* cache);
+    // Removes the records of a geometry that stops taking part in deduplication, such as one that becomes timevarying.
+    // releasedPrototypes returns the prototype of every timestep that was aliased to one.
+    void RemoveGeometry(const UsdBridgePrimCache* geomCache, std::vector<UsdBridgePrimCache*>& releasedPrototypes);
+
+    size_t GetNumPrototypes() const { return Prototypes.size(); }
+
+  protected:
+    struct KeyHasher
+    {
+      size_t operator()(const UsdBridgeGeometryKey& key) const { return size_t(key.Hash[0]); }
+    };
+
+    struct GeometryState
+    {
+      UsdBridgeGeometryKey Key;
+      UsdBridgePrimCache* Prototype = nullptr;
+    };
+    typedef std::map<double, GeometryState> GeometryTimeSteps;
+
+    typedef std::pair<const UsdBridgePrimCache*, double> SurfaceTimeStep;
+    typedef std::map<SurfaceTimeStep, SurfaceRef> SurfaceRefs;
+
+    void RemoveSurfaceRefs(const UsdBridgePrimCache* surfaceCache);
+
+    std::unordered_map<UsdBridgeGeometryKey, UsdBridgePrimCache*, KeyHasher> Payloads; // Prototype of each payload
+    std::unordered_map<const UsdBridgePrimCache*, GeometryTimeSteps> Geometries;
+    std::unordered_map<const UsdBridgePrimCache*, UsdBridgeGeometryKey> Prototypes;
+
+    std::unordered_map<const UsdBridgePrimCache*, SurfaceRefs> GeometrySurfaces; // Surfaces referencing each geometry
+    std::map<SurfaceTimeStep, const UsdBridgePrimCache*> SurfaceGeometries; // Geometry referenced by each surface timestep
+};
+
+#endif
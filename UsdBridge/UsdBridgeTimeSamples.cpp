@@ -0,0 +1,201 @@
+// Copyright 2020 The Khronos Group
+// SPDX-License-Identifier: Apache-2.0
+
+#include "UsdBridgeTimeSamples.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  // Larger arrays are geometry data, which is not expected to be interpolable
+  const size_t maxCompactedArraySize = 64;
+  // Bounds the memory held per attribute for a long run of dropped samples
+  const size_t maxDroppedSamples = 256;
+  // Bounds the erased samples remembered per attribute; older ones can no longer be restored
+  const size_t maxErasedSamples = 256;
+
+  double Deviation(double key, double end, double value, double alpha)
+  {
+    return std::abs(key + (end - key) * alpha - value);
+  }
+
+  template<typename VecType>
+  double VecDeviation(const VecType& key, const VecType& end, const VecType& value, double alpha)
+  {
+    double deviation = 0.0;
+    for (size_t i = 0; i < VecType::dimension; ++i)
+      deviation = std::max(deviation, Deviation(key[i], end[i], value[i], alpha));
+    return deviation;
+  }
+
+  double ValueDeviation(float key, float end, float value, double alpha) { return Deviation(key, end, value, alpha); }
+  double ValueDeviation(double key, double end, double value, double alpha) { return Deviation(key, end, value, alpha); }
+  double ValueDeviation(const GfVec2f& key, const GfVec2f& end, const GfVec2f& value, double alpha) { return VecDeviation(key, end, value, alpha); }
+  double ValueDeviation(const GfVec3f& key, const GfVec3f& end, const GfVec3f& value, double alpha) { return VecDeviation(key, end, value, alpha); }
+  double ValueDeviation(const GfVec4f& key, const GfVec4f& end, const GfVec4f& value, double alpha) { return VecDeviation(key, end, value, alpha); }
+  double ValueDeviation(const GfVec3d& key, const GfVec3d& end, const GfVec3d& value, double alpha) { return VecDeviation(key, end, value, alpha); }
+
+  double ValueDeviation(const GfMatrix4d& key, const GfMatrix4d& end, const GfMatrix4d& value, double alpha)
+  {
+    double deviation = 0.0;
+    for (int i = 0; i < 16; ++i)
+      deviation = std::max(deviation, Deviation(key.GetArray()[i], end.GetArray()[i], value.GetArray()[i], alpha));
+    return deviation;
+  }
+
+  template<typename EltType>
+  double ValueDeviation(const VtArray<EltType>& key, const VtArray<EltType>& end, const VtArray<EltType>& value, double alpha)
+  {
+    if (key.size() != value.size() || end.size() != value.size() || value.size() > maxCompactedArraySize)
+      return std::numeric_limits<double>::infinity();
+
+    double deviation = 0.0;
+    for (size_t i = 0; i < value.size(); ++i)
+      deviation = std::max(deviation, ValueDeviation(key[i], end[i], value[i], alpha));
+    return deviation;
+  }
+
+  template<typename ValueType>
+  bool GetDeviation(const VtValue& key, const VtValue& end, const VtValue& value, double alpha, double& deviation)
+  {
+    if (!key.IsHolding<ValueType>() || !end.IsHolding<ValueType>() || !value.IsHolding<ValueType>())
+      return false;
+    deviation = ValueDeviation(key.UncheckedGet<ValueType>(), end.UncheckedGet<ValueType>(), value.UncheckedGet<ValueType>(), alpha);
+    return true;
+  }
+
+  // Infinite for types that are not linearly interpolated by USD
+  double InterpolationDeviation(const VtValue& key, const VtValue& end, const VtValue& value, double alpha)
+  {
+    double deviation = std::numeric_limits<double>::infinity();
+    GetDeviation<float>(key, end, value, alpha, deviation)
+      || GetDeviation<double>(key, end, value, alpha, deviation)
+      || GetDeviation<GfVec2f>(key, end, value, alpha, deviation)
+      || GetDeviation<GfVec3f>(key, end, value, alpha, deviation)
+      || GetDeviation<GfVec4f>(key, end, value, alpha, deviation)
+      || GetDeviation<GfVec3d>(key, end, value, alpha, deviation)
+      || GetDeviation<GfMatrix4d>(key, end, value, alpha, deviation)
+      || GetDeviation<VtFloatArray>(key, end, value, alpha, deviation)
+      || GetDeviation<VtVec3fArray>(key, end, value, alpha, deviation);
+    return deviation;
+  }
+
+  // Last sample of attrPath before timeStep
+  bool GetPreviousTimeSample(const SdfLayerHandle& layer, const SdfPath& attrPath, double timeStep, double& prevTime)
+  {
+    double upper;
+    return layer->GetBracketingTimeSamplesForPath(attrPath, std::nextafter(timeStep, -std::numeric_limits<double>::infinity()), &prevTime, &upper)
+      && prevTime < timeStep;
+  }
+}
+
+bool UsdBridgeTimeSampleCompactor::Reproduces(const VtValue& keyValue, double keyTime, const VtValue& endValue, double endTime, const SampleList& samples) const
+{
+  for (const auto& sample : samples)
+  {
+    double alpha = (sample.first - keyTime) / (endTime - keyTime);
+    if (!(InterpolationDeviation(keyValue, endValue, sample.second, alpha) <= Tolerance))
+      return false;
+  }
+  return true;
+}
+
+void UsdBridgeTimeSampleCompactor::Restore(const SdfLayerHandle& layer, const SdfPath& attrPath, double timeStep, DroppedSamples& dropped)
+{
+  // The sample at timeStep changes the interpolation between the kept samples around it
+  double lowerTime = -std::numeric_limits<double>::infinity();
+  double upperTime = std::numeric_limits<double>::infinity();
+  double prevTime, nextTime, upper;
+  if (GetPreviousTimeSample(layer, attrPath, timeStep, prevTime))
+    lowerTime = prevTime;
+  if (layer->GetBracketingTimeSamplesForPath(attrPath, std::nextafter(timeStep, std::numeric_limits<double>::infinity()), &nextTime, &upper)
+    && upper > timeStep)
+    upperTime = upper;
+
+  auto erasedIt = dropped.Erased.upper_bound(lowerTime);
+  while (erasedIt != dropped.Erased.end() && erasedIt->first < upperTime)
+  {
+    if (erasedIt->first != timeStep)
+      layer->SetTimeSample(attrPath, erasedIt->first, erasedIt->second);
+    erasedIt = dropped.Erased.erase(erasedIt);
+  }
+  dropped.Samples.clear();
+}
+
+void UsdBridgeTimeSampleCompactor::RemovePrim(const SdfPath& primPath)
+{
+  auto droppedIt = Dropped.lower_bound(primPath);
+  while (droppedIt != Dropped.end() && droppedIt->first.HasPrefix(primPath))
+    droppedIt = Dropped.erase(droppedIt);
+}
+
+void UsdBridgeTimeSampleCompactor::SampleAuthored(const SdfLayerHandle& layer, const SdfPath& attrPath, double timeStep)
+{
+  DroppedSamples& dropped = Dropped[attrPath];
+  dropped.Erased.erase(timeStep); // Superseded by the sample just authored
+
+  // Samples authored before the last one change the interpolation of the dropped samples, so those are restored
+  double lastTime, upper;
+  if (!layer->GetBracketingTimeSamplesForPath(attrPath, std::nextafter(timeStep, std::numeric_limits<double>::infinity()), &lastTime, &upper)
+    || upper != timeStep)
+  {
+    Restore(layer, attrPath, timeStep, dropped);
+    return;
+  }
+
+  double prevTime;
+  if (!GetPreviousTimeSample(layer, attrPath, timeStep, prevTime))
+  {
+    dropped.Samples.clear();
+    return;
+  }
+
+  VtValue endValue, prevValue;
+  layer->QueryTimeSample(attrPath, timeStep, &endValue);
+  layer->QueryTimeSample(attrPath, prevTime, &prevValue);
+
+  // The last sample has been authored again, so the samples dropped since the previous (key) sample have to be verified again
+  if (prevTime == dropped.KeyTime && !dropped.Samples.empty())
+  {
+    if (!Reproduces(prevValue, prevTime, endValue, timeStep, dropped.Samples))
+    {
+      Restore(layer, attrPath, timeStep, dropped);
+      dropped.KeyTime = prevTime;
+    }
+    return;
+  }
+
+  double keyTime;
+  if (!GetPreviousTimeSample(layer, attrPath, prevTime, keyTime))
+  {
+    dropped.KeyTime = prevTime;
+    dropped.Samples.clear();
+    return;
+  }
+
+  if (keyTime != dropped.KeyTime)
+  {
+    dropped.KeyTime = keyTime;
+    dropped.Samples.clear();
+  }
+
+  VtValue keyValue;
+  layer->QueryTimeSample(attrPath, keyTime, &keyValue);
+
+  dropped.Samples.emplace_back(prevTime, prevValue);
+  if (dropped.Samples.size() <= maxDroppedSamples && Reproduces(keyValue, keyTime, endValue, timeStep, dropped.Samples))
+  {
+    layer->EraseTimeSample(attrPath, prevTime);
+    dropped.Erased[prevTime] = prevValue;
+    if (dropped.Erased.size() > maxErasedSamples)
+      dropped.Erased.erase(dropped.Erased.begin());
+  }
+  else
+  {
+    // The previous sample is kept as key for the samples that follow it
+    dropped.KeyTime = prevTime;
+    dropped.Samples.clear();
+  }
+}
@@ -0,0 +1,48 @@
+// Copyright 2020 The Khronos Group
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UsdBridgeTimeSamples_h
+#define UsdBridgeTimeSamples_h
+
+#include "usd.h"
+PXR_NAMESPACE_USING_DIRECTIVE
+
+#include <map>
+#include <utility>
+#include <vector>
+
+// Drops time samples that linear interpolation between their neighbouring samples reproduces within a tolerance,
+// as samples are appended to an attribute in increasing time order. Supports scalars, vectors, matrices and small arrays
+// of floating point type; the samples of other types, or of attributes that are not appended to, are left as is.
+class UsdBridgeTimeSampleCompactor
+{
+  public:
+    // Maximum absolute deviation per component, 0 disables compaction
+    void SetTolerance(double tolerance) { Tolerance = tolerance; }
+    bool IsEnabled() const { return Tolerance > 0.0; }
+
+    // To be called after the sample of attrPath at timeStep has been authored in layer
+    void SampleAuthored(const SdfLayerHandle& layer, const SdfPath& attrPath, double timeStep);
+    // Forgets the samples dropped from the attributes of a deleted prim and its descendants
+    void RemovePrim(const SdfPath& primPath);
+
+  protected:
+    typedef std::vector<std::pair<double, VtValue>> SampleList;
+
+    struct DroppedSamples
+    {
+      // Samples dropped after the last kept sample (KeyTime), which the next kept sample has to reproduce as well
+      double KeyTime = 0.0;
+      SampleList Samples;
+      // Most recent samples erased from the layer, restored when a sample authored out of order changes their interpolation
+      std::map<double, VtValue> Erased;
+    };
+
+    bool Reproduces(const VtValue& keyValue, double keyTime, const VtValue& endValue, double endTime, const SampleList& samples) const;
+    void Restore(const SdfLayerHandle& layer, const SdfPath& attrPath, double timeStep, DroppedSamples& dropped);
+
+    double Tolerance = 0.0;
+    std::map<SdfPath, DroppedSamples> Dropped; // Ordered, so the attributes of a prim are adjacent
+};
+
+#endif
@@ -0,0 +1,156 @@
+// Copyright 2020 The Khronos Group
+// SPDX-License-Identifier: Apache-2.0
+
+#include "UsdBridgeTrace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+  constexpr uint64_t traceBufferCapacity = 1 << 14; // Events retained per thread
+
+  struct UsdBridgeTraceEvent
+  {
+    const char* Name;
+    int64_t StartUs;
+    int64_t DurationUs;
+  };
+
+  // Slot of the ring buffer. Seq is odd while the owning thread writes the slot, and 2*(i+1) once it holds event i,
+  // so readers can detect torn or overwritten slots without holding up the writer.
+  struct UsdBridgeTraceSlot
+  {
+    std::atomic<uint64_t> Seq{0};
+    std::atomic<const char*> Name{nullptr};
+    std::atomic<int64_t> StartUs{0};
+    std::atomic<int64_t> DurationUs{0};
+  };
+
+  // Single-producer ring buffer, written to by its owning thread only and without locking.
+  struct UsdBridgeTraceBuffer
+  {
+    UsdBridgeTraceBuffer(uint64_t threadId) : ThreadId(threadId) {}
+
+    uint64_t ThreadId;
+    std::atomic<uint64_t> NumWritten{0};
+    std::atomic<uint64_t> NumCleared{0}; // Events before this index are dropped by Clear()
+    UsdBridgeTraceSlot Slots[traceBufferCapacity];
+  };
+
+  // Buffers are kept alive after their thread exits, so its events can still be dumped.
+  struct UsdBridgeTraceRegistry
+  {
+    std::mutex BuffersMutex;
+    std::vector<std::unique_ptr<UsdBridgeTraceBuffer>> Buffers;
+  };
+
+  UsdBridgeTraceRegistry& GetTraceRegistry()
+  {
+    static UsdBridgeTraceRegistry registry;
+    return registry;
+  }
+
+  thread_local UsdBridgeTraceBuffer* LocalTraceBuffer = nullptr;
+
+  UsdBridgeTraceBuffer* CreateLocalTraceBuffer()
+  {
+    UsdBridgeTraceRegistry& registry = GetTraceRegistry();
+    std::lock_guard<std::mutex> lock(registry.BuffersMutex);
+
+    registry.Buffers.emplace_back(std::make_unique<UsdBridgeTraceBuffer>(registry.Buffers.size() + 1));
+    return registry.Buffers.back().get();
+  }
+}
+
+std::atomic<bool> UsdBridgeTrace::Enabled(false);
+
+int64_t UsdBridgeTrace::GetTimeUs()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void UsdBridgeTrace::RecordEvent(const char* name, int64_t startUs, int64_t durationUs)
+{
+  if (!LocalTraceBuffer)
+    LocalTraceBuffer = CreateLocalTraceBuffer();
+
+  UsdBridgeTraceBuffer* buffer = LocalTraceBuffer;
+  uint64_t eventIdx = buffer->NumWritten.load(std::memory_order_relaxed);
+  UsdBridgeTraceSlot& slot = buffer->Slots[eventIdx % traceBufferCapacity];
+
+  slot.Seq.store(2 * eventIdx + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.Name.store(name, std::memory_order_relaxed);
+  slot.StartUs.store(startUs, std::memory_order_relaxed);
+  slot.DurationUs.store(durationUs, std::memory_order_relaxed);
+  slot.Seq.store(2 * eventIdx + 2, std::memory_order_release);
+
+  buffer->NumWritten.store(eventIdx + 1, std::memory_order_release);
+}
+
+bool UsdBridgeTrace::Dump(const char* fileName)
+{
+  std::ofstream traceFile(fileName, std::ios_base::out | std::ios_base::trunc);
+  if (!traceFile.is_open())
+    return false;
+
+  traceFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+  bool firstEvent = true;
+  std::vector<UsdBridgeTraceEvent> snapshot;
+  UsdBridgeTraceRegistry& registry = GetTraceRegistry();
+  {
+    std::lock_guard<std::mutex> lock(registry.BuffersMutex);
+    for (const std::unique_ptr<UsdBridgeTraceBuffer>& buffer : registry.Buffers)
+    {
+      // Copy the retained events first, skipping the slots that the producer overwrote while they were read
+      snapshot.clear();
+      uint64_t numWritten = buffer->NumWritten.load(std::memory_order_acquire);
+      uint64_t firstIdx = numWritten > traceBufferCapacity ? numWritten - traceBufferCapacity : 0;
+      firstIdx = std::max(firstIdx, buffer->NumCleared.load(std::memory_order_relaxed));
+      for (uint64_t i = firstIdx; i < numWritten; ++i)
+      {
+        const UsdBridgeTraceSlot& slot = buffer->Slots[i % traceBufferCapacity];
+        uint64_t seq = slot.Seq.load(std::memory_order_acquire);
+        if (seq != 2 * i + 2)
+          continue;
+
+        UsdBridgeTraceEvent traceEvent;
+        traceEvent.Name = slot.Name.load(std::memory_order_relaxed);
+        traceEvent.StartUs = slot.StartUs.load(std::memory_order_relaxed);
+        traceEvent.DurationUs = slot.DurationUs.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.Seq.load(std::memory_order_relaxed) == seq)
+          snapshot.push_back(traceEvent);
+      }
+
+      for (const UsdBridgeTraceEvent& traceEvent : snapshot)
+      {
+        traceFile << (firstEvent ? "\n" : ",\n")
+          << "{\"name\":\"" << traceEvent.Name
+          << "\",\"cat\":\"usd\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->ThreadId
+          << ",\"ts\":" << traceEvent.StartUs
+          << ",\"dur\":" << traceEvent.DurationUs << "}";
+        firstEvent = false;
+      }
+    }
+  }
+
+  traceFile << "\n]}\n";
+
+  return traceFile.good();
+}
+
+void UsdBridgeTrace::Clear()
+{
+  UsdBridgeTraceRegistry& registry = GetTraceRegistry();
+  std::lock_guard<std::mutex> lock(registry.BuffersMutex);
+  for (const std::unique_ptr<UsdBridgeTraceBuffer>& buffer : registry.Buffers)
+    buffer->NumCleared.store(buffer->NumWritten.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
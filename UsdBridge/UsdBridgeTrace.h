@@ -0,0 +1,54 @@
+// Copyright 2020 The Khronos Group
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UsdBridgeTrace_h
+#define UsdBridgeTrace_h
+
+#include <atomic>
+#include <cstdint>
+
+// Scoped tracing of the bridge pipeline, output in Chrome trace event format (chrome://tracing, ui.perfetto.dev).
+// Events are recorded without locking into a fixed-size ring buffer per thread, so only the most recent events per thread are retained.
+// When tracing is disabled, a trace scope costs a single relaxed atomic load.
+class UsdBridgeTrace
+{
+  public:
+    static void SetEnabled(bool enabled) { Enabled.store(enabled, std::memory_order_relaxed); }
+    static bool IsEnabled() { return Enabled.load(std::memory_order_relaxed); }
+
+    static int64_t GetTimeUs();
+    static void RecordEvent(const char* name, int64_t startUs, int64_t durationUs);
+
+    // Writes all retained events as Chrome trace JSON. Safe to call while other threads are recording,
+    // events that are overwritten while being read are left out.
+    static bool Dump(const char* fileName);
+    static void Clear();
+
+  protected:
+    static std::atomic<bool> Enabled;
+};
+
+class UsdBridgeTraceScope
+{
+  public:
+    UsdBridgeTraceScope(const char* name)
+      : Name(UsdBridgeTrace::IsEnabled() ? name : nullptr)
+      , StartUs(Name ? UsdBridgeTrace::GetTimeUs() : 0)
+    {}
+
+    ~UsdBridgeTraceScope()
+    {
+      if (Name)
+        UsdBridgeTrace::RecordEvent(Name, StartUs, UsdBridgeTrace::GetTimeUs() - StartUs);
+    }
+
+  protected:
+    const char* Name; // Has to be a string literal, as only the pointer is stored
+    int64_t StartUs;
+};
+
+#define USDBRIDGE_TRACE_CONCAT_INNER(a, b) a##b
+#define USDBRIDGE_TRACE_CONCAT(a, b) USDBRIDGE_TRACE_CONCAT_INNER(a, b)
+#define USDBRIDGE_TRACE_SCOPE(name) UsdBridgeTraceScope USDBRIDGE_TRACE_CONCAT(usdBridgeTraceScope_, __LINE__)(name)
+
+#endif
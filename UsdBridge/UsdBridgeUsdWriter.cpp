@@ -6,10 +6,15 @@
 #include "UsdBridgeCaches.h"
 #include "UsdBridgeMdlStrings.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <iomanip>
+#include <limits>
 #include <fstream>
 #include <memory>
+#include <set>
+#include <unordered_set>
 
 #define UsdBridgeLogMacro(obj, level, message) \
   { std::stringstream logStream; \
@@ -44,6 +49,7 @@ TF_DEFINE_PRIVATE_TOKENS(
   // Volumes
   (density)
   (color)
+  (densityDelta)
 
   // Mdl
   (sourceAsset)
@@ -99,6 +105,11 @@ namespace
   const char* const mdlFolder = "mdls/";
   const char* const texFolder = "textures/";
   const char* const volFolder = "volumes/";
+  const char* const assetStoreFolder = "assetstore/";
+
+  // File names
+  const char* const sessionJournalFile = "SessionJournal.txt";
+  const char* const sessionJournalHeader = "UsdBridgeSessionJournal 1";
 
   // Postfixes for auto generated usd subprims
   const char* const texCoordReaderPrimPf = "texcoordreader";
@@ -106,6 +117,23 @@ namespace
   const char* const shaderPrimPf = "shader";
   const char* const mdlShaderPrimPf = "mdlshader";
   const char* const openVDBPrimPf = "ovdbfield";
+  const char* const openVDBDeltaPrimPf = "ovdbdelta";
+  const char* const openVDBLodPrimPf = "ovdblod";
+
+  SdfPath GetVolumeLodFieldPath(const SdfPath& volumePath, int lodLevel)
+  {
+    return volumePath.AppendPath(SdfPath(openVDBLodPrimPf + std::to_string(lodLevel)));
+  }
+
+  TfToken GetVolumeLodFieldToken(int lodLevel)
+  {
+    return TfToken(UsdBridgeTokens->density.GetString() + "Lod" + std::to_string(lodLevel));
+  }
+
+  int GetNumVolumeLodLevels(const UsdBridgeVolumeOutputSettings& outputSettings)
+  {
+    return std::max(0, std::min(outputSettings.LodLevels, UsdBridgeMaxVolumeLodLevels));
+  }
 
   TfToken GetTokenFromFieldType(UsdBridgeVolumeFieldType fieldType)
   {
@@ -243,21 +271,113 @@ namespace
     return prim;
   }
 
+  // Defers change processing until the end of its scope, if enabled. Only to be used around the authoring of values on existing
+  // prims and attributes, as composed queries of the stage (ie. GetPrimAtPath, AddTransformOp) do not see changes made within the scope.
+  class ChangeBlockScope
+  {
+  public:
+    ChangeBlockScope(bool enable)
+    {
+      if (enable)
+        ChangeBlock = std::make_unique<SdfChangeBlock>();
+    }
+
+  protected:
+    std::unique_ptr<SdfChangeBlock> ChangeBlock;
+  };
+
+  // Same result as UsdGeomXformable::ClearXformOpOrder() followed by AddTransformOp().Set(), but authored directly in the layer specs.
+  // Returns the spec path of the transform attribute.
+  SdfPath SetTransformSpec(const UsdStageRefPtr& stage, const SdfPath& primPath, const GfMatrix4d& transMat, const UsdTimeCode& timeCode)
+  {
+    static const TfToken transformOpName = UsdGeomXformOp::GetOpName(UsdGeomXformOp::TypeTransform);
+    static const VtValue xformOpOrder(VtTokenArray(1, transformOpName));
+
+    const UsdEditTarget& editTarget = stage->GetEditTarget();
+    SdfLayerHandle layer = editTarget.GetLayer();
+
+    SdfPath specPath = editTarget.MapToSpecPath(primPath);
+    SdfPrimSpecHandle primSpec = layer->GetPrimAtPath(specPath);
+    if (!primSpec)
+      primSpec = SdfCreatePrimInLayer(layer, specPath);
+
+    SdfAttributeSpecHandle orderSpec = layer->GetAttributeAtPath(specPath.AppendProperty(UsdGeomTokens->xformOpOrder));
+    if (!orderSpec)
+      orderSpec = SdfAttributeSpec::New(primSpec, UsdGeomTokens->xformOpOrder, SdfValueTypeNames->TokenArray, SdfVariabilityUniform);
+    if (orderSpec->GetDefaultValue() != xformOpOrder)
+      orderSpec->SetDefaultValue(xformOpOrder);
+
+    SdfPath transformPath = specPath.AppendProperty(transformOpName);
+    SdfAttributeSpecHandle transformSpec = layer->GetAttributeAtPath(transformPath);
+    if (!transformSpec)
+      transformSpec = SdfAttributeSpec::New(primSpec, transformOpName, SdfValueTypeNames->Matrix4d);
+
+    if (timeCode.IsDefault())
+      transformSpec->SetDefaultValue(VtValue(transMat));
+    else
+      layer->SetTimeSample(transformPath, timeCode.GetValue(), transMat);
+
+    return transformPath;
+  }
+
+  // Value authored at exactly timeCode, as opposed to held or interpolated from other samples
+  template<class T>
+  bool GetAuthoredValue(const UsdAttribute& attrib, const UsdTimeCode& timeCode, T& value)
+  {
+    if (timeCode.IsDefault())
+      return attrib.Get(&value, timeCode);
+
+    double lower, upper;
+    bool hasTimeSamples = false;
+    return attrib.GetBracketingTimeSamples(timeCode.GetValue(), &lower, &upper, &hasTimeSamples)
+      && hasTimeSamples && lower == timeCode.GetValue() && upper == lower
+      && attrib.Get(&value, timeCode);
+  }
+
+  // Gathers the elements of arrays with a byte stride between elements (ie. interleaved vertex buffers), stride 0 means tightly packed
+  template<class EltType>
+  class StridedArray
+  {
+  public:
+    StridedArray(const void* data, int64_t stride)
+      : Data(static_cast<const char*>(data))
+      , Stride(stride ? stride : (int64_t)sizeof(EltType))
+    {
+    }
+
+    bool IsPacked() const { return Stride == (int64_t)sizeof(EltType); }
+    const EltType* GetPacked() const { return reinterpret_cast<const EltType*>(Data); }
+    const EltType& operator[](size_t idx) const { return *reinterpret_cast<const EltType*>(Data + (int64_t)idx * Stride); }
+
+  protected:
+    const char* Data;
+    int64_t Stride;
+  };
+
   template<class ArrayType>
-  void AssignArrayToPrimvar(const void* data, size_t numElements, UsdAttribute& primvar, const UsdTimeCode& timeCode, ArrayType* usdArray)
+  void AssignArrayToPrimvar(const void* data, int64_t stride, size_t numElements, UsdAttribute& primvar, const UsdTimeCode& timeCode, ArrayType* usdArray)
   {
     using ElementType = typename ArrayType::ElementType;
-    ElementType* typedData = (ElementType*)data;
-    usdArray->assign(typedData, typedData + numElements);
+    StridedArray<ElementType> typedData(data, stride);
+    if (typedData.IsPacked())
+    {
+      usdArray->assign(typedData.GetPacked(), typedData.GetPacked() + numElements);
+    }
+    else
+    {
+      usdArray->resize(numElements);
+      for (size_t i = 0; i < numElements; ++i)
+        (*usdArray)[i] = typedData[i];
+    }
 
     primvar.Set(*usdArray, timeCode);
   }
 
   template<class ArrayType, class EltType>
-  void AssignArrayToPrimvarReduced(const void* data, size_t numElements, UsdAttribute& primvar, const UsdTimeCode& timeCode, ArrayType* usdArray)
+  void AssignArrayToPrimvarReduced(const void* data, int64_t stride, size_t numElements, UsdAttribute& primvar, const UsdTimeCode& timeCode, ArrayType* usdArray)
   {
     using ElementType = typename ArrayType::ElementType;
-    EltType* typedData = (EltType*)data;
+    StridedArray<EltType> typedData(data, stride);
 
     usdArray->resize(numElements);
     for (int i = 0; i < numElements; ++i)
@@ -270,10 +390,10 @@ namespace
   }
 
   template<class ArrayType, class EltType>
-  void AssignArrayToPrimvarConvert(const void* data, size_t numElements, UsdAttribute& primvar, const UsdTimeCode& timeCode, ArrayType* usdArray)
+  void AssignArrayToPrimvarConvert(const void* data, int64_t stride, size_t numElements, UsdAttribute& primvar, const UsdTimeCode& timeCode, ArrayType* usdArray)
   {
     using ElementType = typename ArrayType::ElementType;
-    EltType* typedData = (EltType*)data;
+    StridedArray<EltType> typedData(data, stride);
 
     usdArray->resize(numElements);
     for (int i = 0; i < numElements; ++i)
@@ -305,23 +425,80 @@ namespace
   }
 
   template<typename NormalsType>
-  void ConvertNormalsToQuaternions(VtQuathArray& quaternions, const void* normals, uint64_t numVertices)
+  void ConvertNormalsToQuaternions(VtQuathArray& quaternions, const void* normals, int64_t stride, uint64_t numVertices)
   {
     GfVec3f from(0.0f, 0.0f, 1.0f);
-    NormalsType* norms = (NormalsType*)(normals);
+    StridedArray<NormalsType[3]> norms(normals, stride);
     for (int i = 0; i < numVertices; ++i)
     {
-      GfVec3f to((float)(norms[i * 3]), (float)(norms[i * 3 + 1]), (float)(norms[i * 3 + 2]));
+      GfVec3f to((float)(norms[i][0]), (float)(norms[i][1]), (float)(norms[i][2]));
       GfRotation rot(from, to);
       const GfQuaternion& quat = rot.GetQuaternion();
       quaternions[i] = GfQuath((float)(quat.GetReal()), GfVec3h(quat.GetImaginary()));
     }
   }
 
+  // Bytes of the usd arrays that UpdateUsdGeometry authors for a data member, estimated from the element counts of the data
+  uint64_t ColorBytes(UsdBridgeType colorsType)
+  {
+    return (colorsType == UsdBridgeType::FLOAT4 || colorsType == UsdBridgeType::DOUBLE4) ? sizeof(GfVec4f) : sizeof(GfVec3f);
+  }
+
+  uint64_t GeomArrayBytes(const UsdBridgeMeshData& geomData, UsdBridgeMeshData::DataMemberId member)
+  {
+    typedef UsdBridgeMeshData::DataMemberId DMI;
+    uint64_t numPrims = geomData.FaceVertexCount ? geomData.NumIndices / geomData.FaceVertexCount : 0;
+    switch (member)
+    {
+    case DMI::POINTS: return (geomData.NumPoints + 2) * sizeof(GfVec3f); // Including extent
+    case DMI::NORMALS: return geomData.Normals ? (geomData.PerPrimNormals ? numPrims : geomData.NumPoints) * sizeof(GfVec3f) : 0;
+    case DMI::TEXCOORDS: return geomData.TexCoords ? (geomData.PerPrimTexCoords ? numPrims : geomData.NumPoints) * sizeof(GfVec2f) : 0;
+    case DMI::COLORS: return geomData.Colors ? (geomData.PerPrimColors ? numPrims : geomData.NumPoints) * ColorBytes(geomData.ColorsType) : 0;
+    case DMI::INDICES: return (geomData.NumIndices + numPrims) * sizeof(int); // Including face vertex counts
+    default: return 0;
+    }
+  }
+
+  uint64_t GeomArrayBytes(const UsdBridgeInstancerData& geomData, UsdBridgeInstancerData::DataMemberId member)
+  {
+    typedef UsdBridgeInstancerData::DataMemberId DMI;
+    uint64_t numPoints = geomData.NumPoints;
+    switch (member)
+    {
+    case DMI::POINTS: return (numPoints + 2) * sizeof(GfVec3f); // Including extent
+    case DMI::SHAPEINDICES: return numPoints * sizeof(int);
+    case DMI::SCALES: return numPoints * sizeof(GfVec3f);
+    case DMI::ORIENTATIONS: return geomData.Orientations ? numPoints * sizeof(GfQuath) : 0;
+    case DMI::LINEARVELOCITIES: return geomData.LinearVelocities ? numPoints * sizeof(GfVec3f) : 0;
+    case DMI::ANGULARVELOCITIES: return geomData.AngularVelocities ? numPoints * sizeof(GfVec3f) : 0;
+    case DMI::INSTANCEIDS: return geomData.InstanceIds ? numPoints * sizeof(int64_t) : 0;
+    case DMI::TEXCOORDS: return geomData.TexCoords ? numPoints * sizeof(GfVec2f) : 0;
+    case DMI::COLORS: return geomData.Colors ? numPoints * ColorBytes(geomData.ColorsType) : 0;
+    case DMI::INVISIBLEIDS: return geomData.InvisibleIds ? geomData.NumInvisibleIds * sizeof(int64_t) : 0;
+    default: return 0;
+    }
+  }
+
+  uint64_t GeomArrayBytes(const UsdBridgeCurveData& geomData, UsdBridgeCurveData::DataMemberId member)
+  {
+    typedef UsdBridgeCurveData::DataMemberId DMI;
+    uint64_t numPrims = geomData.NumCurveLengths;
+    switch (member)
+    {
+    case DMI::POINTS: return (geomData.NumPoints + 2) * sizeof(GfVec3f); // Including extent
+    case DMI::NORMALS: return geomData.Normals ? (geomData.PerPrimNormals ? numPrims : geomData.NumPoints) * sizeof(GfVec3f) : 0;
+    case DMI::SCALES: return geomData.Scales ? geomData.NumPoints * sizeof(float) : 0;
+    case DMI::TEXCOORDS: return geomData.TexCoords ? (geomData.PerPrimTexCoords ? numPrims : geomData.NumPoints) * sizeof(GfVec2f) : 0;
+    case DMI::COLORS: return geomData.Colors ? (geomData.PerPrimColors ? numPrims : geomData.NumPoints) * ColorBytes(geomData.ColorsType) : 0;
+    case DMI::CURVELENGTHS: return numPrims * sizeof(int);
+    default: return 0;
+    }
+  }
+
   template<typename OutputArrayType, typename InputEltType>
-  void ExpandToVec3(OutputArrayType& output, const void* input, uint64_t numElements)
+  void ExpandToVec3(OutputArrayType& output, const void* input, int64_t stride, uint64_t numElements)
   {
-    const InputEltType* typedInput = reinterpret_cast<const InputEltType*>(input);
+    StridedArray<InputEltType> typedInput(input, stride);
     for (int i = 0; i < numElements; ++i)
     {
       output[i] = typename OutputArrayType::ElementType(typedInput[i], typedInput[i], typedInput[i]);
@@ -330,28 +507,40 @@ namespace
 }
 
 #define ASSIGN_ARRAY_TO_PRIMVAR_MACRO(ArrayType) \
-  ArrayType usdArray; AssignArrayToPrimvar<ArrayType>(arrayData, arrayNumElements, arrayPrimvar, timeCode, &usdArray)
+  ArrayType usdArray; AssignArrayToPrimvar<ArrayType>(arrayData, arrayStride, arrayNumElements, arrayPrimvar, timeCode, &usdArray)
 #define ASSIGN_ARRAY_TO_PRIMVAR_REDUCED_MACRO(ArrayType, EltType) \
-  ArrayType usdArray; AssignArrayToPrimvarReduced<ArrayType, EltType>(arrayData, arrayNumElements, arrayPrimvar, timeCode, &usdArray)
+  ArrayType usdArray; AssignArrayToPrimvarReduced<ArrayType, EltType>(arrayData, arrayStride, arrayNumElements, arrayPrimvar, timeCode, &usdArray)
 #define ASSIGN_ARRAY_TO_PRIMVAR_CONVERT_MACRO(ArrayType, EltType) \
-  ArrayType usdArray; AssignArrayToPrimvarConvert<ArrayType, EltType>(arrayData, arrayNumElements, arrayPrimvar, timeCode, &usdArray)
+  ArrayType usdArray; AssignArrayToPrimvarConvert<ArrayType, EltType>(arrayData, arrayStride, arrayNumElements, arrayPrimvar, timeCode, &usdArray)
 #define ASSIGN_CUSTOM_ARRAY_TO_PRIMVAR_MACRO(ArrayType, customArray) \
-  AssignArrayToPrimvar<ArrayType>(arrayData, arrayNumElements, arrayPrimvar, timeCode, &customArray)
+  AssignArrayToPrimvar<ArrayType>(arrayData, arrayStride, arrayNumElements, arrayPrimvar, timeCode, &customArray)
 #define ASSIGN_CUSTOM_ARRAY_TO_PRIMVAR_CONVERT_MACRO(ArrayType, EltType, customArray) \
-  AssignArrayToPrimvarConvert<ArrayType, EltType>(arrayData, arrayNumElements, arrayPrimvar, timeCode, &customArray)
+  AssignArrayToPrimvarConvert<ArrayType, EltType>(arrayData, arrayStride, arrayNumElements, arrayPrimvar, timeCode, &customArray)
 #define ASSIGN_ARRAY_TO_PRIMVAR_MACRO_EXPAND3(ArrayType, EltType, tempArray) \
-  tempArray.resize(arrayNumElements); ExpandToVec3<ArrayType, EltType>(tempArray, arrayData, arrayNumElements); arrayPrimvar.Set(tempArray, timeCode);
+  tempArray.resize(arrayNumElements); ExpandToVec3<ArrayType, EltType>(tempArray, arrayData, arrayStride, arrayNumElements); arrayPrimvar.Set(tempArray, timeCode);
 
 UsdBridgeUsdWriter::UsdBridgeUsdWriter(const UsdBridgeSettings& settings)
   : Settings(settings)
 {
   ConnectionSettings.HostName = Settings.HostName;
   ConnectionSettings.WorkingDirectory = Settings.OutputPath;
+  ConnectionSettings.DirectIO = Settings.DirectIO;
+  ConnectionSettings.SyncPolicy = Settings.SyncPolicy;
   FormatDirName(ConnectionSettings.WorkingDirectory);
+
+  TimeLayout = Settings.TimeLayout;
+#ifndef TIME_CLIP_STAGES
+  if (TimeLayout == UsdBridgeTimeLayout::CLIP_STAGES)
+    TimeLayout = UsdBridgeTimeLayout::PRIM_STAGES;
+#endif
+#ifndef VALUE_CLIP_RETIMING
+  TimeLayout = UsdBridgeTimeLayout::SCENE_STAGE;
+#endif
 }
 
 UsdBridgeUsdWriter::~UsdBridgeUsdWriter()
 {
+  FlushStageSaves();
 }
 
 void UsdBridgeUsdWriter::SetSceneStage(UsdStageRefPtr sceneStage)
@@ -364,6 +553,33 @@ void UsdBridgeUsdWriter::SetEnableSaving(bool enableSaving)
   this->EnableSaving = enableSaving;
 }
 
+void UsdBridgeUsdWriter::SetBatchChanges(bool batchChanges)
+{
+  this->BatchChanges = batchChanges;
+}
+
+void UsdBridgeUsdWriter::SetParallelWrites(bool parallelWrites)
+{
+  if (!parallelWrites)
+    FlushStageSaves();
+  this->ParallelWrites = parallelWrites;
+}
+
+void UsdBridgeUsdWriter::SetMemoryBudget(uint64_t budgetMB)
+{
+  this->MemoryBudgetBytes = budgetMB << 20;
+
+  if (this->MemoryBudgetBytes && !UsesClipStages())
+  {
+    UsdBridgeLogMacro(this, UsdBridgeLogLevel::WARNING, "The memory budget only bounds clip stages, which the time layout of this session doesn't use; its timevarying data is accounted but not bounded.");
+  }
+}
+
+void UsdBridgeUsdWriter::SetTimeSampleTolerance(double tolerance)
+{
+  this->TimeSampleCompactor.SetTolerance(tolerance);
+}
+
 int UsdBridgeUsdWriter::FindSessionNumber()
 {
   int sessionNr = Connect->MaxSessionNr();
@@ -379,22 +595,26 @@ bool UsdBridgeUsdWriter::CreateDirectories()
 
   valid = Connect->CreateFolder("", true);
 
-  Connect->RemoveFolder(SessionDirectory.c_str());
-  valid = valid && Connect->CreateFolder(SessionDirectory.c_str(), false);
+  bool mayExist = ResumeSession;
+  if (!ResumeSession)
+    Connect->RemoveFolder(SessionDirectory.c_str());
+  valid = valid && Connect->CreateFolder(SessionDirectory.c_str(), mayExist);
 
-#ifdef VALUE_CLIP_RETIMING
-  valid = valid && Connect->CreateFolder((SessionDirectory + manifestFolder).c_str(), false);
-  valid = valid && Connect->CreateFolder((SessionDirectory + primStageFolder).c_str(), false);
-#endif
-#ifdef TIME_CLIP_STAGES
-  valid = valid && Connect->CreateFolder((SessionDirectory + clipFolder).c_str(), false);
-#endif
+  if (UsesPrimStages())
+  {
+    valid = valid && Connect->CreateFolder((SessionDirectory + manifestFolder).c_str(), mayExist);
+    valid = valid && Connect->CreateFolder((SessionDirectory + primStageFolder).c_str(), mayExist);
+  }
+  if (UsesClipStages())
+    valid = valid && Connect->CreateFolder((SessionDirectory + clipFolder).c_str(), mayExist);
 #ifdef SUPPORT_MDL_SHADERS
-  valid = valid && Connect->CreateFolder((SessionDirectory + mdlFolder).c_str(), false);
+  valid = valid && Connect->CreateFolder((SessionDirectory + mdlFolder).c_str(), mayExist);
 #endif
 #ifdef USE_OPENVDB
-  valid = valid && Connect->CreateFolder((SessionDirectory + volFolder).c_str(), false);
+  valid = valid && Connect->CreateFolder((SessionDirectory + volFolder).c_str(), mayExist);
 #endif
+  if (Settings.DedupAssets)
+    valid = valid && Connect->CreateFolder((SessionDirectory + assetStoreFolder).c_str(), mayExist);
 
   if (!valid)
   {
@@ -407,16 +627,12 @@ bool UsdBridgeUsdWriter::CreateDirectories()
 #ifdef SUPPORT_MDL_SHADERS 
 void WriteMdlFromStrings(const char* string0, const char* string1, const char* fileName, const UsdBridgeConnection* Connect)
 {
-  size_t strLen0 = std::strlen(string0);
-  size_t strLen1 = std::strlen(string1);
-  size_t totalStrLen = strLen0 + strLen1;
-  char* Mdl_Contents = new char[totalStrLen];
-  std::memcpy(Mdl_Contents, string0, strLen0);
-  std::memcpy(Mdl_Contents + strLen0, string1, strLen1);
-
-  Connect->WriteFile(Mdl_Contents, totalStrLen, fileName, false);
+  UsdBridgeWriteRange mdlContents[2] = {
+    { string0, std::strlen(string0) },
+    { string1, std::strlen(string1) }
+  };
 
-  delete[] Mdl_Contents;
+  Connect->WriteFileGather(mdlContents, 2, fileName, false);
 }
 
 bool UsdBridgeUsdWriter::CreateMdlFiles()
@@ -444,6 +660,8 @@ bool UsdBridgeUsdWriter::CreateMdlFiles()
 
 bool UsdBridgeUsdWriter::InitializeSession()
 {
+  FileRemover = nullptr; // Finishes its removals with the previous connection
+
   if (ConnectionSettings.HostName.empty())
   {
     if(ConnectionSettings.WorkingDirectory.compare("void") == 0)
@@ -455,15 +673,28 @@ bool UsdBridgeUsdWriter::InitializeSession()
     Connect = std::make_unique<UsdBridgeRemoteConnection>();
 
   Connect->Initialize(ConnectionSettings, this->LogCallback, this->LogUserData);
+  FileRemover = std::make_unique<UsdBridgeFileRemover>(Connect.get());
 
   SessionNumber = FindSessionNumber();
   SessionDirectory = "Session_" + std::to_string(SessionNumber) + "/";
 
+  // Re-using the last session picks up at its last consistent timestep, if it has one
+  ResumeSession = !Settings.CreateNewSession && ReadSessionJournal();
+  if (ResumeSession)
+  {
+    UsdBridgeLogMacro(this, UsdBridgeLogLevel::STATUS, "Resuming " << SessionDirectory << " after timestep " << ResumeTimeStep);
+  }
+
   bool valid = true;
 
   valid = CreateDirectories();
 
-  valid = valid && VolumeWriter.Initialize(this->LogCallback, this->LogUserData);
+  if (Settings.DedupAssets)
+    AssetStore = std::make_unique<UsdBridgeAssetStore>(Connect.get(), SessionDirectory, assetStoreFolder);
+  if (Settings.VolumeOutput.BrickDeltas)
+    VolumeBricks = std::make_unique<UsdBridgeVolumeBrickTracker>();
+
+  valid = valid && VolumeWriter.Initialize(Settings.VolumeOutput, this->LogCallback, this->LogUserData);
 
 #ifdef SUPPORT_MDL_SHADERS 
   valid = valid && CreateMdlFiles();
@@ -474,8 +705,158 @@ bool UsdBridgeUsdWriter::InitializeSession()
 
 void UsdBridgeUsdWriter::ResetSession()
 {
+  FlushStageSaves();
+  TimeVarFootprints.clear();
+  ResidentClipsBySize.clear();
+  TimeVarBytes = 0;
+
   this->SessionNumber = -1;
   this->SceneStage = nullptr;
+  this->ResumeSession = false;
+  this->SavesFailed = false;
+  this->AssetStore = nullptr;
+  this->VolumeBricks = nullptr;
+  this->FileRemover = nullptr;
+}
+
+bool UsdBridgeUsdWriter::ReadSessionJournal()
+{
+  std::string journalContents;
+  if (!Connect->ReadFile((SessionDirectory + sessionJournalFile).c_str(), journalContents))
+    return false;
+
+  std::istringstream journal(journalContents);
+  std::string line;
+  if (!std::getline(journal, line) || line != sessionJournalHeader)
+  {
+    UsdBridgeLogMacro(this, UsdBridgeLogLevel::WARNING, "Session journal of " << SessionDirectory << " is invalid, session cannot be resumed.");
+    return false;
+  }
+
+  bool hasTimeStep = false;
+  std::string key;
+  double value;
+  while (journal >> key >> value)
+  {
+    if (key == "timestep")
+    {
+      ResumeTimeStep = value;
+      hasTimeStep = true;
+    }
+    else if (key == "starttime")
+      StartTime = value;
+    else if (key == "endtime")
+      EndTime = value;
+  }
+
+  return hasTimeStep;
+}
+
+bool UsdBridgeUsdWriter::CommitSessionJournal(double savedTimeStep)
+{
+  // A journaled timestep must not refer to output that failed to save, or that is still in flight
+  bool saved = !SavesFailed;
+  SavesFailed = false;
+  bool synced = saved && Connect->SyncOutput();
+
+  std::ostringstream journal;
+  journal.precision(17);
+  journal << sessionJournalHeader << "\n"
+    << "timestep " << savedTimeStep << "\n"
+    << "starttime " << StartTime << "\n"
+    << "endtime " << EndTime << "\n";
+  std::string journalContents = journal.str();
+
+  bool written = synced && Connect->WriteFile(journalContents.c_str(), journalContents.length(),
+    (SessionDirectory + sessionJournalFile).c_str(), false);
+  if (!written)
+  {
+    UsdBridgeLogMacro(this, UsdBridgeLogLevel::WARNING, "Session journal could not be updated for timestep " << savedTimeStep
+      << (saved ? "" : ", as not all stages were saved"));
+  }
+
+  return written;
+}
+
+void UsdBridgeUsdWriter::TruncateResumedLayer(const SdfLayerHandle& layer)
+{
+  // Samples after the journaled timestep were written by the interrupted run, but not confirmed as saved
+  std::vector<SdfPath> attribPaths;
+  layer->Traverse(SdfPath::AbsoluteRootPath(), [&layer, &attribPaths](const SdfPath& path)
+  {
+    if (path.IsPropertyPath() && layer->GetAttributeAtPath(path))
+      attribPaths.push_back(path);
+  });
+
+  for (const SdfPath& attribPath : attribPaths)
+  {
+    for (double timeSample : layer->ListTimeSamplesForPath(attribPath))
+    {
+      if (timeSample > ResumeTimeStep)
+        layer->EraseTimeSample(attribPath, timeSample);
+    }
+  }
+}
+
+void UsdBridgeUsdWriter::TruncateResumedClips()
+{
+  // Clips activated after the journaled timestep are deactivated, and their files removed unless still active before it
+  std::set<std::string> keptClips;
+  std::set<std::string> droppedClips;
+  for (const UsdPrim& prim : this->SceneStage->TraverseAll())
+  {
+    UsdClipsAPI clipsApi(prim);
+    VtVec2dArray clipActives;
+    VtArray<SdfAssetPath> assetPaths;
+    if (!clipsApi.GetClipActive(&clipActives) || !clipsApi.GetClipAssetPaths(&assetPaths))
+      continue;
+
+    VtVec2dArray clipTimes;
+    clipsApi.GetClipTimes(&clipTimes);
+
+    VtVec2dArray keptActives;
+    std::vector<bool> assetKept(assetPaths.size(), false);
+    for (const GfVec2d& clipActive : clipActives)
+    {
+      size_t assetIdx = size_t(clipActive[1]);
+      if (clipActive[0] <= ResumeTimeStep)
+      {
+        keptActives.push_back(clipActive);
+        if (assetIdx < assetKept.size())
+          assetKept[assetIdx] = true;
+      }
+    }
+    if (keptActives.size() == clipActives.size())
+      continue;
+
+    VtVec2dArray keptTimes;
+    for (const GfVec2d& clipTime : clipTimes)
+    {
+      if (clipTime[0] <= ResumeTimeStep)
+        keptTimes.push_back(clipTime);
+    }
+    clipsApi.SetClipActive(keptActives);
+    clipsApi.SetClipTimes(keptTimes);
+
+    for (size_t i = 0; i < assetPaths.size(); ++i)
+      (assetKept[i] ? keptClips : droppedClips).insert(assetPaths[i].GetAssetPath());
+  }
+
+  // Prim stages are also referenced as clips without clip stages, so only files in the clip folder are removed
+  for (const std::string& clipPath : droppedClips)
+  {
+    if (!keptClips.count(clipPath) && clipPath.compare(0, std::strlen(clipFolder), clipFolder) == 0)
+      Connect->RemoveFile((this->SessionDirectory + clipPath).c_str());
+  }
+}
+
+bool UsdBridgeUsdWriter::GetResumeTimeStep(double& timeStep) const
+{
+  if (!ResumeSession)
+    return false;
+
+  timeStep = ResumeTimeStep;
+  return true;
 }
 
 bool UsdBridgeUsdWriter::OpenSceneStage()
@@ -487,6 +868,15 @@ bool UsdBridgeUsdWriter::OpenSceneStage()
   this->RelativeSceneFile = "../" + SceneFile;
 
   const char* absSceneFile = Connect->GetUrl(this->SceneFileName.c_str());
+  if(!this->SceneStage && this->ResumeSession)
+  {
+    this->SceneStage = UsdStage::Open(absSceneFile);
+    if (this->SceneStage)
+    {
+      TruncateResumedLayer(this->SceneStage->GetRootLayer());
+      TruncateResumedClips();
+    }
+  }
   if(!this->SceneStage)
     this->SceneStage = UsdStage::CreateNew(absSceneFile);
 
@@ -519,6 +909,12 @@ bool UsdBridgeUsdWriter::OpenSceneStage()
   return true;
 }
 
+void UsdBridgeUsdWriter::SaveSceneStage()
+{
+  if (!this->SceneStage->GetRootLayer()->Save())
+    SavesFailed = true;
+}
+
 UsdStageRefPtr UsdBridgeUsdWriter::GetSceneStage()
 {
   return this->SceneStage;
@@ -531,29 +927,64 @@ StageCreatePair UsdBridgeUsdWriter::GetTimeVarStage(UsdBridgePrimCache* cache
   )
 {
 #ifdef VALUE_CLIP_RETIMING
-#ifdef TIME_CLIP_STAGES
-  if (useClipStage)
+  if (UsesPrimStages())
   {
-    bool exists;
-    UsdStageRefPtr primStage = this->FindOrCreatePrimClipStage(cache, clipPf, timeStep, exists).second;
-
-    SdfPath rootPrimPath(this->RootClassName);
-    assert(!exists == !primStage->GetPrimAtPath(rootPrimPath));
-    if (!exists)
+#ifdef TIME_CLIP_STAGES
+    if (useClipStage && UsesClipStages())
     {
-      primStage->DefinePrim(rootPrimPath);
-    }
+      bool exists;
+      UsdStageRefPtr primStage = this->FindOrCreatePrimClipStage(cache, clipPf, timeStep, exists).second;
 
-    return StageCreatePair(primStage, !exists);
-  }
-  else
+      // New clip stages hold the prim as declared by the manifest, unless the manifest lacks it, or has since
+      // declared members which the clip was not copied with
+      SdfPrimSpecHandle clipSpec = primStage->GetRootLayer()->GetPrimAtPath(cache->PrimPath);
+      SdfPrimSpecHandle manifestSpec = cache->PrimStage.second->GetRootLayer()->GetPrimAtPath(cache->PrimPath);
+      bool initialize = !clipSpec || (manifestSpec && clipSpec->GetProperties().size() < manifestSpec->GetProperties().size());
+
+      return StageCreatePair(primStage, initialize);
+    }
+#endif
     return StageCreatePair(cache->PrimStage.second, false);
-#else
-  return StageCreatePair(cache->PrimStage.second, false);
+  }
 #endif
-#else
   return StageCreatePair(this->SceneStage, false);
-#endif
+}
+
+void UsdBridgeUsdWriter::SaveTimeVarStage(const UsdStageRefPtr& timeVarStage)
+{
+  if (this->ParallelWrites)
+  {
+    SdfLayerRefPtr rootLayer = timeVarStage->GetRootLayer();
+    DeferredLayerSaves.emplace(get_pointer(rootLayer), rootLayer);
+  }
+  else if (!timeVarStage->GetRootLayer()->Save())
+    SavesFailed = true;
+}
+
+void UsdBridgeUsdWriter::FlushStageSaves()
+{
+  if (DeferredLayerSaves.empty())
+    return;
+
+  std::vector<SdfLayerHandle> layers;
+  layers.reserve(DeferredLayerSaves.size());
+  for (const auto& layerEntry : DeferredLayerSaves)
+    layers.push_back(layerEntry.second);
+
+  // Prim and clip stages consist of a single layer that is not shared with any other stage, so each layer can be written by another thread
+  std::atomic<bool> savesFailed(false);
+  WorkParallelForN(layers.size(),
+    [&layers, &savesFailed](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        if (!layers[i]->Save())
+          savesFailed.store(true, std::memory_order_relaxed);
+      }
+    });
+  SavesFailed = SavesFailed || savesFailed.load();
+
+  DeferredLayerSaves.clear();
 }
 
 #ifdef VALUE_CLIP_RETIMING
@@ -563,9 +994,19 @@ void UsdBridgeUsdWriter::OpenPrimStage(const char* name, const char* primPostfix
 
   cacheEntry->PrimStage.first = (isManifest ? manifestFolder : primStageFolder) + std::string(name) + primPostfix + (binary ? ".usd" : ".usda");
 
-  std::string absoluteFileName = Connect->GetUrl((this->SessionDirectory + cacheEntry->PrimStage.first).c_str());
+  std::string relativeFileName = this->SessionDirectory + cacheEntry->PrimStage.first;
+  FileRemover->CancelRemoval(relativeFileName); // From a garbage collected prim with the same name
+  std::string absoluteFileName = Connect->GetUrl(relativeFileName.c_str());
 
-  cacheEntry->PrimStage.second = UsdStage::CreateNew(absoluteFileName);
+  // A resumed session continues the time samples of existing prim stages
+  if (this->ResumeSession)
+  {
+    cacheEntry->PrimStage.second = UsdStage::Open(absoluteFileName);
+    if (cacheEntry->PrimStage.second)
+      TruncateResumedLayer(cacheEntry->PrimStage.second->GetRootLayer());
+  }
+  if (!cacheEntry->PrimStage.second)
+    cacheEntry->PrimStage.second = UsdStage::CreateNew(absoluteFileName);
   if (!cacheEntry->PrimStage.second)
     cacheEntry->PrimStage.second = UsdStage::Open(absoluteFileName);
 
@@ -588,16 +1029,22 @@ void UsdBridgeUsdWriter::RemovePrimStage(const UsdBridgePrimCache* cacheEntry)
   // May be superfluous
   assert(cacheEntry->PrimStage.second);
   cacheEntry->PrimStage.second->RemovePrim(SdfPath(RootClassName));
+  DeferredLayerSaves.erase(get_pointer(cacheEntry->PrimStage.second->GetRootLayer()));
 
   // Remove Primstage file itself
   assert(!cacheEntry->PrimStage.first.empty());
-  Connect->RemoveFile((SessionDirectory + cacheEntry->PrimStage.first).c_str());
+  FileRemover->RemoveFile(SessionDirectory + cacheEntry->PrimStage.first);
 
 #ifdef TIME_CLIP_STAGES
   // remove all clipstage files
   for (auto& x : cacheEntry->ClipStages)
   {
-    Connect->RemoveFile((SessionDirectory + x.second.first).c_str());
+    // A released clip stage may still await its deferred save
+    SdfLayerHandle clipLayer = x.second.second ? x.second.second->GetRootLayer()
+      : SdfLayer::Find(Connect->GetUrl((SessionDirectory + x.second.first).c_str()));
+    if (clipLayer)
+      DeferredLayerSaves.erase(get_pointer(clipLayer));
+    FileRemover->RemoveFile(SessionDirectory + x.second.first);
   }
 #endif
 }
@@ -774,23 +1221,171 @@ const UsdStagePair& UsdBridgeUsdWriter::FindOrCreatePrimClipStage(UsdBridgePrimC
   bool binary = this->Settings.BinaryOutput;
 
   auto it = cacheEntry->ClipStages.find(timeStep);
-  if (it == cacheEntry->ClipStages.end())
+  if (it != cacheEntry->ClipStages.end() && !it->second.second)
+  {
+    // Reopen a released clip; crate files are memory-mapped, so its arrays are paged in from the file only when read
+    std::string absoluteFileName = Connect->GetUrl((this->SessionDirectory + it->second.first).c_str());
+    it->second.second = UsdStage::Open(absoluteFileName);
+    assert(it->second.second);
+  }
+  else if (it == cacheEntry->ClipStages.end())
   {
     // Create a new Clipstage
     std::string relativeFileName = clipFolder + cacheEntry->Name.GetString() + clipPostfix + std::to_string(timeStep) + (binary ? ".usd" : ".usda");
-    std::string absoluteFileName = Connect->GetUrl((this->SessionDirectory + relativeFileName).c_str());
+    std::string sessionFileName = this->SessionDirectory + relativeFileName;
+    FileRemover->CancelRemoval(sessionFileName);
+    std::string absoluteFileName = Connect->GetUrl(sessionFileName.c_str());
+
+    // The clip layer is built at the Sdf level, with the specs of the manifest (see CreateUsdGeometryManifest) copied in one go,
+    // so the stage opened on it is composed once, instead of after each prim and attribute definition. Unlike SdfLayer::CreateNew,
+    // the layer is not written out before its first save.
+    SdfLayerRefPtr clipLayer = SdfLayer::New(SdfFileFormat::FindByExtension(absoluteFileName), absoluteFileName);
+    assert(clipLayer);
+
+    SdfPath rootClassPath(this->RootClassName);
+    SdfLayerHandle manifestLayer = cacheEntry->PrimStage.second->GetRootLayer();
+    if (manifestLayer->GetPrimAtPath(rootClassPath))
+      SdfCopySpec(manifestLayer, rootClassPath, clipLayer, rootClassPath);
+    else
+      SdfPrimSpec::New(clipLayer->GetPseudoRoot(), rootClassPath.GetName(), SdfSpecifierDef);
 
-    UsdStageRefPtr clipStage = UsdStage::CreateNew(absoluteFileName);
+    UsdStageRefPtr clipStage = UsdStage::Open(clipLayer);
     exists = !clipStage;
-    //if (exists = !clipStage)
-    //  clipStage = UsdStage::Open(absoluteFileName); //unlikely to happen, as we could not find timestep in clipstages. Test if this should be removed
     assert(clipStage);
 
     it = cacheEntry->ClipStages.emplace(timeStep, UsdStagePair(std::move(relativeFileName), clipStage)).first;
   }
   return it->second;
 }
+
+const std::string& UsdBridgeUsdWriter::FindOrCreatePrimClipFileName(UsdBridgePrimCache* cacheEntry, const char* clipPostfix, double timeStep, bool& exists)
+{
+  // Referencing a clip only requires its file name, so released clips stay on disk until an update authors into them
+  auto it = cacheEntry->ClipStages.find(timeStep);
+  if (it != cacheEntry->ClipStages.end())
+  {
+    exists = true;
+    return it->second.first;
+  }
+  return FindOrCreatePrimClipStage(cacheEntry, clipPostfix, timeStep, exists).first;
+}
+
+void UsdBridgeUsdWriter::ReleasePrimClipStage(UsdBridgePrimCache* cacheEntry, double timeStep)
+{
+  if (!this->Settings.MappedArrays || !this->Settings.BinaryOutput || !UsesClipStages())
+    return;
+
+  // A deferred save keeps the layer alive until FlushStageSaves(), reopening it before then finds the same layer
+  auto it = cacheEntry->ClipStages.find(timeStep);
+  if (it != cacheEntry->ClipStages.end())
+    it->second.second.Reset();
+}
+#endif
+
+template<typename GeomDataType>
+void UsdBridgeUsdWriter::UpdateTimeVarFootprintTemplate(UsdBridgePrimCache* cacheEntry, const GeomDataType& geomData, double timeStep)
+{
+  typedef typename GeomDataType::DataMemberId DMI;
+  TimeVarKey key(cacheEntry, timeStep);
+
+  bool isClip = false;
+#ifdef TIME_CLIP_STAGES
+  if (UsesClipStages())
+  {
+    // A released clip only holds memory-mapped arrays, which are paged in from its file when read
+    auto clipIt = cacheEntry->ClipStages.find(timeStep);
+    if (clipIt == cacheEntry->ClipStages.end() || !clipIt->second.second)
+    {
+      RemoveTimeVarFootprint(key);
+      return;
+    }
+    isClip = true;
+  }
+#endif
+
+  // The arrays of members that are updated as uniform are cleared from the timestep
+  TimeVarFootprint& footprint = TimeVarFootprints[key];
+  uint64_t prevNumBytes = footprint.NumBytes;
+  uint32_t updates = static_cast<uint32_t>(geomData.UpdatesToPerform);
+  uint32_t timeVarying = static_cast<uint32_t>(geomData.TimeVarying);
+  for (uint32_t member = 1; member < static_cast<uint32_t>(DMI::ALL); member <<= 1)
+  {
+    if (!(updates & member))
+      continue;
+    uint64_t& memberBytes = footprint.MemberBytes[member];
+    footprint.NumBytes -= memberBytes;
+    memberBytes = (timeVarying & member) ? GeomArrayBytes(geomData, static_cast<DMI>(member)) : 0;
+    footprint.NumBytes += memberBytes;
+  }
+  TimeVarBytes = TimeVarBytes - prevNumBytes + footprint.NumBytes;
+
+  if (isClip)
+    ResidentClipsBySize.erase(std::make_pair(prevNumBytes, key));
+  if (!footprint.NumBytes)
+    TimeVarFootprints.erase(key);
+  else if (isClip)
+    ResidentClipsBySize.emplace(footprint.NumBytes, key);
+
+#ifdef TIME_CLIP_STAGES
+  // Spilling requires the clips to be saved; they are reopened by FindOrCreatePrimClipStage() when updated again
+  if (!this->MemoryBudgetBytes || !this->EnableSaving)
+    return;
+
+  while (TimeVarBytes > this->MemoryBudgetBytes && !ResidentClipsBySize.empty())
+  {
+    TimeVarKey largestKey = std::prev(ResidentClipsBySize.end())->second;
+
+    UsdStagePair& clipStage = largestKey.first->ClipStages[largestKey.second];
+    if (clipStage.second)
+    {
+      SdfLayerHandle clipLayer = clipStage.second->GetRootLayer();
+      DeferredLayerSaves.erase(get_pointer(clipLayer));
+      clipLayer->Save();
+      clipStage.second.Reset();
+    }
+
+    RemoveTimeVarFootprint(largestKey);
+  }
 #endif
+}
+
+void UsdBridgeUsdWriter::UpdateTimeVarFootprint(UsdBridgePrimCache* cacheEntry, const UsdBridgeMeshData& geomData, double timeStep)
+{
+  UpdateTimeVarFootprintTemplate(cacheEntry, geomData, timeStep);
+}
+
+void UsdBridgeUsdWriter::UpdateTimeVarFootprint(UsdBridgePrimCache* cacheEntry, const UsdBridgeInstancerData& geomData, double timeStep)
+{
+  UpdateTimeVarFootprintTemplate(cacheEntry, geomData, timeStep);
+}
+
+void UsdBridgeUsdWriter::UpdateTimeVarFootprint(UsdBridgePrimCache* cacheEntry, const UsdBridgeCurveData& geomData, double timeStep)
+{
+  UpdateTimeVarFootprintTemplate(cacheEntry, geomData, timeStep);
+}
+
+void UsdBridgeUsdWriter::RemoveTimeVarFootprint(const TimeVarKey& key)
+{
+  auto footprintIt = TimeVarFootprints.find(key);
+  if (footprintIt == TimeVarFootprints.end())
+    return;
+
+  TimeVarBytes -= footprintIt->second.NumBytes;
+  ResidentClipsBySize.erase(std::make_pair(footprintIt->second.NumBytes, key));
+  TimeVarFootprints.erase(footprintIt);
+}
+
+void UsdBridgeUsdWriter::RemoveTimeVarFootprints(const UsdBridgePrimCache* cacheEntry)
+{
+  UsdBridgePrimCache* primCache = const_cast<UsdBridgePrimCache*>(cacheEntry);
+  auto footprintIt = TimeVarFootprints.lower_bound(TimeVarKey(primCache, -std::numeric_limits<double>::infinity()));
+  while (footprintIt != TimeVarFootprints.end() && footprintIt->first.first == cacheEntry)
+  {
+    TimeVarBytes -= footprintIt->second.NumBytes;
+    ResidentClipsBySize.erase(std::make_pair(footprintIt->second.NumBytes, footprintIt->first));
+    footprintIt = TimeVarFootprints.erase(footprintIt);
+  }
+}
 
 void UsdBridgeUsdWriter::SetSceneGraphRoot(UsdBridgePrimCache* worldCache, const char* name)
 {
@@ -825,6 +1420,8 @@ void UsdBridgeUsdWriter::CreatePrim(const SdfPath& path)
 void UsdBridgeUsdWriter::DeletePrim(const UsdBridgePrimCache* cacheEntry)
 {
   SceneStage->RemovePrim(cacheEntry->PrimPath);
+  TimeSampleCompactor.RemovePrim(cacheEntry->PrimPath);
+  RemoveTimeVarFootprints(cacheEntry);
 
 #ifdef VALUE_CLIP_RETIMING
   if (cacheEntry->PrimStage.second)
@@ -956,10 +1553,9 @@ void UsdBridgeUsdWriter::InitializeClipMetaData(const UsdPrim& clipPrim, UsdBrid
     //set interpolatemissingclipvalues?
 
     bool exists;
-    const UsdStagePair& childStagePair = FindOrCreatePrimClipStage(childCache, clipPostfix, childTimeStep, exists);
+    refStagePath = &FindOrCreatePrimClipFileName(childCache, clipPostfix, childTimeStep, exists);
     assert(exists);
 
-    refStagePath = &childStagePair.first;
     manifestPath = &childCache->PrimStage.first;
   }
   else
@@ -993,12 +1589,10 @@ void UsdBridgeUsdWriter::UpdateClipMetaData(const UsdPrim& clipPrim, UsdBridgePr
   if (clipStages)
   {
     bool exists;
-    const UsdStagePair& childStagePair = FindOrCreatePrimClipStage(childCache, clipPostfix, childTimeStep, exists);
+    const std::string& refStagePath = FindOrCreatePrimClipFileName(childCache, clipPostfix, childTimeStep, exists);
     // At this point, exists should be true, but if clip stage creation failed earlier due to user error, 
     // exists will be false and we'll just link to the empty new stage created by FindOrCreatePrimClipStage()
 
-    const std::string& refStagePath = childStagePair.first;
-
     VtVec2dArray clipActives;
     clipsApi.GetClipActive(&clipActives);
     VtArray<SdfAssetPath> assetPaths;
@@ -1097,6 +1691,10 @@ SdfPath UsdBridgeUsdWriter::AddRef(UsdBridgePrimCache* parentCache, UsdBridgePri
   bool replaceExisting,
   const RefModFuncs& refModCallbacks)
 {
+  // Children only have clips to reference with a time layout that puts them in separate stages
+  valueClip = valueClip && UsesPrimStages();
+  clipStages = clipStages && UsesClipStages();
+
   // Value clip-enabled references have to be defined on the scenestage, as usd does not re-time recursively.
   return AddRef_Impl(SceneStage, parentCache, childCache, refPathExt, timeVarying, valueClip, clipStages, clipPostfix, parentTimeStep, childTimeStep, replaceExisting, refModCallbacks);
 }
@@ -1118,6 +1716,14 @@ SdfPath UsdBridgeUsdWriter::AddRef_Impl(UsdStageRefPtr parentStage, UsdBridgePri
 
   UsdPrim referencingPrim = parentStage->GetPrimAtPath(referencingPrimPath);
 
+  // A stand-in for a prototype (see AddInstanceableRef) is replaced by a regular reference
+  if (referencingPrim && referencingPrim.IsInstanceable())
+  {
+    refModCallbacks.AtRemoveRef(parentCache, childCache->Name.GetString());
+    parentStage->RemovePrim(referencingPrimPath);
+    referencingPrim = UsdPrim();
+  }
+
   if (!referencingPrim)
   {
     if (replaceExisting)
@@ -1191,6 +1797,53 @@ SdfPath UsdBridgeUsdWriter::AddRef_Impl(UsdStageRefPtr parentStage, UsdBridgePri
   return referencingPrimPath;
 }
 
+SdfPath UsdBridgeUsdWriter::AddInstanceableRef(UsdBridgePrimCache* parentCache, UsdBridgePrimCache* childCache, UsdBridgePrimCache* protoCache, const char* refPathExt,
+  double parentTimeStep, const RefModFuncs& refModCallbacks)
+{
+  UsdTimeCode parentTimeCode(parentTimeStep);
+
+  SdfPath childBasePath = parentCache->PrimPath;
+  if (refPathExt)
+    childBasePath = parentCache->PrimPath.AppendPath(SdfPath(refPathExt));
+  SdfPath referencingPrimPath = childBasePath.AppendPath(childCache->Name);
+
+  UsdPrim referencingPrim = SceneStage->GetPrimAtPath(referencingPrimPath);
+
+  if (referencingPrim)
+  {
+    // Keep the prim if it already references the prototype, otherwise replace it (including any clip metadata)
+    SdfReferenceListOp references;
+    referencingPrim.GetMetadata(SdfFieldKeys->References, &references);
+    if (referencingPrim.IsInstanceable() && references.HasItem(SdfReference(std::string(), protoCache->PrimPath)))
+      return referencingPrimPath;
+
+    refModCallbacks.AtRemoveRef(parentCache, childCache->Name.GetString());
+    SceneStage->RemovePrim(referencingPrimPath);
+  }
+
+#ifdef TIME_BASED_CACHING
+  ChildrenRemoveIfVisible(SceneStage, parentCache, childBasePath, false, parentTimeCode, refModCallbacks.AtRemoveRef);
+#else
+  if (refPathExt)
+    SceneStage->RemovePrim(childBasePath);
+  else
+    RemoveAllRefs(SceneStage, parentCache, nullptr, false, 0.0, refModCallbacks.AtRemoveRef);
+#endif
+
+  referencingPrim = SceneStage->DefinePrim(referencingPrimPath);
+  assert(referencingPrim);
+
+  // All stand-ins referencing the same prototype share a single usd prototype
+  UsdReferences references = referencingPrim.GetReferences();
+  references.ClearReferences();
+  references.AddInternalReference(protoCache->PrimPath);
+  referencingPrim.SetInstanceable(true);
+
+  refModCallbacks.AtNewRef(parentCache, childCache);
+
+  return referencingPrimPath;
+}
+
 void UsdBridgeUsdWriter::RemoveAllRefs(UsdBridgePrimCache* parentCache, const char* refPathExt, bool timeVarying, double timeStep, AtRemoveRefFunc atRemoveRef)
 {
   RemoveAllRefs(SceneStage, parentCache, refPathExt, timeVarying, timeStep, atRemoveRef);
@@ -1226,6 +1879,28 @@ void UsdBridgeUsdWriter::RemoveAllRefs(UsdStageRefPtr stage, UsdBridgePrimCache*
 #endif
 }
 
+void UsdBridgeUsdWriter::RemoveRefs(UsdBridgePrimCache* parentCache, const UsdBridgePrimCacheList& children, const char* refPathExt, bool timeVarying, double timeStep, AtRemoveRefFunc atRemoveRef)
+{
+  UsdTimeCode timeCode(timeStep);
+
+  SdfPath childBasePath = parentCache->PrimPath;
+  if (refPathExt)
+    childBasePath = parentCache->PrimPath.AppendPath(SdfPath(refPathExt));
+
+  for (const UsdBridgePrimCache* childCache : children)
+  {
+    UsdPrim referencingPrim = SceneStage->GetPrimAtPath(childBasePath.AppendPath(childCache->Name));
+    if (!referencingPrim)
+      continue;
+
+#ifdef TIME_BASED_CACHING
+    PrimRemoveIfVisible(SceneStage, parentCache, referencingPrim, timeVarying, timeCode, atRemoveRef);
+#else
+    SceneStage->RemovePrim(referencingPrim.GetPath());
+#endif
+  }
+}
+
 void UsdBridgeUsdWriter::ManageUnusedRefs(UsdBridgePrimCache* parentCache, const UsdBridgePrimCacheList& newChildren, const char* refPathExt, bool timeVarying, double timeStep, AtRemoveRefFunc atRemoveRef)
 {
   ManageUnusedRefs(SceneStage, parentCache, newChildren, refPathExt, timeVarying, timeStep, atRemoveRef);
@@ -1246,17 +1921,16 @@ void UsdBridgeUsdWriter::ManageUnusedRefs(UsdStageRefPtr stage, UsdBridgePrimCac
 
   if (basePrim)
   {
+    // Referencing prims are named after their child, so a lookup of the name suffices
+    std::unordered_set<TfToken, TfToken::HashFunctor> newChildNames;
+    newChildNames.reserve(newChildren.size());
+    for (const UsdBridgePrimCache* newChild : newChildren)
+      newChildNames.insert(newChild->Name.GetNameToken());
+
     UsdPrimSiblingRange children = basePrim.GetAllChildren();
     for (UsdPrim oldChild : children)
     {
-      const std::string& oldChildName = oldChild.GetPrimPath().GetName();
-
-      bool found = false;
-      for (size_t newChildIdx = 0; newChildIdx < newChildren.size() && !found; ++newChildIdx)
-      {
-        const std::string& newChildName = newChildren[newChildIdx]->Name.GetString();
-        found = (newChildName == oldChildName);
-      }
+      bool found = newChildNames.find(oldChild.GetName()) != newChildNames.end();
 
       if (!found)
 #ifdef TIME_BASED_CACHING
@@ -1280,6 +1954,18 @@ void UsdBridgeUsdWriter::InitializeUsdTransform(const UsdBridgePrimCache* cacheE
   assert(transform);
 }
 
+void UsdBridgeUsdWriter::InitializeUsdGroupInstancer(const UsdBridgePrimCache* cacheEntry)
+{
+  UsdGeomPointInstancer instancer = UsdGeomPointInstancer::Define(SceneStage, cacheEntry->PrimPath);
+  assert(instancer);
+
+  instancer.CreatePositionsAttr();
+  instancer.CreateOrientationsAttr();
+  instancer.CreateScalesAttr();
+  instancer.CreateProtoIndicesAttr();
+  instancer.CreatePrototypesRel();
+}
+
 UsdPrim UsdBridgeUsdWriter::InitializeUsdGeometry(UsdStageRefPtr geometryStage, const SdfPath& geomPath, const UsdBridgeMeshData& meshData, bool uniformPrim)
 {
   UsdGeomMesh geomMesh = GetOrDefinePrim<UsdGeomMesh>(geometryStage, geomPath);
@@ -1423,9 +2109,38 @@ UsdPrim UsdBridgeUsdWriter::InitializeUsdVolume(UsdStageRefPtr volumeStage, cons
   volAsset.CreateFilePathAttr();
   volAsset.CreateExtentAttr();
 
+  // Bricks changed since the keyframe in the field above, to be composed over it (see UsdBridgeVolumeBrickTracker)
+  UsdVolOpenVDBAsset deltaAsset;
+  SdfPath ovdbDeltaPath = volumePath.AppendPath(SdfPath(openVDBDeltaPrimPf));
+  if (Settings.VolumeOutput.BrickDeltas)
+  {
+    deltaAsset = UsdVolOpenVDBAsset::Define(volumeStage, ovdbDeltaPath);
+    deltaAsset.CreateFilePathAttr();
+  }
+
+  // Downsampled levels of detail, which consumers can load before (or instead of) the full resolution field
+  int numLodLevels = GetNumVolumeLodLevels(Settings.VolumeOutput);
+  for (int lodLevel = 1; lodLevel <= numLodLevels; ++lodLevel)
+  {
+    SdfPath lodFieldPath = GetVolumeLodFieldPath(volumePath, lodLevel);
+    UsdVolOpenVDBAsset lodAsset = UsdVolOpenVDBAsset::Define(volumeStage, lodFieldPath);
+    lodAsset.CreateFilePathAttr();
+
+    if (uniformPrim)
+    {
+      volume.CreateFieldRelationship(GetVolumeLodFieldToken(lodLevel), lodFieldPath);
+      lodAsset.CreateFieldNameAttr(VtValue(UsdBridgeTokens->density));
+    }
+  }
+
   if (uniformPrim)
   {
     volume.CreateFieldRelationship(UsdBridgeTokens->density, ovdbFieldPath);
+    if (deltaAsset)
+    {
+      volume.CreateFieldRelationship(UsdBridgeTokens->densityDelta, ovdbDeltaPath);
+      deltaAsset.CreateFieldNameAttr(VtValue(UsdBridgeTokens->density));
+    }
     volume.ClearXformOpOrder();
     volume.AddTranslateOp();
     volume.AddScaleOp();
@@ -1626,6 +2341,31 @@ void UsdBridgeUsdWriter::UnBindSamplerFromMaterial(const SdfPath& matPrimPath)
 #endif
 }
 
+void UsdBridgeUsdWriter::CompactTimeSample(const SdfLayerHandle& layer, const SdfPath& attrSpecPath, const UsdTimeCode& timeCode)
+{
+  if (timeCode.IsDefault() || !TimeSampleCompactor.IsEnabled())
+    return;
+
+  TimeSampleCompactor.SampleAuthored(layer, attrSpecPath, timeCode.GetValue());
+}
+
+void UsdBridgeUsdWriter::CompactTimeSample(const UsdAttribute& attrib, const UsdTimeCode& timeCode)
+{
+  if (timeCode.IsDefault() || !TimeSampleCompactor.IsEnabled())
+    return;
+
+  const UsdEditTarget& editTarget = attrib.GetStage()->GetEditTarget();
+  TimeSampleCompactor.SampleAuthored(editTarget.GetLayer(), editTarget.MapToSpecPath(attrib.GetPath()), timeCode.GetValue());
+}
+
+template<typename ValueType>
+void UsdBridgeUsdWriter::SetShaderInput(const UsdShadeShader& shader, const TfToken& inputName, const ValueType& value, const UsdTimeCode& timeCode)
+{
+  UsdShadeInput input = shader.GetInput(inputName);
+  input.Set(value, timeCode);
+  CompactTimeSample(input.GetAttr(), timeCode);
+}
+
 void UsdBridgeUsdWriter::UpdateUsdTransform(const SdfPath& transPrimPath, float* transform, bool timeVarying, double timeStep)
 {
   TimeEvaluator<bool> timeEval(timeVarying, timeStep);
@@ -1637,10 +2377,108 @@ void UsdBridgeUsdWriter::UpdateUsdTransform(const SdfPath& transPrimPath, float*
   transMat.SetColumn(3, GfVec4d(GfVec4f(&transform[12])));
 
   //Note that instance transform nodes have already been created.
-  UsdGeomXform tfPrim = UsdGeomXform::Get(this->SceneStage, transPrimPath);
-  assert(tfPrim);
-  tfPrim.ClearXformOpOrder();
-  tfPrim.AddTransformOp().Set(transMat, timeEval.Eval());
+  assert(UsdGeomXform::Get(this->SceneStage, transPrimPath));
+
+  ChangeBlockScope changeBlock(this->BatchChanges);
+  SdfPath transformPath = SetTransformSpec(this->SceneStage, transPrimPath, transMat, timeEval.Eval());
+  CompactTimeSample(this->SceneStage->GetEditTarget().GetLayer(), transformPath, timeEval.Eval());
+}
+
+void UsdBridgeUsdWriter::UpdateUsdTransforms(const UsdBridgePrimCacheList& instanceCaches, const float* transforms, bool timeVarying, double timeStep)
+{
+  TimeEvaluator<bool> timeEval(timeVarying, timeStep);
+  const UsdTimeCode& timeCode = timeEval.Eval();
+
+  // Same result as UpdateUsdTransform for each instance, with change processing deferred to the end of the batch
+  ChangeBlockScope changeBlock(this->BatchChanges);
+  SdfLayerHandle editLayer = this->SceneStage->GetEditTarget().GetLayer();
+
+  for (size_t i = 0; i < instanceCaches.size(); ++i)
+  {
+    const float* transform = transforms + i * 12;
+
+    GfMatrix4d transMat;
+    for (int col = 0; col < 4; ++col)
+      transMat.SetColumn(col, GfVec4d(transform[col * 3], transform[col * 3 + 1], transform[col * 3 + 2], (col == 3) ? 1.0 : 0.0));
+
+    SdfPath transformPath = SetTransformSpec(this->SceneStage, instanceCaches[i]->PrimPath, transMat, timeCode);
+    CompactTimeSample(editLayer, transformPath, timeCode);
+  }
+}
+
+void UsdBridgeUsdWriter::UpdateUsdGroupInstancer(const UsdBridgePrimCache* instancerCache, const char* protoPathExt, const UsdBridgePrimCacheList& protoCaches,
+  const UsdBridgeGroupInstancesData& groupInstances, bool timeVarying, double timeStep)
+{
+  TimeEvaluator<bool> timeEval(timeVarying, timeStep);
+
+  UsdGeomPointInstancer instancer = UsdGeomPointInstancer::Get(this->SceneStage, instancerCache->PrimPath);
+  assert(instancer);
+
+  // The prototypes relationship cannot be timevarying; it targets all prototype prims, in order of creation
+  SdfPath protoBasePath = instancerCache->PrimPath.AppendPath(SdfPath(protoPathExt));
+  SdfPathVector protoPaths;
+  std::map<SdfPath, int> protoPathIndices;
+  UsdPrim protoBasePrim = this->SceneStage->GetPrimAtPath(protoBasePath);
+  if (protoBasePrim)
+  {
+    for (UsdPrim protoPrim : protoBasePrim.GetAllChildren())
+    {
+      protoPathIndices.emplace(protoPrim.GetPath(), int(protoPaths.size()));
+      protoPaths.push_back(protoPrim.GetPath());
+    }
+  }
+  instancer.GetPrototypesRel().SetTargets(protoPaths);
+
+  std::vector<int> groupProtoIndices(protoCaches.size());
+  for (size_t i = 0; i < protoCaches.size(); ++i)
+  {
+    auto protoIt = protoPathIndices.find(protoBasePath.AppendPath(protoCaches[i]->Name));
+    assert(protoIt != protoPathIndices.end());
+    groupProtoIndices[i] = protoIt->second;
+  }
+
+  uint64_t numInstances = groupInstances.NumInstances;
+  VtIntArray protoIndices(numInstances);
+  VtVec3fArray positions(numInstances);
+  VtQuathArray orientations(numInstances);
+  VtVec3fArray scales(numInstances);
+
+  for (uint64_t i = 0; i < numInstances; ++i)
+  {
+    const float* transform = groupInstances.Transforms + i * 12;
+
+    assert(groupInstances.GroupIndices[i] >= 0 && groupInstances.GroupIndices[i] < int(protoCaches.size()));
+    protoIndices[i] = groupProtoIndices[groupInstances.GroupIndices[i]];
+    positions[i] = GfVec3f(&transform[9]);
+
+    // Factor the linear part into scale and rotation; point instancers cannot represent shear
+    GfVec3f axes[3] = { GfVec3f(&transform[0]), GfVec3f(&transform[3]), GfVec3f(&transform[6]) };
+    GfVec3f scale(axes[0].GetLength(), axes[1].GetLength(), axes[2].GetLength());
+    if (GfDot(GfCross(axes[0], axes[1]), axes[2]) < 0.0f)
+    {
+      // Mirroring is expressed by a negative scale, keeping the rotation proper
+      scale[2] = -scale[2];
+    }
+
+    GfMatrix3d rotMat(1.0);
+    for (int j = 0; j < 3; ++j)
+    {
+      if (scale[j] != 0.0f)
+        rotMat.SetRow(j, GfVec3d(axes[j] / scale[j]));
+    }
+    rotMat.Orthonormalize(false);
+
+    GfQuaternion quat = rotMat.ExtractRotation().GetQuaternion();
+    orientations[i] = GfQuath((float)(quat.GetReal()), GfVec3h(quat.GetImaginary()));
+    scales[i] = scale;
+  }
+
+  const UsdTimeCode& timeCode = timeEval.Eval();
+  ChangeBlockScope changeBlock(this->BatchChanges);
+  instancer.GetProtoIndicesAttr().Set(protoIndices, timeCode);
+  instancer.GetPositionsAttr().Set(positions, timeCode);
+  instancer.GetOrientationsAttr().Set(orientations, timeCode);
+  instancer.GetScalesAttr().Set(scales, timeCode);
 }
 
 template<typename UsdGeomType, typename GeomDataType>
@@ -1665,6 +2503,7 @@ void UpdateUsdGeomPoints(UsdBridgeUsdWriter* writer, UsdGeomType& timeVarGeom, U
       UsdAttribute pointsAttr = UsdGeomGetPointsAttribute(*outGeom);
 
       const void* arrayData = geomData.Points;
+      int64_t arrayStride = geomData.PointsStride;
       size_t arrayNumElements = geomData.NumPoints;
       UsdAttribute arrayPrimvar = pointsAttr;
       VtVec3fArray usdVerts;
@@ -1735,6 +2574,7 @@ void UpdateUsdGeomIndices(UsdBridgeUsdWriter* writer, UsdGeomType& timeVarGeom,
     {
       // Face indices
       const void* arrayData = geomData.Indices;
+      int64_t arrayStride = 0;
       size_t arrayNumElements = numIndices;
       UsdAttribute arrayPrimvar = outGeom->GetFaceVertexIndicesAttr();
       switch (geomData.IndicesType)
@@ -1771,6 +2611,7 @@ void UpdateUsdGeomNormals(UsdBridgeUsdWriter* writer, UsdGeomType& timeVarGeom,
     if (geomData.Normals != nullptr)
     {
       const void* arrayData = geomData.Normals;
+      int64_t arrayStride = geomData.NormalsStride;
       size_t arrayNumElements = geomData.PerPrimNormals ? numPrims : geomData.NumPoints;
       UsdAttribute arrayPrimvar = normalsAttr;
       switch (geomData.NormalsType)
@@ -1813,6 +2654,7 @@ void UpdateUsdGeomTexCoords(UsdBridgeUsdWriter* writer, UsdGeomType& timeVarGeom
     if (geomData.TexCoords != nullptr)
     {
       const void* arrayData = geomData.TexCoords;
+      int64_t arrayStride = geomData.TexCoordsStride;
       size_t arrayNumElements = geomData.PerPrimTexCoords ? numPrims : geomData.NumPoints;
       UsdAttribute arrayPrimvar = texcoordPrimvar;
       switch (geomData.TexCoordsType)
@@ -1862,6 +2704,7 @@ void UpdateUsdGeomColors(UsdBridgeUsdWriter* writer, UsdGeomType& timeVarGeom, U
     if (geomData.Colors != nullptr)
     {
       const void* arrayData = geomData.Colors;
+      int64_t arrayStride = geomData.ColorsStride;
       size_t arrayNumElements = geomData.PerPrimColors ? numPrims : geomData.NumPoints;
       UsdAttribute arrayPrimvar = colorPrimvar;
       bool typeSupported = true;
@@ -1965,6 +2808,7 @@ void UpdateUsdGeomInstanceIds(UsdBridgeUsdWriter* writer, UsdGeomType& timeVarGe
     if (geomData.InstanceIds)
     {
       const void* arrayData = geomData.InstanceIds;
+      int64_t arrayStride = 0;
       size_t arrayNumElements = geomData.NumPoints;
       UsdAttribute arrayPrimvar = idsAttr;
       switch (geomData.InstanceIdsType)
@@ -2004,6 +2848,7 @@ void UpdateUsdGeomWidths(UsdBridgeUsdWriter* writer, UsdGeomType& timeVarGeom, U
     if (geomData.Scales)
     {
       const void* arrayData = geomData.Scales;
+      int64_t arrayStride = geomData.ScalesStride;
       size_t arrayNumElements = geomData.NumPoints;
       UsdAttribute arrayPrimvar = widthsAttribute;
       switch (geomData.ScalesType)
@@ -2042,6 +2887,7 @@ void UpdateUsdGeomScales(UsdBridgeUsdWriter* writer, UsdGeomType& timeVarGeom, U
     if (geomData.Scales)
     {
       const void* arrayData = geomData.Scales;
+      int64_t arrayStride = geomData.ScalesStride;
       size_t arrayNumElements = geomData.NumPoints;
       UsdAttribute arrayPrimvar = scalesAttribute;
       switch (geomData.ScalesType)
@@ -2084,6 +2930,7 @@ void UpdateUsdGeomOrientNormals(UsdBridgeUsdWriter* writer, UsdGeomType& timeVar
     if (geomData.Orientations)
     {
       const void* arrayData = geomData.Orientations;
+      int64_t arrayStride = geomData.OrientationsStride;
       size_t arrayNumElements = geomData.NumPoints;
       UsdAttribute arrayPrimvar = normalsAttribute;
       switch (geomData.OrientationsType)
@@ -2127,14 +2974,14 @@ void UpdateUsdGeomOrientations(UsdBridgeUsdWriter* writer, UsdGeomType& timeVarG
       VtQuathArray usdOrients(geomData.NumPoints);
       switch (geomData.OrientationsType)
       {
-      case UsdBridgeType::FLOAT3: { ConvertNormalsToQuaternions<float>(usdOrients, geomData.Orientations, geomData.NumPoints); break; }
-      case UsdBridgeType::DOUBLE3: { ConvertNormalsToQuaternions<double>(usdOrients, geomData.Orientations, geomData.NumPoints); break; }
+      case UsdBridgeType::FLOAT3: { ConvertNormalsToQuaternions<float>(usdOrients, geomData.Orientations, geomData.OrientationsStride, geomData.NumPoints); break; }
+      case UsdBridgeType::DOUBLE3: { ConvertNormalsToQuaternions<double>(usdOrients, geomData.Orientations, geomData.OrientationsStride, geomData.NumPoints); break; }
       case UsdBridgeType::FLOAT4: 
         { 
+          StridedArray<float[4]> orients(geomData.Orientations, geomData.OrientationsStride);
           for (uint64_t i = 0; i < geomData.NumPoints; ++i)
           {
-            const float* orients = reinterpret_cast<const float*>(geomData.Orientations);
-            usdOrients[i] = GfQuath(orients[i * 4], orients[i * 4 + 1], orients[i * 4 + 2], orients[i * 4 + 3]);
+            usdOrients[i] = GfQuath(orients[i][0], orients[i][1], orients[i][2], orients[i][3]);
           }
           orientationsAttribute.Set(usdOrients, timeCode);
           break; 
@@ -2259,6 +3106,7 @@ void UpdateUsdGeomInvisibleIds(UsdBridgeUsdWriter* writer, UsdGeomType& timeVarG
     if (numInvisibleIds)
     {
       const void* arrayData = geomData.InvisibleIds;
+      int64_t arrayStride = 0;
       size_t arrayNumElements = numInvisibleIds;
       UsdAttribute arrayPrimvar = invisIdsAttr;
       switch (geomData.InvisibleIdsType)
@@ -2297,6 +3145,7 @@ static void UpdateUsdGeomCurveLengths(UsdBridgeUsdWriter* writer, UsdGeomBasisCu
     assert(vertCountAttr);
 
     const void* arrayData = geomData.CurveLengths;
+    int64_t arrayStride = 0;
     size_t arrayNumElements = geomData.NumCurveLengths;
     UsdAttribute arrayPrimvar = vertCountAttr;
     VtVec3fArray usdVerts;
@@ -2327,6 +3176,9 @@ void UsdBridgeUsdWriter::UpdateUsdGeometry(const UsdStagePtr& timeVarStage, cons
   assert((geomData.NumIndices % geomData.FaceVertexCount) == 0);
   uint64_t numPrims = int(geomData.NumIndices) / geomData.FaceVertexCount;
 
+  // All arrays of the geometry are processed as a single change
+  ChangeBlockScope changeBlock(this->BatchChanges);
+
   UPDATE_USDGEOM_ARRAYS(UpdateUsdGeomPoints);
   UPDATE_USDGEOM_ARRAYS(UpdateUsdGeomNormals);
   UPDATE_USDGEOM_ARRAYS(UpdateUsdGeomTexCoords);
@@ -2343,6 +3195,9 @@ void UsdBridgeUsdWriter::UpdateUsdGeometry(const UsdStagePtr& timeVarStage, cons
 
   uint64_t numPrims = geomData.NumPoints;
 
+  // All arrays of the geometry are processed as a single change
+  ChangeBlockScope changeBlock(this->BatchChanges);
+
   if (useGeomPoints)
   {
     UsdGeomPoints uniformGeom = UsdGeomPoints::Get(this->SceneStage, instancerPath);
@@ -2394,6 +3249,9 @@ void UsdBridgeUsdWriter::UpdateUsdGeometry(const UsdStagePtr& timeVarStage, cons
 
   uint64_t numPrims = geomData.NumCurveLengths;
 
+  // All arrays of the geometry are processed as a single change
+  ChangeBlockScope changeBlock(this->BatchChanges);
+
   UPDATE_USDGEOM_ARRAYS(UpdateUsdGeomPoints);
   UPDATE_USDGEOM_ARRAYS(UpdateUsdGeomNormals);
   UPDATE_USDGEOM_ARRAYS(UpdateUsdGeomTexCoords);
@@ -2433,12 +3291,12 @@ void UsdBridgeUsdWriter::UpdateUsdShader(UsdStageRefPtr shaderStage, const SdfPa
 
   timeVarShadPrim.GetInput(UsdBridgeTokens->useSpecularWorkflow).Set(matData.Metallic >= 0.0 ? 0 : 1);
 
-  timeVarShadPrim.GetInput(UsdBridgeTokens->roughness).Set(matData.Roughness, timeEval.Eval(DMI::ROUGHNESS));
-  timeVarShadPrim.GetInput(UsdBridgeTokens->opacity).Set(matData.Opacity, timeEval.Eval(DMI::OPACITY));
-  timeVarShadPrim.GetInput(UsdBridgeTokens->metallic).Set(matData.Metallic, timeEval.Eval(DMI::METALLIC));
-  timeVarShadPrim.GetInput(UsdBridgeTokens->ior).Set(matData.Ior, timeEval.Eval(DMI::IOR));
+  SetShaderInput(timeVarShadPrim, UsdBridgeTokens->roughness, matData.Roughness, timeEval.Eval(DMI::ROUGHNESS));
+  SetShaderInput(timeVarShadPrim, UsdBridgeTokens->opacity, matData.Opacity, timeEval.Eval(DMI::OPACITY));
+  SetShaderInput(timeVarShadPrim, UsdBridgeTokens->metallic, matData.Metallic, timeEval.Eval(DMI::METALLIC));
+  SetShaderInput(timeVarShadPrim, UsdBridgeTokens->ior, matData.Ior, timeEval.Eval(DMI::IOR));
 
-  timeVarShadPrim.GetInput(UsdBridgeTokens->emissiveColor).Set(emColor, timeEval.Eval(DMI::EMISSIVE));
+  SetShaderInput(timeVarShadPrim, UsdBridgeTokens->emissiveColor, emColor, timeEval.Eval(DMI::EMISSIVE));
 
   if (matData.UseVertexColors)
   {
@@ -2458,8 +3316,12 @@ void UsdBridgeUsdWriter::UpdateUsdShader(UsdStageRefPtr shaderStage, const SdfPa
   {
     uniformShadPrim.GetPrim().RemoveProperty(TfToken("input:diffuseColor"));
     uniformShadPrim.GetPrim().RemoveProperty(TfToken("input:specularColor"));
-    timeVarShadPrim.CreateInput(UsdBridgeTokens->diffuseColor, SdfValueTypeNames->Color3f).Set(difColor, timeEval.Eval(DMI::DIFFUSE));
-    timeVarShadPrim.CreateInput(UsdBridgeTokens->specularColor, SdfValueTypeNames->Color3f).Set(specColor, timeEval.Eval(DMI::SPECULAR));
+    UsdShadeInput diffuseInput = timeVarShadPrim.CreateInput(UsdBridgeTokens->diffuseColor, SdfValueTypeNames->Color3f);
+    diffuseInput.Set(difColor, timeEval.Eval(DMI::DIFFUSE));
+    CompactTimeSample(diffuseInput.GetAttr(), timeEval.Eval(DMI::DIFFUSE));
+    UsdShadeInput specularInput = timeVarShadPrim.CreateInput(UsdBridgeTokens->specularColor, SdfValueTypeNames->Color3f);
+    specularInput.Set(specColor, timeEval.Eval(DMI::SPECULAR));
+    CompactTimeSample(specularInput.GetAttr(), timeEval.Eval(DMI::SPECULAR));
   }
 }
 
@@ -2479,15 +3341,17 @@ void UsdBridgeUsdWriter::UpdateMdlShader(UsdStageRefPtr shaderStage, const SdfPa
   GfVec3f specColor(matData.Specular); // Not sure yet how to incorporate the specular color, no mdl parameter available.
   GfVec3f emColor(matData.Emissive);
 
+  ChangeBlockScope changeBlock(this->BatchChanges);
+
   uniformShadPrim.GetInput(UsdBridgeTokens->vertexcolor_coordinate_index).Set(matData.UseVertexColors ? 1 : -1);
 
-  timeVarShadPrim.GetInput(UsdBridgeTokens->diffuse_color_constant).Set(difColor, timeEval.Eval(DMI::DIFFUSE));
-  timeVarShadPrim.GetInput(UsdBridgeTokens->emissive_color).Set(emColor, timeEval.Eval(DMI::EMISSIVE));
-  timeVarShadPrim.GetInput(UsdBridgeTokens->emissive_intensity).Set(matData.EmissiveIntensity, timeEval.Eval(DMI::EMISSIVEINTENSITY));
-  timeVarShadPrim.GetInput(UsdBridgeTokens->opacity_constant).Set(matData.Opacity, timeEval.Eval(DMI::OPACITY));
-  timeVarShadPrim.GetInput(UsdBridgeTokens->reflection_roughness_constant).Set(matData.Roughness, timeEval.Eval(DMI::ROUGHNESS));
-  timeVarShadPrim.GetInput(UsdBridgeTokens->metallic_constant).Set(matData.Metallic, timeEval.Eval(DMI::METALLIC));
-  timeVarShadPrim.GetInput(UsdBridgeTokens->ior_constant).Set(matData.Ior, timeEval.Eval(DMI::IOR));
+  SetShaderInput(timeVarShadPrim, UsdBridgeTokens->diffuse_color_constant, difColor, timeEval.Eval(DMI::DIFFUSE));
+  SetShaderInput(timeVarShadPrim, UsdBridgeTokens->emissive_color, emColor, timeEval.Eval(DMI::EMISSIVE));
+  SetShaderInput(timeVarShadPrim, UsdBridgeTokens->emissive_intensity, matData.EmissiveIntensity, timeEval.Eval(DMI::EMISSIVEINTENSITY));
+  SetShaderInput(timeVarShadPrim, UsdBridgeTokens->opacity_constant, matData.Opacity, timeEval.Eval(DMI::OPACITY));
+  SetShaderInput(timeVarShadPrim, UsdBridgeTokens->reflection_roughness_constant, matData.Roughness, timeEval.Eval(DMI::ROUGHNESS));
+  SetShaderInput(timeVarShadPrim, UsdBridgeTokens->metallic_constant, matData.Metallic, timeEval.Eval(DMI::METALLIC));
+  SetShaderInput(timeVarShadPrim, UsdBridgeTokens->ior_constant, matData.Ior, timeEval.Eval(DMI::IOR));
   timeVarShadPrim.GetInput(UsdBridgeTokens->enable_emission).Set(matData.EmissiveIntensity > 0, timeEval.Eval(DMI::EMISSIVEINTENSITY));
 
   if (!matData.HasTranslucency)
@@ -2511,36 +3375,196 @@ void UsdBridgeUsdWriter::UpdateUsdVolume(UsdStageRefPtr volumeStage, const SdfPa
 
   // Set the file path reference in usd
   UsdAttribute fileAttr = ovdbField.GetFilePathAttr();
+  UsdTimeCode dataTimeCode = timeEval.Eval(DMI::DATA);
 
-  std::string relVolPath(std::string(volFolder) + name);
+  std::string fileTimePf;
 #ifdef TIME_BASED_CACHING
-  relVolPath += "_" + std::to_string(timeStep);
+  fileTimePf = "_" + std::to_string(timeStep);
 #endif
-  relVolPath += ".vdb";
 
-  SdfAssetPath volAsset(relVolPath);
-  fileAttr.Set(volAsset, timeEval.Eval(DMI::DATA));
+  // With brick deltas, the full data is only written at keyframes
+  UsdAttribute deltaFileAttr;
+  if (VolumeBricks)
+    deltaFileAttr = UsdVolOpenVDBAsset::Get(volumeStage, volPrimPath.AppendPath(SdfPath(openVDBDeltaPrimPf))).GetFilePathAttr();
 
-  // Get output stream
-  std::string fullVolPath(SessionDirectory + relVolPath);
+  // The keyframe replaced at this timestep may still be the base of the deltas of other timesteps
+  SdfAssetPath prevKeyframeAsset;
+  if (VolumeBricks && !AssetStore)
+    GetAuthoredValue(fileAttr, dataTimeCode, prevKeyframeAsset);
 
-  std::ostream* vdbOutput = Connect->GetStream(fullVolPath.c_str());
-  if (!vdbOutput)
+  const UsdBridgeVolumeBrickMask* deltaMask = nullptr;
+  if (VolumeBricks && VolumeBricks->Update(name, volumeData, Settings.VolumeOutput.MaxDeltaFraction, deltaMask))
   {
-    UsdBridgeLogMacro(this, UsdBridgeLogLevel::ERR, "Cannot create volume file " << fullVolPath.c_str());
+    if (!WriteVolumeFile(deltaFileAttr, name + "_delta" + fileTimePf,
+      [this, &volumeData, deltaMask](std::ostream& vdbOutput) { VolumeWriter.ToVDB(volumeData, vdbOutput, deltaMask); },
+      dataTimeCode))
+      return;
+
+    SetVolumeFilePath(fileAttr, VolumeBricks->GetKeyframeAsset(name), true, dataTimeCode);
+  }
+  else
+  {
+    // Keyframes are named uniquely, so rewriting the timestep of a keyframe doesn't overwrite the base of existing deltas
+    std::string keyframePf = VolumeBricks ? "_key" + std::to_string(VolumeBricks->GetKeyframeId(name)) : std::string();
+    if (!WriteVolumeFile(fileAttr, name + fileTimePf + keyframePf,
+      [this, &volumeData](std::ostream& vdbOutput) { VolumeWriter.ToVDB(volumeData, vdbOutput); },
+      dataTimeCode))
+      return;
+
+    if (VolumeBricks)
+    {
+      SdfAssetPath keyframeAsset;
+      fileAttr.Get(&keyframeAsset, dataTimeCode);
+      VolumeBricks->SetKeyframeAsset(name, keyframeAsset.GetAssetPath());
+
+      SetVolumeFilePath(deltaFileAttr, std::string(), false, dataTimeCode);
+    }
+  }
+
+  if (!prevKeyframeAsset.GetAssetPath().empty())
+    RemoveUnusedKeyframe(fileAttr, prevKeyframeAsset.GetAssetPath());
+
+  // Each level of detail is downsampled from the previous one, alternating between two buffers
+  int numLodLevels = GetNumVolumeLodLevels(Settings.VolumeOutput);
+  const UsdBridgeVolumeData* lodSourceData = &volumeData;
+  UsdBridgeVolumeData lodVolumeData[2];
+  std::vector<char> lodData[2];
+  for (int lodLevel = 1; lodLevel <= numLodLevels; ++lodLevel)
+  {
+    UsdBridgeVolumeData& levelVolumeData = lodVolumeData[lodLevel % 2];
+    if (!VolumeWriter.Downsample(*lodSourceData, levelVolumeData, lodData[lodLevel % 2]))
+      break;
+
+    UsdAttribute lodFileAttr = UsdVolOpenVDBAsset::Get(volumeStage, GetVolumeLodFieldPath(volPrimPath, lodLevel)).GetFilePathAttr();
+    std::string lodFileName = name + "_lod" + std::to_string(lodLevel) + fileTimePf;
+    if (!WriteVolumeFile(lodFileAttr, lodFileName,
+      [this, &levelVolumeData, lodLevel](std::ostream& vdbOutput) { VolumeWriter.ToVDB(levelVolumeData, vdbOutput, nullptr, lodLevel); },
+      dataTimeCode))
+      break;
+
+    lodSourceData = &levelVolumeData;
+  }
+
+  UpdateUsdVolumeTransform(volume, volumeData, timeStep);
+}
+
+void UsdBridgeUsdWriter::UpdateUsdVolumeRegion(UsdStageRefPtr volumeStage, const SdfPath& volPrimPath, const std::string& name,
+  UsdBridgeVolumeRegions& volumeRegions, const UsdBridgeVolumeData& volumeData, const size_t* regionOffset, const size_t* regionDims, double timeStep)
+{
+  const UsdBridgeVolumeData& layout = volumeRegions.Layout;
+  const size_t* dims = volumeData.NumElements;
+
+  // A region of a different timestep or volume layout starts a new volume
+  bool sameVolume = volumeRegions.Grids && volumeRegions.TimeStep == timeStep
+    && layout.DataType == volumeData.DataType && layout.preClassified == volumeData.preClassified
+    && layout.NumElements[0] == dims[0] && layout.NumElements[1] == dims[1] && layout.NumElements[2] == dims[2];
+  if (!sameVolume)
+  {
+    if (volumeRegions.NumCoveredElements > 0)
+    {
+      UsdBridgeLogMacro(this, UsdBridgeLogLevel::WARNING, "Volume " << name << " receives a new volume before its previous regions covered the full volume, discarding the previous regions.");
+    }
+
+    volumeRegions.Layout = volumeData;
+    volumeRegions.Layout.Data = nullptr;
+    volumeRegions.TimeStep = timeStep;
+    volumeRegions.NumCoveredElements = 0;
+    volumeRegions.Covered.clear();
+    volumeRegions.Grids = VolumeWriter.CreateVolumeGrids(volumeData);
+  }
+
+  // Coverage is counted in elements, so a region outside the volume or overlapping an earlier one would complete it early
+  for (int i = 0; i < 3; ++i)
+  {
+    if (regionDims[i] == 0 || regionOffset[i] + regionDims[i] > dims[i])
+    {
+      UsdBridgeLogMacro(this, UsdBridgeLogLevel::ERR, "Volume " << name << " receives a region outside of the volume, ignoring the region.");
+      return;
+    }
+  }
+  for (const std::array<size_t, 6>& covered : volumeRegions.Covered)
+  {
+    bool overlaps = true;
+    for (int i = 0; i < 3; ++i)
+      overlaps = overlaps && regionOffset[i] < covered[i] + covered[3+i] && covered[i] < regionOffset[i] + regionDims[i];
+    if (overlaps)
+    {
+      UsdBridgeLogMacro(this, UsdBridgeLogLevel::ERR, "Volume " << name << " receives a region overlapping a previous region of the same timestep, ignoring the region.");
+      return;
+    }
+  }
+  volumeRegions.Covered.push_back({ regionOffset[0], regionOffset[1], regionOffset[2], regionDims[0], regionDims[1], regionDims[2] });
+
+  // The region data is converted into the grids right away, so the caller can release it
+  UsdBridgeVolumeData regionData = volumeData;
+  for (int i = 0; i < 3; ++i)
+    regionData.NumElements[i] = regionDims[i];
+  VolumeWriter.AddVolumeRegion(*volumeRegions.Grids, regionData, regionOffset);
+
+  volumeRegions.NumCoveredElements += regionDims[0] * regionDims[1] * regionDims[2];
+  if (volumeRegions.NumCoveredElements < dims[0] * dims[1] * dims[2])
     return;
+
+  TimeEvaluator<UsdBridgeVolumeData> timeEval(volumeData, timeStep);
+  typedef UsdBridgeVolumeData::DataMemberId DMI;
+
+  UsdVolVolume volume = UsdVolVolume::Get(volumeStage, volPrimPath);
+  assert(volume);
+
+  UsdAttribute fileAttr = UsdVolOpenVDBAsset::Get(volumeStage, volPrimPath.AppendPath(SdfPath(openVDBPrimPf))).GetFilePathAttr();
+  UsdTimeCode dataTimeCode = timeEval.Eval(DMI::DATA);
+
+  std::string fileTimePf;
+#ifdef TIME_BASED_CACHING
+  fileTimePf = "_" + std::to_string(timeStep);
+#endif
+
+  UsdBridgeVolumeGrids& grids = *volumeRegions.Grids;
+  bool written = WriteVolumeFile(fileAttr, name + fileTimePf,
+    [this, &grids](std::ostream& vdbOutput) { VolumeWriter.WriteVolumeGrids(grids, vdbOutput); },
+    dataTimeCode);
+
+  volumeRegions.Grids = nullptr;
+  volumeRegions.NumCoveredElements = 0;
+  volumeRegions.Covered.clear();
+
+  if (!written)
+    return;
+
+  // Brick deltas and levels of detail require the dense data, so they are not output for volumes submitted in regions.
+  // Clear any that were written for a previous full update, and make the next full update a keyframe.
+  if (VolumeBricks)
+  {
+    VolumeBricks->RemoveVolume(name);
+    UsdAttribute deltaFileAttr = UsdVolOpenVDBAsset::Get(volumeStage, volPrimPath.AppendPath(SdfPath(openVDBDeltaPrimPf))).GetFilePathAttr();
+    SetVolumeFilePath(deltaFileAttr, std::string(), false, dataTimeCode);
+  }
+  for (int lodLevel = 1; lodLevel <= GetNumVolumeLodLevels(Settings.VolumeOutput); ++lodLevel)
+  {
+    UsdAttribute lodFileAttr = UsdVolOpenVDBAsset::Get(volumeStage, GetVolumeLodFieldPath(volPrimPath, lodLevel)).GetFilePathAttr();
+    SetVolumeFilePath(lodFileAttr, std::string(), false, dataTimeCode);
   }
 
+  UpdateUsdVolumeTransform(volume, volumeData, timeStep);
+}
+
+void UsdBridgeUsdWriter::UpdateUsdVolumeTransform(UsdVolVolume& volume, const UsdBridgeVolumeData& volumeData, double timeStep)
+{
+  TimeEvaluator<UsdBridgeVolumeData> timeEval(volumeData, timeStep);
+  typedef UsdBridgeVolumeData::DataMemberId DMI;
+
   // Translate-scale in usd
   volume.ClearXformOpOrder();
 
   UsdGeomXformOp transOp = volume.AddTranslateOp();
   GfVec3d trans(volumeData.Origin[0], volumeData.Origin[1], volumeData.Origin[2]);
   transOp.Set(trans, timeEval.Eval(DMI::ORIGIN));
+  CompactTimeSample(transOp.GetAttr(), timeEval.Eval(DMI::ORIGIN));
 
   UsdGeomXformOp scaleOp = volume.AddScaleOp();
   GfVec3f scale(volumeData.CellDimensions[0], volumeData.CellDimensions[1], volumeData.CellDimensions[2]);
   scaleOp.Set(scale, timeEval.Eval(DMI::CELLDIMENSIONS));
+  CompactTimeSample(scaleOp.GetAttr(), timeEval.Eval(DMI::CELLDIMENSIONS));
 
   // Set extents in usd
   VtVec3fArray extentArray(2);
@@ -2548,12 +3572,90 @@ void UsdBridgeUsdWriter::UpdateUsdVolume(UsdStageRefPtr volumeStage, const SdfPa
   extentArray[1].Set((float)volumeData.NumElements[0], (float)volumeData.NumElements[1], (float)volumeData.NumElements[2]); //approx extents
 
   volume.GetExtentAttr().Set(extentArray, timeEval.Eval(DMI::DATA));
+}
+
+bool UsdBridgeUsdWriter::WriteVolumeFile(UsdAttribute& fileAttr, const std::string& fileName, const VolumeEncodeFunc& encodeVolume,
+  const UsdTimeCode& timeCode)
+{
+  // Content-addressed, so the path is only known after encoding
+  if (AssetStore)
+    return WriteVolumeStoreAsset(fileAttr, encodeVolume, timeCode);
+
+  std::string relVolPath(std::string(volFolder) + fileName + ".vdb");
+
+  SdfAssetPath volAsset(relVolPath);
+  fileAttr.Set(volAsset, timeCode);
+
+  // Get output stream
+  std::string fullVolPath(SessionDirectory + relVolPath);
+  FileRemover->CancelRemoval(fullVolPath);
+
+  UsdBridgeOutputStream* vdbOutput = Connect->OpenStream(fullVolPath.c_str());
+  if (!vdbOutput)
+  {
+    UsdBridgeLogMacro(this, UsdBridgeLogLevel::ERR, "Cannot create volume file " << fullVolPath.c_str());
+    return false;
+  }
 
   // Write VDB data to stream
-  VolumeWriter.ToVDB(volumeData, *vdbOutput);
+  encodeVolume(vdbOutput->GetOutput());
 
   // Flush stream out to storage
-  Connect->FlushStream();
+  if (!Connect->CloseStream(vdbOutput))
+  {
+    UsdBridgeLogMacro(this, UsdBridgeLogLevel::ERR, "Failed writing volume file " << fullVolPath.c_str());
+  }
+
+  return true;
+}
+
+void UsdBridgeUsdWriter::RemoveUnusedKeyframe(const UsdAttribute& fileAttr, const std::string& keyframePath)
+{
+  // Timesteps with a delta refer to their keyframe from the field's file path, as does the keyframe's own timestep
+  std::vector<double> fileTimes;
+  fileAttr.GetTimeSamples(&fileTimes);
+
+  SdfAssetPath volAsset;
+  for (double fileTime : fileTimes)
+  {
+    if (fileAttr.Get(&volAsset, fileTime) && volAsset.GetAssetPath() == keyframePath)
+      return;
+  }
+  if (fileAttr.Get(&volAsset, UsdTimeCode::Default()) && volAsset.GetAssetPath() == keyframePath)
+    return;
+
+  FileRemover->RemoveFile(SessionDirectory + keyframePath);
+}
+
+bool UsdBridgeUsdWriter::WriteVolumeStoreAsset(UsdAttribute& fileAttr, const VolumeEncodeFunc& encodeVolume, const UsdTimeCode& timeCode)
+{
+  // Streamed through the connection, so the encoded file is never held in memory as a whole
+  std::string relVolPath;
+  if (!AssetStore->AddAsset(encodeVolume, ".vdb", relVolPath))
+  {
+    UsdBridgeLogMacro(this, UsdBridgeLogLevel::ERR, "Failed writing volume file " << relVolPath);
+    return false;
+  }
+
+  SetVolumeFilePath(fileAttr, relVolPath, false, timeCode);
+
+  return true;
+}
+
+void UsdBridgeUsdWriter::SetVolumeFilePath(UsdAttribute& fileAttr, const std::string& relVolPath, bool addStoreRef, const UsdTimeCode& timeCode)
+{
+  if (AssetStore)
+  {
+    if (addStoreRef)
+      AssetStore->AddAssetRef(relVolPath);
+
+    // Release the asset that is replaced (after adding the new one, in case they are the same)
+    SdfAssetPath prevVolAsset;
+    if (GetAuthoredValue(fileAttr, timeCode, prevVolAsset))
+      AssetStore->ReleaseAsset(prevVolAsset.GetAssetPath());
+  }
+
+  fileAttr.Set(SdfAssetPath(relVolPath), timeCode);
 }
 
 void UsdBridgeUsdWriter::UpdateUsdSampler(const SdfPath& samplerPrimPath, const UsdBridgeSamplerData& samplerData, double timeStep)
@@ -2564,6 +3666,8 @@ void UsdBridgeUsdWriter::UpdateUsdSampler(const SdfPath& samplerPrimPath, const
   UsdShadeShader texReaderPrim = UsdShadeShader::Get(this->SceneStage, samplerPrimPath);
   assert(texReaderPrim);
 
+  ChangeBlockScope changeBlock(this->BatchChanges);
+
   SdfAssetPath texFile(samplerData.FileName);
   texReaderPrim.CreateInput(UsdBridgeTokens->file, SdfValueTypeNames->Asset).Set(texFile, timeEval.Eval(DMI::FILENAME));
   texReaderPrim.CreateInput(UsdBridgeTokens->WrapS, SdfValueTypeNames->Token).Set(TextureWrapToken(samplerData.WrapS), timeEval.Eval(DMI::WRAPS));
@@ -2572,6 +3676,8 @@ void UsdBridgeUsdWriter::UpdateUsdSampler(const SdfPath& samplerPrimPath, const
 
 void UsdBridgeUsdWriter::UpdateBeginEndTime(double timeStep)
 {
+  CurrentTimeStep = timeStep;
+
   if (timeStep < StartTime)
   {
     StartTime = timeStep;
@@ -2586,11 +3692,7 @@ void UsdBridgeUsdWriter::UpdateBeginEndTime(double timeStep)
 
 void ResourceCollectVolume(const UsdBridgePrimCache* cache, const UsdBridgeUsdWriter& usdWriter)
 {
-#ifdef VALUE_CLIP_RETIMING
-  const UsdStageRefPtr& volumeStage = cache->PrimStage.second;
-#else
-  const UsdStageRefPtr& volumeStage = usdWriter.SceneStage;
-#endif
+  const UsdStageRefPtr& volumeStage = usdWriter.UsesPrimStages() ? cache->PrimStage.second : usdWriter.SceneStage;
 
   const SdfPath& volPrimPath = cache->PrimPath;
   const std::string& name = cache->Name.GetString();
@@ -2603,18 +3705,51 @@ void ResourceCollectVolume(const UsdBridgePrimCache* cache, const UsdBridgeUsdWr
 
   UsdAttribute fileAttr = ovdbField.GetFilePathAttr();
 
-  std::vector<double> fileTimes;
-  fileAttr.GetTimeSamples(&fileTimes);
+  UsdVolOpenVDBAsset ovdbDelta = UsdVolOpenVDBAsset::Get(volumeStage, volPrimPath.AppendPath(SdfPath(openVDBDeltaPrimPf)));
+  UsdAttribute deltaFileAttr = ovdbDelta ? ovdbDelta.GetFilePathAttr() : UsdAttribute();
 
-  for (double timeStep : fileTimes)
+  if (usdWriter.VolumeBricks)
+    usdWriter.VolumeBricks->RemoveVolume(name);
+
+  std::vector<UsdAttribute> fileAttrs = { fileAttr, deltaFileAttr };
+  for (int lodLevel = 1; lodLevel <= UsdBridgeMaxVolumeLodLevels; ++lodLevel)
   {
-    std::string volFileName(usdWriter.SessionDirectory + std::string(volFolder) + name);
-#ifdef TIME_BASED_CACHING
-    volFileName += "_" + std::to_string(timeStep);
-#endif
-    volFileName += ".vdb";
+    UsdVolOpenVDBAsset ovdbLod = UsdVolOpenVDBAsset::Get(volumeStage, GetVolumeLodFieldPath(volPrimPath, lodLevel));
+    if (ovdbLod)
+      fileAttrs.push_back(ovdbLod.GetFilePathAttr());
+  }
+  for (const UsdAttribute& attr : fileAttrs)
+  {
+    if (!attr)
+      continue;
+
+    std::vector<double> fileTimes;
+    attr.GetTimeSamples(&fileTimes);
 
-    usdWriter.Connect->RemoveFile(volFileName.c_str());
+    if (usdWriter.AssetStore)
+    {
+      // Stored assets are shared, so only drop the references to them
+      SdfAssetPath volAsset;
+      for (double timeStep : fileTimes)
+      {
+        if (attr.Get(&volAsset, timeStep))
+          usdWriter.AssetStore->ReleaseAsset(volAsset.GetAssetPath());
+      }
+      if (attr.Get(&volAsset, UsdTimeCode::Default()))
+        usdWriter.AssetStore->ReleaseAsset(volAsset.GetAssetPath());
+      continue;
+    }
+
+    // The referenced files are removed, as keyframe file names are not derived from the timestep alone
+    std::set<std::string> volFiles;
+    SdfAssetPath volAsset;
+    for (double timeStep : fileTimes)
+    {
+      if (attr.Get(&volAsset, timeStep) && !volAsset.GetAssetPath().empty())
+        volFiles.insert(volAsset.GetAssetPath());
+    }
+    for (const std::string& volFile : volFiles)
+      usdWriter.FileRemover->RemoveFile(usdWriter.SessionDirectory + volFile);
   }
 }
 
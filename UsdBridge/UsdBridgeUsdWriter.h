@@ -11,8 +11,14 @@ PXR_NAMESPACE_USING_DIRECTIVE
 #include "UsdBridgeCaches.h"
 #include "UsdBridgeVolumeWriter.h"
 #include "UsdBridgeConnection.h"
+#include "UsdBridgeAssetStore.h"
+#include "UsdBridgeVolumeBricks.h"
+#include "UsdBridgeFileRemover.h"
+#include "UsdBridgeTimeSamples.h"
 
 #include <functional>
+#include <map>
+#include <set>
 
 typedef std::pair<UsdStageRefPtr, bool> StageCreatePair;
 
@@ -33,6 +39,15 @@ public:
 
   void SetSceneStage(UsdStageRefPtr sceneStage);
   void SetEnableSaving(bool enableSaving);
+  // Defers change processing of value updates to the end of each update call
+  void SetBatchChanges(bool batchChanges);
+  // Drops time samples of transforms and material values that linear interpolation reproduces within tolerance, 0 disables
+  void SetTimeSampleTolerance(double tolerance);
+  // Defers saves of prim and clip stages to FlushStageSaves(), which writes them concurrently
+  void SetParallelWrites(bool parallelWrites);
+  // Bounds the estimated size of the clip stages held in memory, 0 disables
+  void SetMemoryBudget(uint64_t budgetMB);
+  uint64_t GetTimeVarBytes() const { return TimeVarBytes; }
 
   int FindSessionNumber();
   bool CreateDirectories();
@@ -42,11 +57,27 @@ public:
   bool InitializeSession();
   void ResetSession();
 
+  // The session journal records the last timestep for which all output was saved, to resume a session from.
+  bool ReadSessionJournal();
+  bool CommitSessionJournal(double savedTimeStep);
+  bool GetResumeTimeStep(double& timeStep) const;
+  double GetCurrentTimeStep() const { return CurrentTimeStep; }
+  // Removes the output that a resumed session wrote after its journaled timestep
+  void TruncateResumedLayer(const SdfLayerHandle& layer);
+  void TruncateResumedClips();
+
   bool OpenSceneStage();
+  void SaveSceneStage();
   UsdStageRefPtr GetSceneStage();
+  // Time layout of the session, as selected by Settings.TimeLayout within the layouts compiled in
+  bool UsesPrimStages() const { return TimeLayout != UsdBridgeTimeLayout::SCENE_STAGE; }
+  bool UsesClipStages() const { return TimeLayout == UsdBridgeTimeLayout::CLIP_STAGES; }
+  // Saves a stage returned by GetTimeVarStage, or defers the save to FlushStageSaves() with parallel writes
+  void SaveTimeVarStage(const UsdStageRefPtr& timeVarStage);
+  void FlushStageSaves();
   StageCreatePair GetTimeVarStage(UsdBridgePrimCache* cache
 #ifdef TIME_CLIP_STAGES
-    // If useClipStages, StageCreatePair.second is true when the clipStage is newly created (to signify need for prim initialization)
+    // StageCreatePair.second is true when the prim still has to be initialized on the returned stage; clip stages copy it from the manifest
     , bool useClipStage = false, const char* clipPf = nullptr, double timeStep = 0.0
 #endif
     );
@@ -57,7 +88,15 @@ public:
 #endif
 #ifdef TIME_CLIP_STAGES
   const UsdStagePair& FindOrCreatePrimClipStage(UsdBridgePrimCache* cacheEntry, const char* clipPostfix, double timeStep, bool& exists);
+  // Relative file name of the clip stage of a timestep, without reopening it when released
+  const std::string& FindOrCreatePrimClipFileName(UsdBridgePrimCache* cacheEntry, const char* clipPostfix, double timeStep, bool& exists);
+  // With Settings.MappedArrays, drops the in-memory clip stage of a timestep after it has been saved
+  void ReleasePrimClipStage(UsdBridgePrimCache* cacheEntry, double timeStep);
 #endif
+  // Accounts the timevarying arrays authored by a geometry update, and spills the largest clip stages to disk while over the memory budget
+  void UpdateTimeVarFootprint(UsdBridgePrimCache* cacheEntry, const UsdBridgeMeshData& geomData, double timeStep);
+  void UpdateTimeVarFootprint(UsdBridgePrimCache* cacheEntry, const UsdBridgeInstancerData& geomData, double timeStep);
+  void UpdateTimeVarFootprint(UsdBridgePrimCache* cacheEntry, const UsdBridgeCurveData& geomData, double timeStep);
   void SetSceneGraphRoot(UsdBridgePrimCache* worldCache, const char* name);
   void RemoveSceneGraphRoot(UsdBridgePrimCache* worldCache);
 
@@ -96,12 +135,19 @@ public:
     double parentTimeStep, double childTimeStep,
     bool replaceExisting, // replaceExisting will make sure any other prims are gone
     const RefModFuncs& refModCallbacks);
+  // References protoCache's prim as a stand-in for childCache's own data, from an instanceable prim on the scenestage named after the child.
+  // Replaces any other references at the same location. Returns the path to the referencing prim.
+  SdfPath AddInstanceableRef(UsdBridgePrimCache* parentCache, UsdBridgePrimCache* childCache, UsdBridgePrimCache* protoCache, const char* refPathExt,
+    double parentTimeStep, const RefModFuncs& refModCallbacks);
   void RemoveAllRefs(UsdBridgePrimCache* parentCache, const char* refPathExt, bool timeVarying, double timeStep, AtRemoveRefFunc atRemoveRef);
   void RemoveAllRefs(UsdStageRefPtr stage, UsdBridgePrimCache* parentCache, const char* refPathExt, bool timeVarying, double timeStep, AtRemoveRefFunc atRemoveRef);
+  // Removes the references to children at refPathExt, as ManageUnusedRefs does for the children missing from its list
+  void RemoveRefs(UsdBridgePrimCache* parentCache, const UsdBridgePrimCacheList& children, const char* refPathExt, bool timeVarying, double timeStep, AtRemoveRefFunc atRemoveRef);
   void ManageUnusedRefs(UsdBridgePrimCache* parentCache, const UsdBridgePrimCacheList& newChildren, const char* refPathExt, bool timeVarying, double timeStep, AtRemoveRefFunc atRemoveRef);
   void ManageUnusedRefs(UsdStageRefPtr stage, UsdBridgePrimCache* parentCache, const UsdBridgePrimCacheList& newChildren, const char* refPathExt, bool timeVarying, double timeStep, AtRemoveRefFunc atRemoveRef);
 
   void InitializeUsdTransform(const UsdBridgePrimCache* cacheEntry);
+  void InitializeUsdGroupInstancer(const UsdBridgePrimCache* cacheEntry);
   UsdPrim InitializeUsdGeometry(UsdStageRefPtr geometryStage, const SdfPath& geomPath, const UsdBridgeMeshData& meshData, bool uniformPrim);
   UsdPrim InitializeUsdGeometry(UsdStageRefPtr geometryStage, const SdfPath& geomPath, const UsdBridgeInstancerData& instancerData, bool uniformPrim);
   UsdPrim InitializeUsdGeometry(UsdStageRefPtr geometryStage, const SdfPath& geomPath, const UsdBridgeCurveData& curveData, bool uniformPrim);
@@ -126,6 +172,11 @@ public:
   void UnBindSamplerFromMaterial(const SdfPath& matPrimPath);
 
   void UpdateUsdTransform(const SdfPath& transPrimPath, float* transform, bool timeVarying, double timeStep);
+  // Authors the transforms of all instanceCaches directly in the layer specs, with a column-major 3x4 matrix per instance in transforms
+  void UpdateUsdTransforms(const UsdBridgePrimCacheList& instanceCaches, const float* transforms, bool timeVarying, double timeStep);
+  // protoCaches correspond to groupInstances.Groups, referenced from the instancer's children at protoPathExt
+  void UpdateUsdGroupInstancer(const UsdBridgePrimCache* instancerCache, const char* protoPathExt, const UsdBridgePrimCacheList& protoCaches,
+    const UsdBridgeGroupInstancesData& groupInstances, bool timeVarying, double timeStep);
   void UpdateUsdGeometry(const UsdStagePtr& timeVarStage, const SdfPath& meshPath, const UsdBridgeMeshData& geomData, double timeStep);
   void UpdateUsdGeometry(const UsdStagePtr& timeVarStage, const SdfPath& instancerPath, const UsdBridgeInstancerData& geomData, double timeStep);
   void UpdateUsdGeometry(const UsdStagePtr& timeVarStage, const SdfPath& curvePath, const UsdBridgeCurveData& geomData, double timeStep);
@@ -135,8 +186,21 @@ public:
   void UpdateMdlShader(UsdStageRefPtr shaderStage, const SdfPath& shadPrimPath, const UsdBridgeMaterialData& matData, double timeStep);
 #endif
   void UpdateUsdVolume(UsdStageRefPtr volumeStage, const SdfPath& volPrimPath, const std::string& name, const UsdBridgeVolumeData& volumeData, double timeStep);
+  // volumeData describes the full volume, with Data pointing to the region of regionDims at regionOffset
+  void UpdateUsdVolumeRegion(UsdStageRefPtr volumeStage, const SdfPath& volPrimPath, const std::string& name,
+    UsdBridgeVolumeRegions& volumeRegions, const UsdBridgeVolumeData& volumeData, const size_t* regionOffset, const size_t* regionDims, double timeStep);
+  void UpdateUsdVolumeTransform(UsdVolVolume& volume, const UsdBridgeVolumeData& volumeData, double timeStep);
+  typedef std::function<void(std::ostream& vdbOutput)> VolumeEncodeFunc;
+  bool WriteVolumeFile(UsdAttribute& fileAttr, const std::string& fileName, const VolumeEncodeFunc& encodeVolume, const UsdTimeCode& timeCode);
+  bool WriteVolumeStoreAsset(UsdAttribute& fileAttr, const VolumeEncodeFunc& encodeVolume, const UsdTimeCode& timeCode);
+  void RemoveUnusedKeyframe(const UsdAttribute& fileAttr, const std::string& keyframePath);
+  void SetVolumeFilePath(UsdAttribute& fileAttr, const std::string& relVolPath, bool addStoreRef, const UsdTimeCode& timeCode);
   void UpdateUsdSampler(const SdfPath& samplerPrimPath, const UsdBridgeSamplerData& samplerData, double timeStep);
   void UpdateBeginEndTime(double timeStep);
+  void CompactTimeSample(const SdfLayerHandle& layer, const SdfPath& attrSpecPath, const UsdTimeCode& timeCode);
+  void CompactTimeSample(const UsdAttribute& attrib, const UsdTimeCode& timeCode);
+  template<typename ValueType>
+  void SetShaderInput(const UsdShadeShader& shader, const TfToken& inputName, const ValueType& value, const UsdTimeCode& timeCode);
 
   void* LogUserData;
   UsdBridgeLogCallback LogCallback;
@@ -148,10 +212,23 @@ public:
   VtVec3fArray TempScalesArray;
 
 protected:
+  typedef std::pair<UsdBridgePrimCache*, double> TimeVarKey; // Prim and timestep
+
+  struct TimeVarFootprint
+  {
+    uint64_t NumBytes = 0;
+    std::map<uint32_t, uint64_t> MemberBytes; // Per data member id
+  };
+
+  template<typename GeomDataType>
+  void UpdateTimeVarFootprintTemplate(UsdBridgePrimCache* cacheEntry, const GeomDataType& geomData, double timeStep);
+  void RemoveTimeVarFootprint(const TimeVarKey& key);
+  void RemoveTimeVarFootprints(const UsdBridgePrimCache* cacheEntry);
 
   // Settings 
   UsdBridgeSettings Settings;
   UsdBridgeConnectionSettings ConnectionSettings;
+  UsdBridgeTimeLayout TimeLayout;
 
   // Connect
   std::unique_ptr<UsdBridgeConnection> Connect = nullptr;
@@ -159,10 +236,27 @@ protected:
   // Volume writer
   UsdBridgeVolumeWriter VolumeWriter;
 
+  // Content-addressed asset store, if enabled by Settings.DedupAssets
+  std::unique_ptr<UsdBridgeAssetStore> AssetStore;
+
+  // Per-volume brick change detection, if enabled by Settings.VolumeOutput.BrickDeltas
+  std::unique_ptr<UsdBridgeVolumeBrickTracker> VolumeBricks;
+
+  // Removes the files of garbage collected prims in the background, uses Connect
+  std::unique_ptr<UsdBridgeFileRemover> FileRemover;
+
   // Session specific info
   int SessionNumber = -1;
   UsdStageRefPtr SceneStage;
   bool EnableSaving = true;
+  bool BatchChanges = true;
+  bool ParallelWrites = false;
+  std::unordered_map<const SdfLayer*, SdfLayerRefPtr> DeferredLayerSaves; // Root layers of the stages to save, a released clip stage may be reopened on the same layer
+  uint64_t MemoryBudgetBytes = 0;
+  uint64_t TimeVarBytes = 0;
+  std::map<TimeVarKey, TimeVarFootprint> TimeVarFootprints; // Estimated size of the timevarying arrays of each prim timestep held in memory
+  std::set<std::pair<uint64_t, TimeVarKey>> ResidentClipsBySize; // Clip stages held in memory, ordered by size to spill the largest first
+  UsdBridgeTimeSampleCompactor TimeSampleCompactor;
   std::string SceneFileName;
   std::string RelativeSceneFile; // relative from Asset Folders
   std::string SessionDirectory;
@@ -175,6 +269,12 @@ protected:
 
   double StartTime = 0.0;
   double EndTime = 0.0;
+  double CurrentTimeStep = 0.0;
+
+  // Resuming a session keeps its existing output, up to the last journaled timestep
+  bool ResumeSession = false;
+  double ResumeTimeStep = 0.0;
+  bool SavesFailed = false; // Since the last journal commit
 
   std::string TempNameStr;
 };
@@ -3,6 +3,10 @@
 
 #include "UsdBridgeUtils.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
 const char* UsdBridgeTypeToString(UsdBridgeType type)
 {
   const char* typeStr = nullptr;
@@ -57,4 +61,164 @@ const char* UsdBridgeTypeToString(UsdBridgeType type)
     default: typeStr = "UNDEFINED"; break;
   }
   return typeStr;
-}
\ No newline at end of file
+}
+
+size_t UsdBridgeTypeSize(UsdBridgeType type)
+{
+  static const size_t fundamentalSizes[] = { 1, 1, 1, 2, 2, 4, 4, 8, 8, 2, 4, 8 }; // BOOL to DOUBLE
+  static_assert(sizeof(fundamentalSizes) / sizeof(size_t) == UsdBridgeNumFundamentalTypes, "Fundamental type sizes out of date");
+
+  int typeIdx = (int)type;
+  if (type == UsdBridgeType::UNDEFINED)
+    return 0;
+  if (typeIdx < UsdBridgeNumFundamentalTypes)
+    return fundamentalSizes[typeIdx];
+
+  // Vector types start at 2 components, and have no BOOL variant
+  int vecIdx = typeIdx - UsdBridgeNumFundamentalTypes;
+  int numVecBaseTypes = UsdBridgeNumFundamentalTypes - 1;
+  return fundamentalSizes[1 + vecIdx % numVecBaseTypes] * (2 + vecIdx / numVecBaseTypes);
+}
+
+void UsdBridgeVolumeDataStrides(const UsdBridgeVolumeData& volumeData, int64_t* strides)
+{
+  const int64_t* dataStrides = volumeData.DataStrides;
+  const size_t* dims = volumeData.NumElements;
+  strides[0] = dataStrides[0] ? dataStrides[0] : (int64_t)UsdBridgeTypeSize(volumeData.DataType);
+  strides[1] = dataStrides[1] ? dataStrides[1] : strides[0] * (int64_t)dims[0];
+  strides[2] = dataStrides[2] ? dataStrides[2] : strides[1] * (int64_t)dims[1];
+}
+
+namespace
+{
+  inline uint64_t RotateLeft(uint64_t x, int r)
+  {
+    return (x << r) | (x >> (64 - r));
+  }
+
+  inline uint64_t FinalMix(uint64_t k)
+  {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdull;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ull;
+    k ^= k >> 33;
+    return k;
+  }
+
+  // MurmurHash3 x64 128
+  void MurmurHash128(const void* data, size_t size, uint64_t seed1, uint64_t seed2, uint64_t& outH1, uint64_t& outH2)
+  {
+    const uint64_t c1 = 0x87c37b91114253d5ull;
+    const uint64_t c2 = 0x4cf5ad432745937full;
+
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    size_t numBlocks = size / 16;
+
+    uint64_t h1 = seed1;
+    uint64_t h2 = seed2;
+
+    for (size_t i = 0; i < numBlocks; ++i)
+    {
+      uint64_t k1, k2;
+      std::memcpy(&k1, bytes + i * 16, 8);
+      std::memcpy(&k2, bytes + i * 16 + 8, 8);
+
+      k1 *= c1; k1 = RotateLeft(k1, 31); k1 *= c2; h1 ^= k1;
+      h1 = RotateLeft(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+
+      k2 *= c2; k2 = RotateLeft(k2, 33); k2 *= c1; h2 ^= k2;
+      h2 = RotateLeft(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    // Remaining bytes, in little-endian lane order
+    const unsigned char* tail = bytes + numBlocks * 16;
+    size_t numTail = size & 15;
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+    for (size_t i = numTail; i > 8; --i)
+      k2 ^= uint64_t(tail[i - 1]) << ((i - 9) * 8);
+    for (size_t i = (numTail < 8 ? numTail : 8); i > 0; --i)
+      k1 ^= uint64_t(tail[i - 1]) << ((i - 1) * 8);
+    if (numTail > 8)
+    {
+      k2 *= c2; k2 = RotateLeft(k2, 33); k2 *= c1; h2 ^= k2;
+    }
+    if (numTail > 0)
+    {
+      k1 *= c1; k1 = RotateLeft(k1, 31); k1 *= c2; h1 ^= k1;
+    }
+
+    h1 ^= uint64_t(size);
+    h2 ^= uint64_t(size);
+    h1 += h2;
+    h2 += h1;
+    h1 = FinalMix(h1);
+    h2 = FinalMix(h2);
+    h1 += h2;
+    h2 += h1;
+
+    outH1 = h1;
+    outH2 = h2;
+  }
+
+  std::string HashToString(uint64_t h1, uint64_t h2)
+  {
+    static const char hexDigits[] = "0123456789abcdef";
+    std::string hashStr(32, '0');
+    for (int i = 0; i < 16; ++i)
+    {
+      hashStr[15 - i] = hexDigits[(h1 >> (i * 4)) & 0xf];
+      hashStr[31 - i] = hexDigits[(h2 >> (i * 4)) & 0xf];
+    }
+    return hashStr;
+  }
+}
+
+std::string UsdBridgeContentHash(const void* data, size_t size)
+{
+  uint64_t h1, h2;
+  MurmurHash128(data, size, 0, 0, h1, h2);
+
+  return HashToString(h1, h2);
+}
+
+uint64_t UsdBridgeHash64(const void* data, size_t size, uint64_t seed)
+{
+  uint64_t h1, h2;
+  MurmurHash128(data, size, seed, seed, h1, h2);
+  return h1;
+}
+
+void UsdBridgeHash128(const void* data, size_t size, uint64_t* hash)
+{
+  MurmurHash128(data, size, hash[0], hash[1], hash[0], hash[1]);
+}
+
+void UsdBridgeContentHasher::Update(const void* data, size_t size)
+{
+  const char* bytes = static_cast<const char*>(data);
+  NumBytes += size;
+  while (size > 0)
+  {
+    size_t numCopied = std::min(size, BlockSize - Block.size());
+    Block.append(bytes, numCopied);
+    bytes += numCopied;
+    size -= numCopied;
+
+    if (Block.size() == BlockSize)
+    {
+      UsdBridgeHash128(Block.data(), Block.size(), Hash);
+      Block.clear();
+    }
+  }
+}
+
+std::string UsdBridgeContentHasher::Finish()
+{
+  UsdBridgeHash128(Block.data(), Block.size(), Hash);
+  UsdBridgeHash128(&NumBytes, sizeof(NumBytes), Hash);
+  Block.clear();
+
+  return HashToString(Hash[0], Hash[1]);
+}
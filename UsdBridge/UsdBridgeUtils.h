@@ -6,6 +6,40 @@
 
 #include <UsdBridgeData.h>
 
+#include <cstdint>
+#include <string>
+
 const char* UsdBridgeTypeToString(UsdBridgeType type);
+size_t UsdBridgeTypeSize(UsdBridgeType type);
+
+// Byte strides of volumeData.Data along x, y and z, replacing zero entries of DataStrides by those of tightly packed data
+void UsdBridgeVolumeDataStrides(const UsdBridgeVolumeData& volumeData, int64_t* strides);
+
+// 128-bit content hash (MurmurHash3 x64 128) of a byte range, as 32 hexadecimal characters
+std::string UsdBridgeContentHash(const void* data, size_t size);
+
+// 64-bit hash of a byte range; pass the previous result as seed to hash a sequence of ranges
+uint64_t UsdBridgeHash64(const void* data, size_t size, uint64_t seed = 0);
+
+// 128-bit hash of a byte range, continuing from (and replacing) the two words of hash
+void UsdBridgeHash128(const void* data, size_t size, uint64_t* hash);
+
+// Content hash of a byte stream, as 32 hexadecimal characters. The stream is hashed in blocks of fixed size,
+// so the result does not depend on how it is split up over the calls to Update().
+class UsdBridgeContentHasher
+{
+  public:
+    void Update(const void* data, size_t size);
+    std::string Finish();
+
+    uint64_t GetNumBytes() const { return NumBytes; }
+
+  protected:
+    static constexpr size_t BlockSize = 1 << 16;
+
+    uint64_t Hash[2] = { 0, 0 };
+    uint64_t NumBytes = 0;
+    std::string Block;
+};
 
 #endif
\ No newline at end of file
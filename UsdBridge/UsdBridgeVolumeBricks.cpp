@@ -0,0 +1,143 @@
+// Copyright 2020 The Khronos Group
+// SPDX-License-Identifier: Apache-2.0
+
+#include "UsdBridgeVolumeBricks.h"
+#include "UsdBridgeUtils.h"
+#include "UsdBridgeTrace.h"
+
+#include <algorithm>
+
+namespace
+{
+  // Everything that affects the encoded file besides the voxel values
+  uint64_t HashVolumeLayout(const UsdBridgeVolumeData& volumeData)
+  {
+    uint64_t hash = UsdBridgeHash64(&volumeData.DataType, sizeof(volumeData.DataType));
+    hash = UsdBridgeHash64(volumeData.NumElements, sizeof(volumeData.NumElements), hash);
+    hash = UsdBridgeHash64(&volumeData.preClassified, sizeof(volumeData.preClassified), hash);
+    if (volumeData.preClassified)
+    {
+      hash = UsdBridgeHash64(volumeData.TfColors, volumeData.TfNumColors * UsdBridgeTypeSize(volumeData.TfColorsType), hash);
+      hash = UsdBridgeHash64(volumeData.TfOpacities, volumeData.TfNumOpacities * UsdBridgeTypeSize(volumeData.TfOpacitiesType), hash);
+      hash = UsdBridgeHash64(volumeData.TfValueRange, sizeof(volumeData.TfValueRange), hash);
+    }
+    return hash;
+  }
+
+  // Brick hashes chain the hashes of the brick's rows, visiting the data once in memory order
+  void HashVolumeBricks(const UsdBridgeVolumeData& volumeData, const size_t* numBricks, std::vector<uint64_t>& brickHashes)
+  {
+    const size_t brickDim = UsdBridgeVolumeBrickMask::BrickDim;
+    const size_t* dims = volumeData.NumElements;
+    const char* data = static_cast<const char*>(volumeData.Data);
+    size_t elemSize = UsdBridgeTypeSize(volumeData.DataType);
+    int64_t strides[3];
+    UsdBridgeVolumeDataStrides(volumeData, strides);
+    bool packedRows = (strides[0] == (int64_t)elemSize);
+
+    brickHashes.assign(numBricks[0] * numBricks[1] * numBricks[2], 0);
+
+    for (size_t z = 0; z < dims[2]; ++z)
+    {
+      for (size_t y = 0; y < dims[1]; ++y)
+      {
+        const char* row = data + (int64_t)z * strides[2] + (int64_t)y * strides[1];
+        uint64_t* rowBrickHashes = brickHashes.data() + ((z / brickDim) * numBricks[1] + y / brickDim) * numBricks[0];
+        for (size_t bx = 0; bx < numBricks[0]; ++bx)
+        {
+          size_t x = bx * brickDim;
+          size_t numX = std::min(brickDim, dims[0] - x);
+          if (packedRows)
+            rowBrickHashes[bx] = UsdBridgeHash64(row + x * elemSize, numX * elemSize, rowBrickHashes[bx]);
+          else
+          {
+            for (size_t i = x; i < x + numX; ++i)
+              rowBrickHashes[bx] = UsdBridgeHash64(row + (int64_t)i * strides[0], elemSize, rowBrickHashes[bx]);
+          }
+        }
+      }
+    }
+  }
+}
+
+bool UsdBridgeVolumeBrickTracker::Update(const std::string& volumeName, const UsdBridgeVolumeData& volumeData, float maxDeltaFraction,
+  const UsdBridgeVolumeBrickMask*& deltaMask)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeVolumeBrickTracker::Update");
+
+  const size_t brickDim = UsdBridgeVolumeBrickMask::BrickDim;
+  size_t numBricks[3];
+  for (int i = 0; i < 3; ++i)
+    numBricks[i] = (volumeData.NumElements[i] + brickDim - 1) / brickDim;
+
+  std::vector<uint64_t> brickHashes;
+  HashVolumeBricks(volumeData, numBricks, brickHashes);
+  uint64_t layoutHash = HashVolumeLayout(volumeData);
+
+  std::lock_guard<std::mutex> lock(VolumesMutex);
+
+  auto insertResult = Volumes.emplace(volumeName, VolumeState());
+  VolumeState& state = insertResult.first->second;
+  UsdBridgeVolumeBrickMask& changedBricks = state.ChangedBricks;
+
+  bool isDelta = !insertResult.second && state.LayoutHash == layoutHash && !state.KeyframeAsset.empty();
+  if (isDelta)
+  {
+    for (size_t i = 0; i < brickHashes.size(); ++i)
+    {
+      if (brickHashes[i] != state.BrickHashes[i] && !changedBricks.Bricks[i])
+      {
+        changedBricks.Bricks[i] = true;
+        ++state.NumChangedBricks;
+      }
+    }
+    isDelta = state.NumChangedBricks <= maxDeltaFraction * brickHashes.size();
+  }
+
+  if (!isDelta)
+  {
+    std::copy(numBricks, numBricks + 3, changedBricks.NumBricks);
+    changedBricks.Bricks.assign(brickHashes.size(), false);
+    state.NumChangedBricks = 0;
+    state.LayoutHash = layoutHash;
+    state.KeyframeAsset.clear();
+    state.KeyframeId = NextKeyframeId++;
+  }
+
+  state.BrickHashes.swap(brickHashes);
+
+  deltaMask = isDelta ? &changedBricks : nullptr;
+  return isDelta;
+}
+
+void UsdBridgeVolumeBrickTracker::SetKeyframeAsset(const std::string& volumeName, const std::string& assetPath)
+{
+  std::lock_guard<std::mutex> lock(VolumesMutex);
+
+  auto volumeIt = Volumes.find(volumeName);
+  if (volumeIt != Volumes.end())
+    volumeIt->second.KeyframeAsset = assetPath;
+}
+
+std::string UsdBridgeVolumeBrickTracker::GetKeyframeAsset(const std::string& volumeName) const
+{
+  std::lock_guard<std::mutex> lock(VolumesMutex);
+
+  auto volumeIt = Volumes.find(volumeName);
+  return volumeIt != Volumes.end() ? volumeIt->second.KeyframeAsset : std::string();
+}
+
+uint64_t UsdBridgeVolumeBrickTracker::GetKeyframeId(const std::string& volumeName) const
+{
+  std::lock_guard<std::mutex> lock(VolumesMutex);
+
+  auto volumeIt = Volumes.find(volumeName);
+  return volumeIt != Volumes.end() ? volumeIt->second.KeyframeId : 0;
+}
+
+void UsdBridgeVolumeBrickTracker::RemoveVolume(const std::string& volumeName)
+{
+  std::lock_guard<std::mutex> lock(VolumesMutex);
+
+  Volumes.erase(volumeName);
+}
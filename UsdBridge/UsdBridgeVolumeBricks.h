@@ -0,0 +1,49 @@
+// Copyright 2020 The Khronos Group
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UsdBridgeVolumeBricks_h
+#define UsdBridgeVolumeBricks_h
+
+#include "UsdBridgeData.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <mutex>
+
+// Detects which bricks of dense volume data change between updates, by hashing each brick of the incoming data.
+// Changed bricks accumulate until the next keyframe, so a keyframe file combined with a single delta file
+// (containing the current values of the accumulated bricks) reproduces the latest data.
+class UsdBridgeVolumeBrickTracker
+{
+  public:
+    // Returns true if the data of volumeName can be written as a delta to its keyframe, with deltaMask selecting
+    // the bricks changed since that keyframe. Returns false if a new keyframe is required: on the first update,
+    // when the layout or transfer function changes, or when more than maxDeltaFraction of the bricks have changed.
+    bool Update(const std::string& volumeName, const UsdBridgeVolumeData& volumeData, float maxDeltaFraction,
+      const UsdBridgeVolumeBrickMask*& deltaMask);
+
+    void SetKeyframeAsset(const std::string& volumeName, const std::string& assetPath);
+    std::string GetKeyframeAsset(const std::string& volumeName) const;
+    // Unique within the tracker for every keyframe started by Update(), to name keyframe files that deltas depend on
+    uint64_t GetKeyframeId(const std::string& volumeName) const;
+
+    void RemoveVolume(const std::string& volumeName);
+
+  protected:
+    struct VolumeState
+    {
+      uint64_t LayoutHash = 0;
+      std::vector<uint64_t> BrickHashes;
+      UsdBridgeVolumeBrickMask ChangedBricks; // Since the last keyframe
+      size_t NumChangedBricks = 0;
+      std::string KeyframeAsset;
+      uint64_t KeyframeId = 0;
+    };
+
+    std::unordered_map<std::string, VolumeState> Volumes;
+    uint64_t NextKeyframeId = 0;
+    mutable std::mutex VolumesMutex;
+};
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "UsdBridgeVolumeWriter.h"
 #include "UsdBridgeUtils.h"
+#include "UsdBridgeTrace.h"
 
 #ifdef USE_OPENVDB
 
@@ -17,10 +18,17 @@
 #include "openvdb/io/Stream.h"
 #include "openvdb/tools/Dense.h"
 #include "openvdb/tools/GridTransformer.h"
+#include "openvdb/tools/Prune.h"
+#include "openvdb/tools/Composite.h"
 #include "openvdb/tree/ValueAccessor.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 #include <assert.h>
 #include <limits>
+#include <algorithm>
+#include <cmath>
 
 #define UsdBridgeLogMacro(level, message) \
   { std::stringstream logStream; \
@@ -38,6 +46,40 @@ using ColorGridOutType = openvdb::Vec3fGrid;
 #endif
 using OpacityGridOutType = openvdb::FloatGrid;
 
+// Values of volume data by grid coordinate, with the byte strides of the data.
+// bBox is the bounding box of the data, which may be a region of the volume.
+template<typename DataType>
+struct VolumeDataAccessor
+{
+  VolumeDataAccessor(const UsdBridgeVolumeData& volumeData, const openvdb::CoordBBox& bBox)
+    : Data(static_cast<const char*>(volumeData.Data))
+    , Min(bBox.min())
+    , Dims(bBox.dim())
+  {
+    UsdBridgeVolumeDataStrides(volumeData, Strides);
+  }
+
+  inline const DataType& operator()(const openvdb::math::Coord& gridCoord) const
+  {
+    openvdb::math::Coord coord = gridCoord - Min;
+
+    assert(coord.x() >= 0 && coord.x() < Dims.x() &&
+      coord.y() >= 0 && coord.y() < Dims.y() &&
+      coord.z() >= 0 && coord.z() < Dims.z());
+    return *reinterpret_cast<const DataType*>(Data + coord.x() * Strides[0] + coord.y() * Strides[1] + coord.z() * Strides[2]);
+  }
+
+  bool IsPacked() const
+  {
+    return Strides[0] == (int64_t)sizeof(DataType) && Strides[1] == Strides[0] * Dims.x() && Strides[2] == Strides[1] * Dims.y();
+  }
+
+  const char* Data;
+  openvdb::math::Coord Min;
+  openvdb::math::Coord Dims;
+  int64_t Strides[3];
+};
+
 struct TfTransformInput
 {
   ColorGridOutType::Ptr colorGrid;
@@ -52,8 +94,7 @@ struct TfTransform
 public:
   TfTransform(const UsdBridgeVolumeData& volumeData, const openvdb::CoordBBox& bBox, const TransformerType& transformer)
     : Transformer(transformer)
-    , VolData(static_cast<const DataType*>(volumeData.Data))
-    , Dims(bBox.max() + openvdb::math::Coord(1, 1, 1)) //Bbox is inclusive, dims are exclusive
+    , VolData(volumeData, bBox)
     , InvValueRangeMag(OpType(1.0) / (OpType)(volumeData.TfValueRange[1] - volumeData.TfValueRange[0]))
     , ValueRangeMin((OpType)(volumeData.TfValueRange[0]))
   {
@@ -61,15 +102,7 @@ public:
 
   inline void operator()(const typename TransformerType::Iter& iter) const
   {
-    openvdb::math::Coord coord = iter.getCoord();
-
-    assert(coord.x() >= 0 && coord.x() < Dims.x() &&
-      coord.y() >= 0 && coord.y() < Dims.y() &&
-      coord.z() >= 0 && coord.z() < Dims.z());
-    size_t linearIndex = Dims.y() * Dims.x() * coord.z() + Dims.x() * coord.y() + coord.x();
-    const DataType* curVal = VolData + linearIndex;
-
-    OpType ucVal = (((OpType)(*curVal)) - this->ValueRangeMin) * this->InvValueRangeMag;
+    OpType ucVal = (((OpType)VolData(iter.getCoord())) - this->ValueRangeMin) * this->InvValueRangeMag;
     float normValue = (float)((ucVal < (OpType)0.0) ? (OpType)0.0 : ((ucVal > (OpType)1.0) ? (OpType)1.0 : ucVal));
 
     Transformer.Transform(normValue, iter);
@@ -97,8 +130,7 @@ public:
   */
 
   const TransformerType& Transformer;
-  const DataType* VolData;
-  openvdb::math::Coord Dims;
+  VolumeDataAccessor<DataType> VolData;
   OpType InvValueRangeMag;
   OpType ValueRangeMin;
 };
@@ -233,14 +265,19 @@ struct CopyToGridInput
 {
   const UsdBridgeVolumeData& volumeData;
   const openvdb::CoordBBox& bBox;
+  const UsdBridgeVolumeOutputSettings& outputSettings;
+  bool compactIntegers; // Keep 8/16-bit sources at their own precision, normalized only when written
 };
 
+// Grid of 8/16-bit values, with the tree configuration of the standard grids
+template<typename DataType>
+using CompactGrid = openvdb::Grid<typename openvdb::tree::Tree4<DataType, 5, 4, 3>::Type>;
+
 template<typename DataType>
 struct NormalizedToGridConvert
 {
   NormalizedToGridConvert(const UsdBridgeVolumeData& volumeData, const openvdb::CoordBBox& bBox)
-    : VolData(static_cast<const DataType*>(volumeData.Data))
-    , Dims(bBox.max() + openvdb::math::Coord(1, 1, 1)) //Bbox is inclusive, dims are exclusive
+    : VolData(volumeData, bBox)
     , MaxValue(std::numeric_limits<DataType>::max())
     , MinValue((float)(std::numeric_limits<DataType>::min()))
   {
@@ -248,19 +285,10 @@ struct NormalizedToGridConvert
 
   inline void operator()(const openvdb::FloatGrid::ValueOnIter& iter) const
   {
-    openvdb::math::Coord coord = iter.getCoord();
-
-    assert(coord.x() >= 0 && coord.x() < Dims.x() &&
-      coord.y() >= 0 && coord.y() < Dims.y() &&
-      coord.z() >= 0 && coord.z() < Dims.z());
-    size_t linearIndex = Dims.y() * Dims.x() * coord.z() + Dims.x() * coord.y() + coord.x();
-    const DataType* curVal = VolData + linearIndex;
-
-    iter.setValue((((float)(*curVal)) - MinValue) / (MaxValue - MinValue));
+    iter.setValue((((float)VolData(iter.getCoord())) - MinValue) / (MaxValue - MinValue));
   }
 
-  const DataType* VolData;
-  openvdb::math::Coord Dims;
+  VolumeDataAccessor<DataType> VolData;
   float MaxValue;
   float MinValue;
 };
@@ -277,9 +305,91 @@ openvdb::GridBase::Ptr NormalizedCopyToGridTemplate(const CopyToGridInput& copyI
   return floatGrid;
 }
 
+template<typename DataType>
+struct RangeToGridConvert
+{
+  RangeToGridConvert(const UsdBridgeVolumeData& volumeData, const openvdb::CoordBBox& bBox, double minValue, double maxValue)
+    : VolData(volumeData, bBox)
+    , MinValue(minValue)
+    , InvValueRangeMag(maxValue > minValue ? 1.0 / (maxValue - minValue) : 0.0)
+  {
+  }
+
+  inline void operator()(const openvdb::FloatGrid::ValueOnIter& iter) const
+  {
+    iter.setValue((float)((((double)VolData(iter.getCoord())) - MinValue) * InvValueRangeMag));
+  }
+
+  VolumeDataAccessor<DataType> VolData;
+  double MinValue;
+  double InvValueRangeMag;
+};
+
+// Integer data normalized to its actual value range, which is stored as grid metadata to recover the original values
+template<typename DataType>
+openvdb::GridBase::Ptr QuantizedCopyToGridTemplate(const CopyToGridInput& copyInput)
+{
+  VolumeDataAccessor<DataType> volData(copyInput.volumeData, copyInput.bBox);
+
+  DataType minValue = std::numeric_limits<DataType>::max();
+  DataType maxValue = std::numeric_limits<DataType>::lowest();
+  for (openvdb::CoordBBox::XYZIterator coordIt(copyInput.bBox); coordIt; ++coordIt)
+  {
+    const DataType& value = volData(*coordIt);
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+  }
+  if (copyInput.bBox.empty())
+    minValue = maxValue = 0;
+
+  openvdb::FloatGrid::Ptr floatGrid = openvdb::FloatGrid::create();
+  floatGrid->denseFill(copyInput.bBox, 0.0f, true);
+
+  RangeToGridConvert<DataType> gridConverter(copyInput.volumeData, copyInput.bBox, (double)minValue, (double)maxValue);
+  openvdb::tools::foreach(floatGrid->beginValueOn(), gridConverter);
+
+  floatGrid->insertMeta("valueRangeMin", openvdb::DoubleMetadata((double)minValue));
+  floatGrid->insertMeta("valueRangeMax", openvdb::DoubleMetadata((double)maxValue));
+
+  return floatGrid;
+}
+
+template<typename DataType, typename GridType>
+struct ValueToGridConvert
+{
+  ValueToGridConvert(const UsdBridgeVolumeData& volumeData, const openvdb::CoordBBox& bBox)
+    : VolData(volumeData, bBox)
+  {
+  }
+
+  inline void operator()(const typename GridType::ValueOnIter& iter) const
+  {
+    iter.setValue((typename GridType::ValueType)VolData(iter.getCoord()));
+  }
+
+  VolumeDataAccessor<DataType> VolData;
+};
+
+template<typename DataType, typename GridType>
+openvdb::GridBase::Ptr ConvertToGridTemplate(const CopyToGridInput& copyInput)
+{
+  typename GridType::Ptr scalarGrid = GridType::create();
+  scalarGrid->denseFill(copyInput.bBox, typename GridType::ValueType(0), true);
+
+  ValueToGridConvert<DataType, GridType> gridConverter(copyInput.volumeData, copyInput.bBox);
+  openvdb::tools::foreach(scalarGrid->beginValueOn(), gridConverter);
+  scalarGrid->pruneGrid(); // Restore sparsity of the background value, as with copyFromDense
+
+  return scalarGrid;
+}
+
 template<typename DataType, typename GridType>
 openvdb::GridBase::Ptr CopyToGridTemplate(const CopyToGridInput& copyInput)
 {
+  // Strided data (ie. one field of interleaved volume data) is gathered voxel by voxel
+  if (!VolumeDataAccessor<DataType>(copyInput.volumeData, copyInput.bBox).IsPacked())
+    return ConvertToGridTemplate<DataType, GridType>(copyInput);
+
   typename GridType::Ptr scalarGrid = GridType::create();
 
   openvdb::tools::Dense<const DataType, openvdb::tools::LayoutXYZ> valArray(copyInput.bBox, static_cast<const DataType*>(copyInput.volumeData.Data));
@@ -295,40 +405,51 @@ static openvdb::GridBase::Ptr CopyToGrid(const CopyToGridInput& copyInput)
   switch (copyInput.volumeData.DataType)
   {
   case UsdBridgeType::CHAR:
-    scalarGrid = NormalizedCopyToGridTemplate<char>(copyInput);
+    scalarGrid = copyInput.compactIntegers ? CopyToGridTemplate<char, CompactGrid<char>>(copyInput)
+      : NormalizedCopyToGridTemplate<char>(copyInput);
     break;
   case UsdBridgeType::UCHAR:
-    scalarGrid = NormalizedCopyToGridTemplate<unsigned char>(copyInput);
+    scalarGrid = copyInput.compactIntegers ? CopyToGridTemplate<unsigned char, CompactGrid<unsigned char>>(copyInput)
+      : NormalizedCopyToGridTemplate<unsigned char>(copyInput);
     break;
   case UsdBridgeType::SHORT:
-    scalarGrid = NormalizedCopyToGridTemplate<short>(copyInput);
+    scalarGrid = copyInput.compactIntegers ? CopyToGridTemplate<short, CompactGrid<short>>(copyInput)
+      : NormalizedCopyToGridTemplate<short>(copyInput);
     break;
   case UsdBridgeType::USHORT:
-    scalarGrid = NormalizedCopyToGridTemplate<unsigned short>(copyInput);
+    scalarGrid = copyInput.compactIntegers ? CopyToGridTemplate<unsigned short, CompactGrid<unsigned short>>(copyInput)
+      : NormalizedCopyToGridTemplate<unsigned short>(copyInput);
     break;
   case UsdBridgeType::INT:
-    scalarGrid = CopyToGridTemplate<int, openvdb::Int32Grid>(copyInput);
+    scalarGrid = copyInput.outputSettings.QuantizeIntegers ? QuantizedCopyToGridTemplate<int>(copyInput)
+      : CopyToGridTemplate<int, openvdb::Int32Grid>(copyInput);
     break;
   case UsdBridgeType::UINT:
-    scalarGrid = CopyToGridTemplate<unsigned int, openvdb::Int32Grid>(copyInput);
+    scalarGrid = copyInput.outputSettings.QuantizeIntegers ? QuantizedCopyToGridTemplate<unsigned int>(copyInput)
+      : CopyToGridTemplate<unsigned int, openvdb::Int32Grid>(copyInput);
     break;
   case UsdBridgeType::LONG:
-    scalarGrid = CopyToGridTemplate<long long, openvdb::Int64Grid>(copyInput);
+    scalarGrid = copyInput.outputSettings.QuantizeIntegers ? QuantizedCopyToGridTemplate<long long>(copyInput)
+      : CopyToGridTemplate<long long, openvdb::Int64Grid>(copyInput);
     break;
   case UsdBridgeType::ULONG:
-    scalarGrid = CopyToGridTemplate<unsigned long long, openvdb::Int64Grid>(copyInput);
+    scalarGrid = copyInput.outputSettings.QuantizeIntegers ? QuantizedCopyToGridTemplate<unsigned long long>(copyInput)
+      : CopyToGridTemplate<unsigned long long, openvdb::Int64Grid>(copyInput);
     break;
   case UsdBridgeType::FLOAT:
     scalarGrid = CopyToGridTemplate<float, openvdb::FloatGrid>(copyInput);
     break;
   case UsdBridgeType::DOUBLE:
-    scalarGrid = CopyToGridTemplate<double, openvdb::DoubleGrid>(copyInput);
+    // Double precision is lost on half output anyway
+    scalarGrid = copyInput.outputSettings.HalfPrecision ? ConvertToGridTemplate<double, openvdb::FloatGrid>(copyInput)
+      : CopyToGridTemplate<double, openvdb::DoubleGrid>(copyInput);
     break;
   case UsdBridgeType::FLOAT3:
     scalarGrid = CopyToGridTemplate<openvdb::Vec3f, openvdb::Vec3fGrid>(copyInput);
     break;
   case UsdBridgeType::DOUBLE3:
-    scalarGrid = CopyToGridTemplate<openvdb::Vec3d, openvdb::Vec3dGrid>(copyInput);
+    scalarGrid = copyInput.outputSettings.HalfPrecision ? ConvertToGridTemplate<openvdb::Vec3d, openvdb::Vec3fGrid>(copyInput)
+      : CopyToGridTemplate<openvdb::Vec3d, openvdb::Vec3dGrid>(copyInput);
     break;
   default:
     {
@@ -350,35 +471,187 @@ UsdBridgeVolumeWriter::~UsdBridgeVolumeWriter()
   
 }
 
-bool UsdBridgeVolumeWriter::Initialize(UsdBridgeLogCallback logCallback, void* logUserData)
+template<typename GridType>
+bool ClipGridToBricks(const openvdb::GridBase::Ptr& grid, const openvdb::MaskGrid& brickGrid)
+{
+  typename GridType::Ptr typedGrid = openvdb::gridPtrCast<GridType>(grid);
+  if (!typedGrid)
+    return false;
+
+  // All voxels of the selected bricks are activated, so values equal to the background still replace keyframe values
+  typedGrid->tree().topologyUnion(brickGrid.tree());
+  typedGrid->tree().topologyIntersection(brickGrid.tree());
+  openvdb::tools::pruneInactive(typedGrid->tree());
+
+  return true;
+}
+
+static void ClipGridsToBricks(openvdb::GridPtrVec& grids, const UsdBridgeVolumeBrickMask& brickMask, const openvdb::CoordBBox& bBox)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeVolumeWriter::ClipGridsToBricks");
+
+  const int brickDim = (int)UsdBridgeVolumeBrickMask::BrickDim;
+  const size_t* numBricks = brickMask.NumBricks;
+
+  openvdb::MaskGrid::Ptr brickGrid = openvdb::MaskGrid::create();
+  size_t brickIdx = 0;
+  for (int bz = 0; bz < (int)numBricks[2]; ++bz)
+  {
+    for (int by = 0; by < (int)numBricks[1]; ++by)
+    {
+      for (int bx = 0; bx < (int)numBricks[0]; ++bx, ++brickIdx)
+      {
+        if (!brickMask.Bricks[brickIdx])
+          continue;
+
+        openvdb::Coord brickMin(bx * brickDim, by * brickDim, bz * brickDim);
+        openvdb::Coord brickMax = openvdb::Coord::minComponent(brickMin.offsetBy(brickDim - 1), bBox.max());
+        brickGrid->fill(openvdb::CoordBBox(brickMin, brickMax), true, true);
+      }
+    }
+  }
+
+  for (openvdb::GridBase::Ptr& grid : grids)
+  {
+    bool clipped = ClipGridToBricks<openvdb::FloatGrid>(grid, *brickGrid)
+      || ClipGridToBricks<openvdb::DoubleGrid>(grid, *brickGrid)
+      || ClipGridToBricks<openvdb::Int32Grid>(grid, *brickGrid)
+      || ClipGridToBricks<openvdb::Int64Grid>(grid, *brickGrid)
+      || ClipGridToBricks<openvdb::Vec3fGrid>(grid, *brickGrid)
+      || ClipGridToBricks<openvdb::Vec3dGrid>(grid, *brickGrid);
+    assert(clipped); (void)clipped;
+  }
+}
+
+template<typename ComponentType, int NumComponents>
+void DownsampleTemplate(const UsdBridgeVolumeData& volumeData, const size_t* lodDims, UsdBridgeVolumeLodFilter filter, char* lodData)
+{
+  const char* srcData = static_cast<const char*>(volumeData.Data);
+  ComponentType* dstData = reinterpret_cast<ComponentType*>(lodData);
+  const size_t* srcDims = volumeData.NumElements;
+  int64_t srcStrides[3];
+  UsdBridgeVolumeDataStrides(volumeData, srcStrides);
+
+  // Each output slice reads its own pair of input slices
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, lodDims[2]), [&](const tbb::blocked_range<size_t>& zRange)
+  {
+    for (size_t z = zRange.begin(); z != zRange.end(); ++z)
+    {
+      size_t srcZEnd = std::min(2 * z + 2, srcDims[2]);
+      for (size_t y = 0; y < lodDims[1]; ++y)
+      {
+        size_t srcYEnd = std::min(2 * y + 2, srcDims[1]);
+        for (size_t x = 0; x < lodDims[0]; ++x)
+        {
+          size_t srcXEnd = std::min(2 * x + 2, srcDims[0]);
+
+          // Edge cells of odd dimensions only cover the available source cells
+          double accum[NumComponents];
+          for (int c = 0; c < NumComponents; ++c)
+            accum[c] = (filter == UsdBridgeVolumeLodFilter::MAX) ? (double)std::numeric_limits<ComponentType>::lowest() : 0.0;
+          int numSrc = 0;
+
+          for (size_t srcZ = 2 * z; srcZ < srcZEnd; ++srcZ)
+          {
+            for (size_t srcY = 2 * y; srcY < srcYEnd; ++srcY)
+            {
+              const char* srcRow = srcData + (int64_t)srcZ * srcStrides[2] + (int64_t)srcY * srcStrides[1];
+              for (size_t srcX = 2 * x; srcX < srcXEnd; ++srcX, ++numSrc)
+              {
+                const ComponentType* srcVal = reinterpret_cast<const ComponentType*>(srcRow + (int64_t)srcX * srcStrides[0]);
+                for (int c = 0; c < NumComponents; ++c)
+                {
+                  if (filter == UsdBridgeVolumeLodFilter::MAX)
+                    accum[c] = std::max(accum[c], (double)srcVal[c]);
+                  else
+                    accum[c] += (double)srcVal[c];
+                }
+              }
+            }
+          }
+
+          ComponentType* dstVal = dstData + ((z * lodDims[1] + y) * lodDims[0] + x) * NumComponents;
+          for (int c = 0; c < NumComponents; ++c)
+          {
+            double value = (filter == UsdBridgeVolumeLodFilter::MAX) ? accum[c] : accum[c] / numSrc;
+            dstVal[c] = std::numeric_limits<ComponentType>::is_integer ? (ComponentType)std::llround(value) : (ComponentType)value;
+          }
+        }
+      }
+    }
+  });
+}
+
+bool UsdBridgeVolumeWriter::Downsample(const UsdBridgeVolumeData& volumeData, UsdBridgeVolumeData& lodVolumeData, std::vector<char>& lodData)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeVolumeWriter::Downsample");
+
+  lodVolumeData = volumeData;
+  for (int i = 0; i < 3; ++i)
+  {
+    lodVolumeData.NumElements[i] = (volumeData.NumElements[i] + 1) / 2;
+    lodVolumeData.DataStrides[i] = 0;
+  }
+
+  const size_t* lodDims = lodVolumeData.NumElements;
+  lodData.resize(lodDims[0] * lodDims[1] * lodDims[2] * UsdBridgeTypeSize(volumeData.DataType));
+  lodVolumeData.Data = lodData.data();
+
+  UsdBridgeVolumeLodFilter filter = OutputSettings.LodFilter;
+  switch (volumeData.DataType)
+  {
+  case UsdBridgeType::CHAR: DownsampleTemplate<char, 1>(volumeData, lodDims, filter, lodData.data()); break;
+  case UsdBridgeType::UCHAR: DownsampleTemplate<unsigned char, 1>(volumeData, lodDims, filter, lodData.data()); break;
+  case UsdBridgeType::SHORT: DownsampleTemplate<short, 1>(volumeData, lodDims, filter, lodData.data()); break;
+  case UsdBridgeType::USHORT: DownsampleTemplate<unsigned short, 1>(volumeData, lodDims, filter, lodData.data()); break;
+  case UsdBridgeType::INT: DownsampleTemplate<int, 1>(volumeData, lodDims, filter, lodData.data()); break;
+  case UsdBridgeType::UINT: DownsampleTemplate<unsigned int, 1>(volumeData, lodDims, filter, lodData.data()); break;
+  case UsdBridgeType::LONG: DownsampleTemplate<long long, 1>(volumeData, lodDims, filter, lodData.data()); break;
+  case UsdBridgeType::ULONG: DownsampleTemplate<unsigned long long, 1>(volumeData, lodDims, filter, lodData.data()); break;
+  case UsdBridgeType::FLOAT: DownsampleTemplate<float, 1>(volumeData, lodDims, filter, lodData.data()); break;
+  case UsdBridgeType::DOUBLE: DownsampleTemplate<double, 1>(volumeData, lodDims, filter, lodData.data()); break;
+  case UsdBridgeType::FLOAT3: DownsampleTemplate<float, 3>(volumeData, lodDims, filter, lodData.data()); break;
+  case UsdBridgeType::DOUBLE3: DownsampleTemplate<double, 3>(volumeData, lodDims, filter, lodData.data()); break;
+  default:
+    {
+      const char* typeStr = UsdBridgeTypeToString(volumeData.DataType);
+      UsdBridgeLogMacro(UsdBridgeLogLevel::WARNING, "Volume LOD downsampling does not support source data type: " << typeStr);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool UsdBridgeVolumeWriter::Initialize(const UsdBridgeVolumeOutputSettings& outputSettings, UsdBridgeLogCallback logCallback, void* logUserData)
 {
   openvdb::initialize();
 
+  OutputSettings = outputSettings;
+
   UsdBridgeVolumeWriter::LogCallback = logCallback;
   UsdBridgeVolumeWriter::LogUserData = logUserData;
 
   return true;
 }
 
-void UsdBridgeVolumeWriter::ToVDB(const UsdBridgeVolumeData& volumeData, std::ostream& vdbOutput)
+struct UsdBridgeVolumeGrids
 {
-  const char* densityGridName = "density";
-  const char* colorGridName = "diffuse";
-
-  // Keep the grid/tree transform at identity, and set coord bounding box to element dimensions. 
-  // This will correspond to a worldspace size of element dimensions too, with rest of scaling handled outside of openvdb.
-  const size_t* coordDims = volumeData.NumElements;
-  size_t maxInt = std::numeric_limits<int>::max();
-  assert(coordDims[0] <= maxInt && coordDims[1] <= maxInt && coordDims[2] <= maxInt);
-
-  //openvdb::Mat4R mat; mat.setToScale(openvdb::Vec3f(1.0f, 1.0f, 1.0f));
-  //colorGrid->setTransform(openvdb::math::Transform::createLinearTransform(mat));
+  openvdb::GridPtrVecPtr Grids;
+  openvdb::CoordBBox BBox;
+};
 
-  // Wrap data in a Dense and copy to color grid
-  openvdb::CoordBBox bBox(0, 0, 0, int(coordDims[0] - 1), int(coordDims[1] - 1), int(coordDims[2] - 1)); //Fill is inclusive
+void UsdBridgeVolumeGridsDeleter::operator()(UsdBridgeVolumeGrids* grids) const
+{
+  delete grids;
+}
 
-  // Prepare output grids
-  openvdb::GridPtrVecPtr grids(new openvdb::GridPtrVec);
+// Grids of volume data, which may be a region of the volume at bBox (in coordinates of the full volume)
+static void CreateGrids(const UsdBridgeVolumeData& volumeData, const openvdb::CoordBBox& bBox, const UsdBridgeVolumeOutputSettings& outputSettings,
+  bool compactIntegers, openvdb::GridPtrVec& grids)
+{
+  const char* densityGridName = "density";
+  const char* colorGridName = "diffuse";
 
   if(volumeData.preClassified)
   {
@@ -403,12 +676,12 @@ void UsdBridgeVolumeWriter::ToVDB(const UsdBridgeVolumeData& volumeData, std::os
     colorGrid->setName(colorGridName);
 
     // Push color and opacity grid into grid container
-    grids->push_back(opacityGrid);
-    grids->push_back(colorGrid);
+    grids.push_back(opacityGrid);
+    grids.push_back(colorGrid);
   }
   else
   {
-    CopyToGridInput copyToGridInput = { volumeData, bBox };
+    CopyToGridInput copyToGridInput = { volumeData, bBox, outputSettings, compactIntegers };
     openvdb::GridBase::Ptr outGrid = CopyToGrid(copyToGridInput);
 
     if (outGrid)
@@ -416,12 +689,196 @@ void UsdBridgeVolumeWriter::ToVDB(const UsdBridgeVolumeData& volumeData, std::os
       outGrid->setName(densityGridName);
 
       // Push density grid into grid container
-      grids->push_back(outGrid);
+      grids.push_back(outGrid);
     }
   }
+}
+
+template<typename GridType>
+bool MergeGridTemplate(const openvdb::GridBase::Ptr& grid, const openvdb::GridBase::Ptr& regionGrid)
+{
+  typename GridType::Ptr typedGrid = openvdb::gridPtrCast<GridType>(grid);
+  typename GridType::Ptr typedRegionGrid = openvdb::gridPtrCast<GridType>(regionGrid);
+  if (!typedGrid || !typedRegionGrid)
+    return false;
+
+  openvdb::tools::compReplace(*typedGrid, *typedRegionGrid);
+
+  return true;
+}
+
+static void MergeGrids(openvdb::GridPtrVec& grids, const openvdb::GridPtrVec& regionGrids)
+{
+  assert(grids.size() == regionGrids.size());
+  for (size_t i = 0; i < grids.size() && i < regionGrids.size(); ++i)
+  {
+    bool merged = MergeGridTemplate<openvdb::FloatGrid>(grids[i], regionGrids[i])
+      || MergeGridTemplate<openvdb::DoubleGrid>(grids[i], regionGrids[i])
+      || MergeGridTemplate<openvdb::Int32Grid>(grids[i], regionGrids[i])
+      || MergeGridTemplate<openvdb::Int64Grid>(grids[i], regionGrids[i])
+      || MergeGridTemplate<openvdb::Vec3fGrid>(grids[i], regionGrids[i])
+      || MergeGridTemplate<openvdb::Vec3dGrid>(grids[i], regionGrids[i])
+      || MergeGridTemplate<CompactGrid<char>>(grids[i], regionGrids[i])
+      || MergeGridTemplate<CompactGrid<unsigned char>>(grids[i], regionGrids[i])
+      || MergeGridTemplate<CompactGrid<short>>(grids[i], regionGrids[i])
+      || MergeGridTemplate<CompactGrid<unsigned short>>(grids[i], regionGrids[i]);
+    assert(merged); (void)merged;
+  }
+}
+
+// Replaces a compact grid by its normalized float grid, moving over one leaf at a time so both trees are never held in full
+template<typename DataType>
+bool NormalizeCompactGridTemplate(openvdb::GridBase::Ptr& grid)
+{
+  typedef CompactGrid<DataType> CompactGridType;
+  typename CompactGridType::Ptr compactGrid = openvdb::gridPtrCast<CompactGridType>(grid);
+  if (!compactGrid)
+    return false;
+
+  const float minValue = (float)std::numeric_limits<DataType>::min();
+  const float maxValue = (float)std::numeric_limits<DataType>::max();
+  auto normalize = [minValue, maxValue](DataType value) { return ((float)value - minValue) / (maxValue - minValue); };
+
+  openvdb::FloatGrid::Ptr floatGrid = openvdb::FloatGrid::create();
+  floatGrid->setName(compactGrid->getName());
+  openvdb::FloatTree& floatTree = floatGrid->tree();
+
+  // Constant regions pruned into tiles
+  typename CompactGridType::TreeType::ValueOnCIter tileIt = compactGrid->tree().cbeginValueOn();
+  tileIt.setMaxDepth(CompactGridType::TreeType::ValueOnCIter::LEAF_DEPTH - 1);
+  for (; tileIt; ++tileIt)
+    floatTree.addTile(tileIt.getLevel(), tileIt.getCoord(), normalize(*tileIt), true);
+
+  std::vector<typename CompactGridType::TreeType::LeafNodeType*> leaves;
+  compactGrid->tree().stealNodes(leaves);
+  for (typename CompactGridType::TreeType::LeafNodeType*& leaf : leaves)
+  {
+    openvdb::FloatTree::LeafNodeType* floatLeaf = new openvdb::FloatTree::LeafNodeType(leaf->origin(), 0.0f);
+    for (auto valueIt = leaf->cbeginValueOn(); valueIt; ++valueIt)
+      floatLeaf->setValueOn(valueIt.pos(), normalize(*valueIt));
+    floatTree.addLeaf(floatLeaf);
+
+    delete leaf;
+    leaf = nullptr;
+  }
+
+  grid = floatGrid;
+  return true;
+}
+
+static void NormalizeCompactGrids(openvdb::GridPtrVec& grids)
+{
+  for (openvdb::GridBase::Ptr& grid : grids)
+  {
+    NormalizeCompactGridTemplate<char>(grid)
+      || NormalizeCompactGridTemplate<unsigned char>(grid)
+      || NormalizeCompactGridTemplate<short>(grid)
+      || NormalizeCompactGridTemplate<unsigned short>(grid);
+  }
+}
+
+UsdBridgeVolumeGridsPtr UsdBridgeVolumeWriter::CreateVolumeGrids(const UsdBridgeVolumeData& volumeData)
+{
+  // Keep the grid/tree transform at identity, and set coord bounding box to element dimensions. 
+  // This will correspond to a worldspace size of element dimensions too, with rest of scaling handled outside of openvdb.
+  const size_t* coordDims = volumeData.NumElements;
+  size_t maxInt = std::numeric_limits<int>::max();
+  assert(coordDims[0] <= maxInt && coordDims[1] <= maxInt && coordDims[2] <= maxInt);
+
+  UsdBridgeVolumeGridsPtr volumeGrids(new UsdBridgeVolumeGrids);
+  volumeGrids->Grids.reset(new openvdb::GridPtrVec);
+  volumeGrids->BBox = openvdb::CoordBBox(0, 0, 0, int(coordDims[0] - 1), int(coordDims[1] - 1), int(coordDims[2] - 1)); //Fill is inclusive
+
+  return volumeGrids;
+}
+
+void UsdBridgeVolumeWriter::AddVolumeRegion(UsdBridgeVolumeGrids& volumeGrids, const UsdBridgeVolumeData& regionData, const size_t* regionOffset)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeVolumeWriter::AddVolumeRegion");
+
+  openvdb::Coord regionMin(int(regionOffset[0]), int(regionOffset[1]), int(regionOffset[2]));
+  openvdb::Coord regionMax = regionMin.offsetBy(int(regionData.NumElements[0] - 1), int(regionData.NumElements[1] - 1), int(regionData.NumElements[2] - 1));
+  openvdb::CoordBBox regionBBox(regionMin, regionMax);
+  assert(volumeGrids.BBox.isInside(regionBBox));
+
+  openvdb::GridPtrVec& grids = *volumeGrids.Grids;
+  bool isFullVolume = (regionBBox == volumeGrids.BBox);
+
+  // Quantization is relative to the value range of the data, which is only known for a full volume
+  UsdBridgeVolumeOutputSettings regionSettings = OutputSettings;
+  regionSettings.QuantizeIntegers = OutputSettings.QuantizeIntegers && isFullVolume;
+
+  // Grids accumulating regions keep 8/16-bit sources at their own size instead of 4-byte floats until written
+  bool compactIntegers = !isFullVolume;
+
+  if (grids.empty())
+  {
+    CreateGrids(regionData, regionBBox, regionSettings, compactIntegers, grids);
+  }
+  else
+  {
+    openvdb::GridPtrVec regionGrids;
+    CreateGrids(regionData, regionBBox, regionSettings, compactIntegers, regionGrids);
+    MergeGrids(grids, regionGrids);
+  }
+}
+
+void UsdBridgeVolumeWriter::WriteVolumeGrids(UsdBridgeVolumeGrids& volumeGrids, std::ostream& vdbOutput, const UsdBridgeVolumeBrickMask* brickMask, int lodLevel)
+{
+  openvdb::GridPtrVec& grids = *volumeGrids.Grids;
+
+  NormalizeCompactGrids(grids);
+
+  if (brickMask)
+    ClipGridsToBricks(grids, *brickMask, volumeGrids.BBox);
+
+  if (lodLevel > 0)
+  {
+    // Voxel centers are at the centers of the full resolution cells they cover
+    double voxelSize = double(1 << lodLevel);
+    openvdb::math::Transform::Ptr lodTransform = openvdb::math::Transform::createLinearTransform(voxelSize);
+    lodTransform->postTranslate(openvdb::Vec3d(0.5 * (voxelSize - 1.0)));
+    for (openvdb::GridBase::Ptr& grid : grids)
+      grid->setTransform(lodTransform->copy());
+  }
+
+  // Half float storage applies to float-based grids only (FloatGrid, Vec3fGrid), others ignore it
+  if (OutputSettings.HalfPrecision)
+  {
+    for (openvdb::GridBase::Ptr& grid : grids)
+      grid->setSaveFloatAsHalf(true);
+  }
 
   // Must write all grids at once
-  openvdb::io::Stream(vdbOutput).write(*grids);
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeVolumeWriter::ToVDB::Write");
+  openvdb::io::Stream vdbStream(vdbOutput);
+  switch (OutputSettings.Compression)
+  {
+  case UsdBridgeVolumeCompression::NONE:
+    vdbStream.setCompression(openvdb::io::COMPRESS_ACTIVE_MASK);
+    break;
+  case UsdBridgeVolumeCompression::ZIP:
+    vdbStream.setCompression(openvdb::io::COMPRESS_ZIP | openvdb::io::COMPRESS_ACTIVE_MASK);
+    break;
+  case UsdBridgeVolumeCompression::BLOSC:
+    vdbStream.setCompression(openvdb::io::COMPRESS_BLOSC | openvdb::io::COMPRESS_ACTIVE_MASK);
+    break;
+  default:
+    break;
+  }
+  vdbStream.write(grids);
+}
+
+void UsdBridgeVolumeWriter::ToVDB(const UsdBridgeVolumeData& volumeData, std::ostream& vdbOutput, const UsdBridgeVolumeBrickMask* brickMask, int lodLevel)
+{
+  USDBRIDGE_TRACE_SCOPE("UsdBridgeVolumeWriter::ToVDB");
+
+  UsdBridgeVolumeGridsPtr volumeGrids = CreateVolumeGrids(volumeData);
+
+  const size_t volumeOffset[3] = { 0, 0, 0 };
+  AddVolumeRegion(*volumeGrids, volumeData, volumeOffset);
+
+  WriteVolumeGrids(*volumeGrids, vdbOutput, brickMask, lodLevel);
 }
 
 #else //USE_OPENVDB
@@ -436,12 +893,41 @@ UsdBridgeVolumeWriter::~UsdBridgeVolumeWriter()
 
 }
 
-bool UsdBridgeVolumeWriter::Initialize(UsdBridgeLogCallback logCallback, void* logUserData)
+bool UsdBridgeVolumeWriter::Initialize(const UsdBridgeVolumeOutputSettings& outputSettings, UsdBridgeLogCallback logCallback, void* logUserData)
 {
   return true;
 }
 
-void UsdBridgeVolumeWriter::ToVDB(const UsdBridgeVolumeData & volumeData, std::ostream& vdbOutput)
+void UsdBridgeVolumeWriter::ToVDB(const UsdBridgeVolumeData & volumeData, std::ostream& vdbOutput, const UsdBridgeVolumeBrickMask* brickMask, int lodLevel)
+{
+
+}
+
+bool UsdBridgeVolumeWriter::Downsample(const UsdBridgeVolumeData& volumeData, UsdBridgeVolumeData& lodVolumeData, std::vector<char>& lodData)
+{
+  return false;
+}
+
+struct UsdBridgeVolumeGrids
+{
+};
+
+void UsdBridgeVolumeGridsDeleter::operator()(UsdBridgeVolumeGrids* grids) const
+{
+  delete grids;
+}
+
+UsdBridgeVolumeGridsPtr UsdBridgeVolumeWriter::CreateVolumeGrids(const UsdBridgeVolumeData& volumeData)
+{
+  return UsdBridgeVolumeGridsPtr(new UsdBridgeVolumeGrids);
+}
+
+void UsdBridgeVolumeWriter::AddVolumeRegion(UsdBridgeVolumeGrids& volumeGrids, const UsdBridgeVolumeData& regionData, const size_t* regionOffset)
+{
+
+}
+
+void UsdBridgeVolumeWriter::WriteVolumeGrids(UsdBridgeVolumeGrids& volumeGrids, std::ostream& vdbOutput, const UsdBridgeVolumeBrickMask* brickMask, int lodLevel)
 {
 
 }
@@ -7,6 +7,14 @@
 #include "UsdBridgeData.h"
 
 #include <ostream>
+#include <memory>
+
+struct UsdBridgeVolumeGrids;
+struct UsdBridgeVolumeGridsDeleter
+{
+  void operator()(UsdBridgeVolumeGrids* grids) const;
+};
+using UsdBridgeVolumeGridsPtr = std::unique_ptr<UsdBridgeVolumeGrids, UsdBridgeVolumeGridsDeleter>;
 
 class UsdBridgeVolumeWriter
 {
@@ -14,14 +22,28 @@ class UsdBridgeVolumeWriter
     UsdBridgeVolumeWriter();
     ~UsdBridgeVolumeWriter();
 
-    bool Initialize(UsdBridgeLogCallback logCallback, void* logUserData);
+    bool Initialize(const UsdBridgeVolumeOutputSettings& outputSettings, UsdBridgeLogCallback logCallback, void* logUserData);
+
+    // With a brickMask, only the selected bricks are written, with all their voxels active.
+    // Data of lodLevel > 0 is written with voxels of 2^lodLevel cells, aligned with the full resolution data.
+    void ToVDB(const UsdBridgeVolumeData& volumeData, std::ostream& vdbOutput, const UsdBridgeVolumeBrickMask* brickMask = nullptr, int lodLevel = 0);
+
+    // Incremental alternative to ToVDB, for volumes submitted as a sequence of disjoint regions (ie. slabs or bricks),
+    // so the dense data of the full volume never has to be in memory at once. CreateVolumeGrids() only uses the dimensions
+    // of volumeData, each region is converted into the grids as it is added, and WriteVolumeGrids() writes the result.
+    UsdBridgeVolumeGridsPtr CreateVolumeGrids(const UsdBridgeVolumeData& volumeData);
+    void AddVolumeRegion(UsdBridgeVolumeGrids& volumeGrids, const UsdBridgeVolumeData& regionData, const size_t* regionOffset);
+    void WriteVolumeGrids(UsdBridgeVolumeGrids& volumeGrids, std::ostream& vdbOutput, const UsdBridgeVolumeBrickMask* brickMask = nullptr, int lodLevel = 0);
 
-    void ToVDB(const UsdBridgeVolumeData& volumeData, std::ostream& vdbOutput);
+    // Downsamples volume data by 2x in each dimension into lodData, with the filter of the output settings.
+    // lodVolumeData refers to lodData and keeps the data type and transfer function of volumeData.
+    bool Downsample(const UsdBridgeVolumeData& volumeData, UsdBridgeVolumeData& lodVolumeData, std::vector<char>& lodData);
     
     static UsdBridgeLogCallback LogCallback;
     static void* LogUserData;
 
   protected:
+    UsdBridgeVolumeOutputSettings OutputSettings;
 };
 
 
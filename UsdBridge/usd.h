@@ -16,12 +16,15 @@
 #include <pxr/base/tf/token.h>
 #include <pxr/base/trace/reporter.h>
 #include <pxr/base/trace/trace.h>
+#include <pxr/base/work/loops.h>
 #include <pxr/base/vt/array.h>
 #include <pxr/base/gf/range3f.h>
 #include <pxr/base/gf/rotation.h>
+#include <pxr/base/gf/matrix3d.h>
 #include <pxr/usd/usd/attribute.h>
 #include <pxr/usd/usd/notice.h>
 #include <pxr/usd/usd/stage.h>
+#include <pxr/usd/usd/editTarget.h>
 #include <pxr/usd/usd/primRange.h>
 #include <pxr/usd/usd/modelAPI.h>
 #include <pxr/usd/usd/clipsAPI.h>
@@ -32,6 +35,7 @@
 #include <pxr/usd/usdGeom/cylinder.h>
 #include <pxr/usd/usdGeom/cone.h>
 #include <pxr/usd/usdGeom/xform.h>
+#include <pxr/usd/usdGeom/xformOp.h>
 #include <pxr/usd/usdGeom/pointInstancer.h>
 #include <pxr/usd/usdGeom/primvarsAPI.h>
 #include <pxr/usd/usdGeom/basisCurves.h>
@@ -40,6 +44,13 @@
 #include <pxr/usd/usdVol/openVDBAsset.h>
 #include <pxr/usd/sdf/layer.h>
 #include <pxr/usd/sdf/path.h>
+#include <pxr/usd/sdf/listOp.h>
+#include <pxr/usd/sdf/schema.h>
+#include <pxr/usd/sdf/changeBlock.h>
+#include <pxr/usd/sdf/primSpec.h>
+#include <pxr/usd/sdf/attributeSpec.h>
+#include <pxr/usd/sdf/copyUtils.h>
+#include <pxr/usd/sdf/fileFormat.h>
 #include <pxr/usd/usdShade/material.h>
 #include <pxr/usd/usdShade/materialBindingAPI.h>
 #include <pxr/usd/kind/registry.h>
@@ -2,7 +2,9 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "UsdDevice.h"
+#include "UsdDeviceCapture.h"
 #include "UsdBridge/UsdBridge.h"
+#include "UsdBridge/UsdBridgeTrace.h"
 #include "UsdBaseObject.h"
 #include "UsdDataArray.h"
 #include "UsdGeometry.h"
@@ -59,6 +61,13 @@ public:
   std::string OutputPath;
   bool CreateNewSession;
   bool BinaryOutput;
+  bool DirectIO;
+  UsdBridgeSyncPolicy SyncPolicy;
+  bool DedupAssets;
+  bool DedupGeometry;
+  UsdBridgeVolumeOutputSettings VolumeOutput;
+  UsdBridgeTimeLayout TimeLayout;
+  bool MappedArrays;
 };
 
 class UsdDeviceInternals
@@ -77,7 +86,14 @@ public:
       settings.HostName.c_str(),
       settings.OutputPath.c_str(),
       settings.CreateNewSession,
-      settings.BinaryOutput
+      settings.BinaryOutput,
+      settings.DirectIO,
+      settings.SyncPolicy,
+      settings.DedupAssets,
+      settings.DedupGeometry,
+      settings.VolumeOutput,
+      settings.TimeLayout,
+      settings.MappedArrays
     };
 
     bridge = std::make_unique<UsdBridge>(bridgeSettings);
@@ -98,17 +114,37 @@ public:
       bridgeStatusFunc(UsdBridgeLogLevel::STATUS, userData, "UsdBridge Session initialization successful.");
 
       bridge->SetEnableSaving(this->enableSaving);
+      bridge->SetBatchChanges(this->batchChanges);
+      bridge->SetTimeSampleTolerance(this->timeSampleTolerance);
+      bridge->SetParallelWrites(this->parallelWrites);
+      bridge->SetMemoryBudget(this->memoryBudgetMB);
     }
 
     return createSuccess;
   }
 
+  bool DumpTrace()
+  {
+    if (traceFile.empty())
+      return true;
+    return UsdBridgeTrace::Dump(traceFile.c_str());
+  }
+
   UsdDeviceSettings settings; // Settings lifetime should encapsulate bridge lifetime
   bool enableSaving = true;
+  bool batchChanges = true;
+  double timeSampleTolerance = 0.0;
+  bool parallelWrites = false;
+  uint64_t memoryBudgetMB = 0; // Bounds the timevarying data held in memory by the bridge, 0 is unbounded
+  int garbageCollectBudget = 0; // Unreferenced prims removed per renderFrame, 0 leaves it to usd::garbagecollect
   std::unique_ptr<UsdBridge> bridge;
   SceneStagePtr externalSceneStage{nullptr};
 
   std::set<std::string> uniqueNames;
+
+  std::string traceFile; // Chrome trace output, written at usd::trace.dump and at device destruction
+
+  UsdDeviceCapture capture; // Records API calls for usdDeviceReplay, opened by usd::capture.file
 };
 
 
@@ -117,15 +153,36 @@ DEFINE_PARAMETER_MAP(UsdDevice,
   REGISTER_PARAMETER_MACRO("usd::serialize.location", ANARI_STRING, outputPath)
   REGISTER_PARAMETER_MACRO("usd::serialize.newsession", ANARI_BOOL, createNewSession)
   REGISTER_PARAMETER_MACRO("usd::serialize.outputbinary", ANARI_BOOL, outputBinary)
+  REGISTER_PARAMETER_MACRO("usd::serialize.directio", ANARI_BOOL, directIO)
+  REGISTER_PARAMETER_MACRO("usd::serialize.fsync", ANARI_STRING, syncPolicy)
+  REGISTER_PARAMETER_MACRO("usd::serialize.dedupassets", ANARI_BOOL, dedupAssets)
+  REGISTER_PARAMETER_MACRO("usd::serialize.dedupgeometry", ANARI_BOOL, dedupGeometry)
+  REGISTER_PARAMETER_MACRO("usd::serialize.volume.compression", ANARI_STRING, volumeCompression)
+  REGISTER_PARAMETER_MACRO("usd::serialize.volume.halfprecision", ANARI_BOOL, volumeHalfPrecision)
+  REGISTER_PARAMETER_MACRO("usd::serialize.volume.quantizeintegers", ANARI_BOOL, volumeQuantizeIntegers)
+  REGISTER_PARAMETER_MACRO("usd::serialize.volume.deltas", ANARI_BOOL, volumeBrickDeltas)
+  REGISTER_PARAMETER_MACRO("usd::serialize.volume.deltafraction", ANARI_FLOAT32, volumeMaxDeltaFraction)
+  REGISTER_PARAMETER_MACRO("usd::serialize.volume.lodlevels", ANARI_INT32, volumeLodLevels)
+  REGISTER_PARAMETER_MACRO("usd::serialize.volume.lodfilter", ANARI_STRING, volumeLodFilter)
+  REGISTER_PARAMETER_MACRO("usd::serialize.timelayout", ANARI_STRING, timeLayout)
+  REGISTER_PARAMETER_MACRO("usd::serialize.mappedarrays", ANARI_BOOL, mappedArrays)
   REGISTER_PARAMETER_MACRO("usd::timestep", ANARI_FLOAT64, timeStep)
+  REGISTER_PARAMETER_MACRO("usd::pointinstancer.threshold", ANARI_INT32, pointInstancerThreshold)
 )
 
 UsdDevice::UsdDevice()
   : internals(std::make_unique<UsdDeviceInternals>())
-{}
+{
+  auto *envCaptureFile = getenv("ANARI_USD_CAPTURE_FILE");
+  if (envCaptureFile)
+    internals->capture.Open(envCaptureFile);
+}
 
 UsdDevice::~UsdDevice()
 {
+  if (UsdBridgeTrace::IsEnabled())
+    internals->DumpTrace();
+
   //internals->bridge->SaveScene(); //Uncomment to test cleanup of usd files.
 
 #ifdef CHECK_MEMLEAKS
@@ -195,6 +252,9 @@ void UsdDevice::reportStatus(void* source,
 void UsdDevice::deviceSetParameter(
   const char *id, ANARIDataType type, const void *mem)
 {
+  if (internals->capture.IsOpen() && std::strcmp(id, "usd::capture.file") != 0)
+    internals->capture.RecordSetParameter(nullptr, id, type, mem);
+
   if (std::strcmp(id, "usd::garbagecollect") == 0)
   {
     // Perform garbage collection on usd objects (needs to move into the user interface)
@@ -224,6 +284,72 @@ void UsdDevice::deviceSetParameter(
         internals->bridge->SetEnableSaving(internals->enableSaving);
     }
   }
+  else if (std::strcmp(id, "usd::batchchanges") == 0)
+  {
+    if(type == ANARI_BOOL)
+    {
+      internals->batchChanges = *(reinterpret_cast<const bool*>(mem));
+      if(internals->bridge)
+        internals->bridge->SetBatchChanges(internals->batchChanges);
+    }
+  }
+  else if (std::strcmp(id, "usd::timesamples.tolerance") == 0)
+  {
+    if(type == ANARI_FLOAT64 || type == ANARI_FLOAT32)
+    {
+      internals->timeSampleTolerance = (type == ANARI_FLOAT64) ? *(reinterpret_cast<const double*>(mem)) : *(reinterpret_cast<const float*>(mem));
+      if(internals->bridge)
+        internals->bridge->SetTimeSampleTolerance(internals->timeSampleTolerance);
+    }
+  }
+  else if (std::strcmp(id, "usd::parallelwrites") == 0)
+  {
+    if(type == ANARI_BOOL)
+    {
+      internals->parallelWrites = *(reinterpret_cast<const bool*>(mem));
+      if(internals->bridge)
+        internals->bridge->SetParallelWrites(internals->parallelWrites);
+    }
+  }
+  else if (std::strcmp(id, "usd::memorybudgetmb") == 0)
+  {
+    if(type == ANARI_UINT64 || (type == ANARI_INT32 && *(reinterpret_cast<const int*>(mem)) >= 0))
+    {
+      internals->memoryBudgetMB = (type == ANARI_UINT64) ? *(reinterpret_cast<const uint64_t*>(mem)) : *(reinterpret_cast<const int*>(mem));
+      if(internals->bridge)
+        internals->bridge->SetMemoryBudget(internals->memoryBudgetMB);
+    }
+  }
+  else if (std::strcmp(id, "usd::garbagecollect.budget") == 0)
+  {
+    if(type == ANARI_INT32)
+      internals->garbageCollectBudget = *(reinterpret_cast<const int*>(mem));
+  }
+  else if (std::strcmp(id, "usd::trace.enable") == 0)
+  {
+    if(type == ANARI_BOOL)
+      UsdBridgeTrace::SetEnabled(*(reinterpret_cast<const bool*>(mem)));
+  }
+  else if (std::strcmp(id, "usd::trace.dump") == 0)
+  {
+    if(type == ANARI_STRING)
+    {
+      internals->traceFile = static_cast<const char*>(mem);
+      if(!internals->DumpTrace())
+        reportStatus(this, ANARI_DEVICE, ANARI_SEVERITY_WARNING, ANARI_STATUS_INVALID_ARGUMENT,
+          "Usd Device parameter 'usd::trace.dump' could not write to %s", internals->traceFile.c_str());
+    }
+  }
+  else if (std::strcmp(id, "usd::capture.file") == 0)
+  {
+    if(type == ANARI_STRING)
+    {
+      const char* captureFile = static_cast<const char*>(mem);
+      if(!internals->capture.Open(captureFile))
+        reportStatus(this, ANARI_DEVICE, ANARI_SEVERITY_WARNING, ANARI_STATUS_INVALID_ARGUMENT,
+          "Usd Device parameter 'usd::capture.file' could not open %s for writing", captureFile);
+    }
+  }
   else if (std::strcmp(id, "statusCallback") == 0 && type == ANARI_STATUS_CALLBACK)
   {
     userSetStatusFunc = (ANARIStatusCallback)mem;
@@ -246,6 +372,15 @@ void UsdDevice::deviceSetParameter(
 
 void UsdDevice::deviceUnsetParameter(const char * id)
 {
+  if (std::strcmp(id, "usd::capture.file") == 0)
+  {
+    internals->capture.Close();
+    return;
+  }
+
+  if (internals->capture.IsOpen())
+    internals->capture.RecordUnsetParameter(nullptr, id);
+
   if (std::strcmp(id, "statusCallback"))
   {
     userSetStatusFunc = nullptr;
@@ -255,7 +390,9 @@ void UsdDevice::deviceUnsetParameter(const char * id)
     userSetStatusUserData = nullptr;
   }
   else if (std::strcmp(id, "usd::garbagecollect") != 0
-    && std::strcmp(id, "usd::removeunusednames") != 0)
+    && std::strcmp(id, "usd::removeunusednames") != 0
+    && std::strcmp(id, "usd::trace.dump") != 0
+    && std::strcmp(id, "usd::capture.file") != 0)
   {
     resetParam(id);
   }
@@ -268,6 +405,9 @@ int UsdDevice::deviceImplements(const char *)
 
 void UsdDevice::deviceCommit()
 {
+  if (internals->capture.IsOpen())
+    internals->capture.RecordCommit(nullptr);
+
   statusFunc = userSetStatusFunc ? userSetStatusFunc : defaultStatusCallback();
   statusUserData = userSetStatusUserData ? userSetStatusUserData : defaultStatusCallbackUserPtr();
 
@@ -298,6 +438,69 @@ void UsdDevice::deviceCommit()
   internals->settings.OutputPath = location;
   internals->settings.CreateNewSession = paramData.createNewSession;
   internals->settings.BinaryOutput = paramData.outputBinary;
+  internals->settings.DirectIO = paramData.directIO;
+  internals->settings.DedupAssets = paramData.dedupAssets;
+  internals->settings.DedupGeometry = paramData.dedupGeometry;
+  internals->settings.SyncPolicy = UsdBridgeSyncPolicy::NONE;
+  if (paramData.syncPolicy)
+  {
+    if (std::strcmp(paramData.syncPolicy, "checkpoint") == 0)
+      internals->settings.SyncPolicy = UsdBridgeSyncPolicy::CHECKPOINT;
+    else if (std::strcmp(paramData.syncPolicy, "always") == 0)
+      internals->settings.SyncPolicy = UsdBridgeSyncPolicy::ALWAYS;
+    else if (std::strcmp(paramData.syncPolicy, "none") != 0)
+      reportStatus(this, ANARI_DEVICE, ANARI_SEVERITY_WARNING, ANARI_STATUS_INVALID_ARGUMENT,
+        "Usd Device parameter 'usd::serialize.fsync' should be \"none\", \"checkpoint\" or \"always\", defaulting to \"none\"");
+  }
+  UsdBridgeVolumeOutputSettings& volumeOutput = internals->settings.VolumeOutput;
+  volumeOutput.HalfPrecision = paramData.volumeHalfPrecision;
+  volumeOutput.QuantizeIntegers = paramData.volumeQuantizeIntegers;
+  volumeOutput.BrickDeltas = paramData.volumeBrickDeltas;
+  volumeOutput.MaxDeltaFraction = paramData.volumeMaxDeltaFraction;
+  volumeOutput.LodLevels = paramData.volumeLodLevels;
+  if (volumeOutput.LodLevels < 0 || volumeOutput.LodLevels > UsdBridgeMaxVolumeLodLevels)
+  {
+    volumeOutput.LodLevels = std::max(0, std::min(volumeOutput.LodLevels, UsdBridgeMaxVolumeLodLevels));
+    reportStatus(this, ANARI_DEVICE, ANARI_SEVERITY_WARNING, ANARI_STATUS_INVALID_ARGUMENT,
+      "Usd Device parameter 'usd::serialize.volume.lodlevels' should be between 0 and %i, clamping to %i", UsdBridgeMaxVolumeLodLevels, volumeOutput.LodLevels);
+  }
+  volumeOutput.LodFilter = UsdBridgeVolumeLodFilter::BOX;
+  if (paramData.volumeLodFilter)
+  {
+    if (std::strcmp(paramData.volumeLodFilter, "max") == 0)
+      volumeOutput.LodFilter = UsdBridgeVolumeLodFilter::MAX;
+    else if (std::strcmp(paramData.volumeLodFilter, "box") != 0)
+      reportStatus(this, ANARI_DEVICE, ANARI_SEVERITY_WARNING, ANARI_STATUS_INVALID_ARGUMENT,
+        "Usd Device parameter 'usd::serialize.volume.lodfilter' should be \"box\" or \"max\", defaulting to \"box\"");
+  }
+  volumeOutput.Compression = UsdBridgeVolumeCompression::DEFAULT;
+  if (paramData.volumeCompression)
+  {
+    if (std::strcmp(paramData.volumeCompression, "none") == 0)
+      volumeOutput.Compression = UsdBridgeVolumeCompression::NONE;
+    else if (std::strcmp(paramData.volumeCompression, "zip") == 0)
+      volumeOutput.Compression = UsdBridgeVolumeCompression::ZIP;
+    else if (std::strcmp(paramData.volumeCompression, "blosc") == 0)
+      volumeOutput.Compression = UsdBridgeVolumeCompression::BLOSC;
+    else if (std::strcmp(paramData.volumeCompression, "default") != 0)
+      reportStatus(this, ANARI_DEVICE, ANARI_SEVERITY_WARNING, ANARI_STATUS_INVALID_ARGUMENT,
+        "Usd Device parameter 'usd::serialize.volume.compression' should be \"default\", \"none\", \"zip\" or \"blosc\", defaulting to \"default\"");
+  }
+  internals->settings.TimeLayout = UsdBridgeTimeLayout::CLIP_STAGES;
+  if (paramData.timeLayout)
+  {
+    if (std::strcmp(paramData.timeLayout, "scenestage") == 0)
+      internals->settings.TimeLayout = UsdBridgeTimeLayout::SCENE_STAGE;
+    else if (std::strcmp(paramData.timeLayout, "primstages") == 0)
+      internals->settings.TimeLayout = UsdBridgeTimeLayout::PRIM_STAGES;
+    else if (std::strcmp(paramData.timeLayout, "clipstages") != 0)
+      reportStatus(this, ANARI_DEVICE, ANARI_SEVERITY_WARNING, ANARI_STATUS_INVALID_ARGUMENT,
+        "Usd Device parameter 'usd::serialize.timelayout' should be \"scenestage\", \"primstages\" or \"clipstages\", defaulting to \"clipstages\"");
+  }
+  internals->settings.MappedArrays = paramData.mappedArrays && paramData.outputBinary;
+  if (paramData.mappedArrays && !paramData.outputBinary)
+    reportStatus(this, ANARI_DEVICE, ANARI_SEVERITY_WARNING, ANARI_STATUS_INVALID_ARGUMENT,
+      "Usd Device parameter 'usd::serialize.mappedarrays' requires 'usd::serialize.outputbinary', ignoring");
 
   if (!internals->CreateNewBridge(&reportBridgeStatus, this))
   {
@@ -324,28 +527,28 @@ ANARIArray UsdDevice::CreateDataArray(void *appMemory,
   uint64_t numItems2,
   int64_t byteStride2,
   uint64_t numItems3,
-  int64_t byteStride3)
+  int64_t byteStride3,
+  uint8_t numDims)
 {
+  UsdDataArray* object = nullptr;
   if (!appMemory)
   {
-    UsdDataArray* object = new UsdDataArray(dataType, numItems1, numItems2, numItems3, this);
-#ifdef CHECK_MEMLEAKS
-    LogAllocation(object);
-#endif
-
-    return (ANARIArray)(object);
+    object = new UsdDataArray(dataType, numItems1, numItems2, numItems3, this);
   }
   else
   {
-    UsdDataArray* object = new UsdDataArray(appMemory, deleter, userData,
+    object = new UsdDataArray(appMemory, deleter, userData,
       dataType, numItems1, byteStride1, numItems2, byteStride2, numItems3, byteStride3,
       this);
+  }
 #ifdef CHECK_MEMLEAKS
-    LogAllocation(object);
+  LogAllocation(object);
 #endif
 
-    return (ANARIArray)(object);
-  }
+  if (internals->capture.IsOpen())
+    internals->capture.RecordNewArray(object, numDims, appMemory != nullptr);
+
+  return (ANARIArray)(object);
 }
 
 ANARIArray1D UsdDevice::newArray1D(void *appMemory,
@@ -356,7 +559,7 @@ ANARIArray1D UsdDevice::newArray1D(void *appMemory,
   uint64_t byteStride)
 {
   return (ANARIArray1D)CreateDataArray(appMemory, deleter, userData,
-    type, numItems, byteStride, 1, 0, 1, 0);
+    type, numItems, byteStride, 1, 0, 1, 0, 1);
 }
 
 ANARIArray2D UsdDevice::newArray2D(void *appMemory,
@@ -369,7 +572,7 @@ ANARIArray2D UsdDevice::newArray2D(void *appMemory,
   uint64_t byteStride2)
 {
   return (ANARIArray2D)CreateDataArray(appMemory, deleter, userData,
-    type, numItems1, byteStride1, numItems2, byteStride2, 1, 0);
+    type, numItems1, byteStride1, numItems2, byteStride2, 1, 0, 2);
 }
 
 ANARIArray3D UsdDevice::newArray3D(void *appMemory,
@@ -384,7 +587,7 @@ ANARIArray3D UsdDevice::newArray3D(void *appMemory,
   uint64_t byteStride3)
 {
   return (ANARIArray3D)CreateDataArray(appMemory, deleter, userData,
-    type, numItems1, byteStride1, numItems2, byteStride2, numItems3, byteStride3);
+    type, numItems1, byteStride1, numItems2, byteStride2, numItems3, byteStride3, 3);
 }
 
 void * UsdDevice::mapArray(ANARIArray array)
@@ -395,6 +598,9 @@ void * UsdDevice::mapArray(ANARIArray array)
 void UsdDevice::unmapArray(ANARIArray array)
 {
   ((UsdDataArray*)array)->unmap(this);
+
+  if (internals->capture.IsOpen())
+    internals->capture.RecordArrayData((UsdDataArray*)array, false);
 }
 
 ANARISampler UsdDevice::newSampler(const char *type)
@@ -405,6 +611,9 @@ ANARISampler UsdDevice::newSampler(const char *type)
   LogAllocation(object);
 #endif
 
+  if (internals->capture.IsOpen())
+    internals->capture.RecordNewObject(object, ANARI_SAMPLER, type);
+
   return (ANARISampler)(object);
 }
 
@@ -416,6 +625,9 @@ ANARIMaterial UsdDevice::newMaterial(const char *material_type)
   LogAllocation(object);
 #endif
 
+  if (internals->capture.IsOpen())
+    internals->capture.RecordNewObject(object, ANARI_MATERIAL, material_type);
+
   return (ANARIMaterial)(object);
 }
 
@@ -427,6 +639,9 @@ ANARIGeometry UsdDevice::newGeometry(const char *type)
   LogAllocation(object);
 #endif
 
+  if (internals->capture.IsOpen())
+    internals->capture.RecordNewObject(object, ANARI_GEOMETRY, type);
+
   return (ANARIGeometry)(object);
 }
 
@@ -438,6 +653,9 @@ ANARISpatialField UsdDevice::newSpatialField(const char * type)
   LogAllocation(object);
 #endif
 
+  if (internals->capture.IsOpen())
+    internals->capture.RecordNewObject(object, ANARI_SPATIAL_FIELD, type);
+
   return (ANARISpatialField)(object);
 }
 
@@ -449,6 +667,9 @@ ANARISurface UsdDevice::newSurface()
   LogAllocation(object);
 #endif
 
+  if (internals->capture.IsOpen())
+    internals->capture.RecordNewObject(object, ANARI_SURFACE, "");
+
   return (ANARISurface)(object);
 }
 
@@ -460,6 +681,9 @@ ANARIVolume UsdDevice::newVolume(const char *type)
   LogAllocation(object);
 #endif
 
+  if (internals->capture.IsOpen())
+    internals->capture.RecordNewObject(object, ANARI_VOLUME, type);
+
   return (ANARIVolume)(object);
 }
 
@@ -471,6 +695,9 @@ ANARIGroup UsdDevice::newGroup()
   LogAllocation(object);
 #endif
 
+  if (internals->capture.IsOpen())
+    internals->capture.RecordNewObject(object, ANARI_GROUP, "");
+
   return (ANARIGroup)(object);
 }
 
@@ -482,6 +709,9 @@ ANARIInstance UsdDevice::newInstance()
   LogAllocation(object);
 #endif
 
+  if (internals->capture.IsOpen())
+    internals->capture.RecordNewObject(object, ANARI_INSTANCE, "");
+
   return (ANARIInstance)(object);
 }
 
@@ -493,6 +723,9 @@ ANARIWorld UsdDevice::newWorld()
   LogAllocation(object);
 #endif
 
+  if (internals->capture.IsOpen())
+    internals->capture.RecordNewObject(object, ANARI_WORLD, "");
+
   return (ANARIWorld)(object);
 }
 
@@ -503,11 +736,23 @@ ANARIRenderer UsdDevice::newRenderer(const char *type)
   LogAllocation(object);
 #endif
 
+  if (internals->capture.IsOpen())
+    internals->capture.RecordNewObject(object, ANARI_RENDERER, type);
+
   return (ANARIRenderer)(object);
 }
 
 void UsdDevice::renderFrame(ANARIFrame frame)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdDevice::renderFrame");
+
+  if (internals->capture.IsOpen())
+    internals->capture.RecordRenderFrame(frame);
+
+  // Spread the removal of unreferenced prims over frames, before the save that outputs it
+  if(internals->bridge && internals->garbageCollectBudget > 0)
+    internals->bridge->GarbageCollectStep(uint64_t(internals->garbageCollectBudget));
+
   UsdRenderer* ren = ((UsdFrame*)frame)->getRenderer();
   if(ren)
     ren->saveUsd();
@@ -550,6 +795,16 @@ int UsdDevice::getProperty(ANARIObject object,
       writeToVoidP(mem, DEVICE_VERSION);
       return 1;
     }
+    double resumeTimeStep;
+    if (!std::strcmp(name, "usd::resume.timestep") && type == ANARI_FLOAT64
+      && internals->bridge && internals->bridge->GetResumeTimeStep(resumeTimeStep)) {
+      writeToVoidP(mem, resumeTimeStep);
+      return 1;
+    }
+    if (!std::strcmp(name, "usd::memoryfootprint") && type == ANARI_UINT64 && internals->bridge) {
+      writeToVoidP(mem, internals->bridge->GetMemoryFootprint());
+      return 1;
+    }
   }
   else
     return ((UsdBaseObject*)object)->getProperty(name, type, mem, size, this);
@@ -564,6 +819,9 @@ ANARIFrame UsdDevice::newFrame()
   LogAllocation(object);
 #endif
 
+  if (internals->capture.IsOpen())
+    internals->capture.RecordNewObject(object, ANARI_FRAME, "");
+
   return (ANARIFrame)(object);
 }
 
@@ -586,12 +844,18 @@ void UsdDevice::setParameter(ANARIObject object,
   ANARIDataType type,
   const void *mem)
 {
+  if (internals->capture.IsOpen() && object)
+    internals->capture.RecordSetParameter(object, name, type, mem);
+
   if (object)
     ((UsdBaseObject*)object)->filterSetParam(name, type, mem, this);
 }
 
 void UsdDevice::unsetParameter(ANARIObject object, const char * name)
 {
+  if (internals->capture.IsOpen() && object)
+    internals->capture.RecordUnsetParameter(object, name);
+
   if (object)
     ((UsdBaseObject*)object)->filterResetParam(name);
 }
@@ -600,6 +864,9 @@ void UsdDevice::release(ANARIObject object)
 {
   UsdBaseObject* baseObject = (UsdBaseObject*)object;
 
+  if (internals->capture.IsOpen())
+    internals->capture.RecordRelease(object);
+
   if (baseObject)
   {
     bool privatizeArray = baseObject->getType() == ANARI_ARRAY
@@ -619,12 +886,25 @@ void UsdDevice::release(ANARIObject object)
 
 void UsdDevice::retain(ANARIObject object)
 {
+  if (internals->capture.IsOpen())
+    internals->capture.RecordRetain(object);
+
   if (object)
     ((UsdBaseObject*)object)->refInc(anari::RefType::PUBLIC);
 }
 
 void UsdDevice::commit(ANARIObject object)
 {
+  USDBRIDGE_TRACE_SCOPE("UsdDevice::commit");
+
+  if (internals->capture.IsOpen() && object)
+  {
+    // App memory may have been modified without mapping, so record any change in array contents
+    if (((UsdBaseObject*)object)->getType() == ANARI_ARRAY)
+      internals->capture.RecordArrayData((UsdDataArray*)object, true);
+    internals->capture.RecordCommit(object);
+  }
+
   if(object)
     ((UsdBaseObject*)object)->commit(this);
 }
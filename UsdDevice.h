@@ -37,8 +37,22 @@ struct UsdDeviceData
   const char* outputPath = nullptr;
   bool createNewSession = true;
   bool outputBinary = false;
+  bool directIO = false;
+  const char* syncPolicy = nullptr;
+  bool dedupAssets = false;
+  bool dedupGeometry = false;
+  const char* volumeCompression = nullptr;
+  bool volumeHalfPrecision = false;
+  bool volumeQuantizeIntegers = false;
+  bool volumeBrickDeltas = false;
+  float volumeMaxDeltaFraction = 0.25f;
+  int volumeLodLevels = 0;
+  const char* volumeLodFilter = nullptr;
+  const char* timeLayout = nullptr;
+  bool mappedArrays = false;
 
   double timeStep = 0.0;
+  int pointInstancerThreshold = 0;
 };
 
 class UsdDevice : public anari::Device, anari::RefCounted, public UsdParameterizedObject<UsdDevice, UsdDeviceData>
@@ -200,7 +214,8 @@ class UsdDevice : public anari::Device, anari::RefCounted, public UsdParameteriz
       uint64_t numItems2,
       int64_t byteStride2,
       uint64_t numItems3,
-      int64_t byteStride3);
+      int64_t byteStride3,
+      uint8_t numDims);
 
     std::unique_ptr<UsdDeviceInternals> internals;
 
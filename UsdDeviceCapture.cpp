@@ -0,0 +1,298 @@
+// Copyright 2020 The Khronos Group
+// SPDX-License-Identifier: Apache-2.0
+
+#include "UsdDeviceCapture.h"
+#include "UsdDataArray.h"
+#include "UsdAnari.h"
+#include "UsdBridge/UsdBridgeUtils.h"
+#include "anari/detail/Helpers.h"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+  // 128-bit hash of the contents, seeded with their size, so distinct payloads practically never share a key
+  UsdDeviceCapture::BlobKey HashPayload(const void* bytes, uint64_t numBytes)
+  {
+    UsdDeviceCapture::BlobKey key;
+    key.Hash[0] = numBytes;
+    key.Hash[1] = 0;
+    key.NumBytes = numBytes;
+    UsdBridgeHash128(bytes, numBytes, key.Hash);
+    return key;
+  }
+}
+
+struct UsdDeviceCapture::ArrayPayload
+{
+  bool IsObjectArray = false;
+  std::vector<uint64_t> ObjectIds;  // Object arrays
+  const void* Data = nullptr;       // Data arrays
+  BlobKey Key;
+  uint64_t BlobId = 0;              // Data arrays, assigned by WriteBlobIfNew
+};
+
+UsdDeviceCapture::~UsdDeviceCapture()
+{
+  Close();
+}
+
+bool UsdDeviceCapture::Open(const char* fileName)
+{
+  Close();
+
+  CaptureFile.open(fileName, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+  if (!CaptureFile.is_open())
+    return false;
+
+  FileName = fileName;
+  ObjectIds.clear();
+  NextObjectId = usdCaptureDeviceId + 1;
+  WrittenBlobs.clear();
+  LastArrayDataKeys.clear();
+
+  WriteBytes(usdCaptureMagic, sizeof(usdCaptureMagic));
+  WriteValue(usdCaptureVersion);
+
+  return CaptureFile.good();
+}
+
+void UsdDeviceCapture::Close()
+{
+  if (!CaptureFile.is_open())
+    return;
+
+  WriteRecord(UsdCaptureRecord::END);
+  CaptureFile.close();
+}
+
+void UsdDeviceCapture::RecordNewObject(const void* object, ANARIDataType type, const char* subtype)
+{
+  if (!object)
+    return;
+
+  uint64_t objectId = NextObjectId++;
+  ObjectIds[object] = objectId; // Overwrites the entry of any released object previously living at the same address
+
+  WriteRecord(UsdCaptureRecord::NEW_OBJECT);
+  WriteValue(objectId);
+  WriteValue(static_cast<uint32_t>(type));
+  WriteString(subtype);
+}
+
+void UsdDeviceCapture::RecordNewArray(const UsdDataArray* array, uint8_t numDims, bool hasAppMemory)
+{
+  if (!array)
+    return;
+
+  uint64_t arrayId = NextObjectId++;
+  ObjectIds[array] = arrayId;
+
+  ArrayPayload payload;
+  if (hasAppMemory)
+  {
+    GetArrayPayload(array, payload);
+    WriteBlobIfNew(payload);
+  }
+
+  const UsdDataLayout& layout = array->getLayout();
+
+  WriteRecord(UsdCaptureRecord::NEW_ARRAY);
+  WriteValue(arrayId);
+  WriteValue(static_cast<uint32_t>(array->getType()));
+  WriteValue(numDims);
+  WriteValue(layout.numItems1);
+  WriteValue(hasAppMemory ? layout.byteStride1 : int64_t(0));
+  WriteValue(layout.numItems2);
+  WriteValue(hasAppMemory ? layout.byteStride2 : int64_t(0));
+  WriteValue(layout.numItems3);
+  WriteValue(hasAppMemory ? layout.byteStride3 : int64_t(0));
+  WriteValue(static_cast<uint8_t>(hasAppMemory));
+
+  if (hasAppMemory)
+  {
+    WriteArrayPayload(payload);
+    LastArrayDataKeys[arrayId] = payload.Key;
+  }
+}
+
+void UsdDeviceCapture::RecordArrayData(const UsdDataArray* array, bool onlyIfChanged)
+{
+  uint64_t arrayId = GetObjectId(array);
+  if (arrayId == usdCaptureNullId)
+    return;
+
+  ArrayPayload payload;
+  GetArrayPayload(array, payload);
+
+  auto lastKeyIt = LastArrayDataKeys.find(arrayId);
+  if (onlyIfChanged && lastKeyIt != LastArrayDataKeys.end() && lastKeyIt->second == payload.Key)
+    return;
+
+  WriteBlobIfNew(payload);
+
+  WriteRecord(UsdCaptureRecord::ARRAY_DATA);
+  WriteValue(arrayId);
+  WriteArrayPayload(payload);
+
+  LastArrayDataKeys[arrayId] = payload.Key;
+}
+
+void UsdDeviceCapture::RecordSetParameter(const void* object, const char* name, ANARIDataType type, const void* mem)
+{
+  UsdCaptureParamKind kind = UsdCaptureParamKind::VALUE;
+  size_t valueSize = 0;
+
+  if (anari::isObject(type))
+    kind = UsdCaptureParamKind::OBJECT;
+  else if (type == ANARI_STRING)
+    kind = UsdCaptureParamKind::STRING;
+  else
+  {
+    switch (type)
+    {
+    // Process-local pointers cannot be replayed, but null pointers trigger actions such as usd::garbagecollect
+    case ANARI_VOID_POINTER:
+      if (mem)
+        return;
+      break;
+    case ANARI_FUNCTION_POINTER:
+    case ANARI_MEMORY_DELETER:
+    case ANARI_STATUS_CALLBACK:
+    case ANARI_FRAME_COMPLETION_CALLBACK:
+    case ANARI_DEVICE:
+    case ANARI_LIBRARY:
+      return;
+    default:
+      valueSize = AnariTypeSize(type);
+      if (valueSize == 0)
+        return;
+      break;
+    }
+  }
+
+  WriteRecord(UsdCaptureRecord::SET_PARAM);
+  WriteValue(object ? GetObjectId(object) : usdCaptureDeviceId);
+  WriteString(name);
+  WriteValue(static_cast<uint32_t>(type));
+  WriteValue(static_cast<uint8_t>(kind));
+
+  switch (kind)
+  {
+  case UsdCaptureParamKind::OBJECT:
+    WriteValue(GetObjectId(*reinterpret_cast<const ANARIObject*>(mem)));
+    break;
+  case UsdCaptureParamKind::STRING:
+    WriteString(static_cast<const char*>(mem));
+    break;
+  default:
+    WriteValue(static_cast<uint32_t>(valueSize));
+    WriteBytes(mem, valueSize);
+    break;
+  }
+}
+
+void UsdDeviceCapture::RecordUnsetParameter(const void* object, const char* name)
+{
+  WriteRecord(UsdCaptureRecord::UNSET_PARAM);
+  WriteValue(object ? GetObjectId(object) : usdCaptureDeviceId);
+  WriteString(name);
+}
+
+void UsdDeviceCapture::RecordCommit(const void* object)
+{
+  WriteRecord(UsdCaptureRecord::COMMIT);
+  WriteValue(object ? GetObjectId(object) : usdCaptureDeviceId);
+}
+
+void UsdDeviceCapture::RecordRelease(const void* object)
+{
+  if (!object)
+    return;
+
+  WriteRecord(UsdCaptureRecord::RELEASE);
+  WriteValue(GetObjectId(object));
+}
+
+void UsdDeviceCapture::RecordRetain(const void* object)
+{
+  if (!object)
+    return;
+
+  WriteRecord(UsdCaptureRecord::RETAIN);
+  WriteValue(GetObjectId(object));
+}
+
+void UsdDeviceCapture::RecordRenderFrame(const void* frame)
+{
+  WriteRecord(UsdCaptureRecord::RENDER_FRAME);
+  WriteValue(GetObjectId(frame));
+}
+
+uint64_t UsdDeviceCapture::GetObjectId(const void* object) const
+{
+  auto idIt = ObjectIds.find(object);
+  return idIt != ObjectIds.end() ? idIt->second : usdCaptureNullId;
+}
+
+void UsdDeviceCapture::GetArrayPayload(const UsdDataArray* array, ArrayPayload& payload) const
+{
+  payload.IsObjectArray = anari::isObject(array->getType());
+
+  if (payload.IsObjectArray)
+  {
+    const ANARIObject* objects = static_cast<const ANARIObject*>(array->getData());
+    uint64_t numObjects = objects ? array->getLayout().numItems1 : 0;
+
+    payload.ObjectIds.resize(numObjects);
+    for (uint64_t i = 0; i < numObjects; ++i)
+      payload.ObjectIds[i] = GetObjectId(objects[i]);
+
+    payload.Key = HashPayload(payload.ObjectIds.data(), numObjects * sizeof(uint64_t));
+  }
+  else
+  {
+    payload.Data = array->getData();
+    payload.Key = HashPayload(payload.Data, payload.Data ? array->getDataSizeInBytes() : 0);
+  }
+}
+
+void UsdDeviceCapture::WriteBlobIfNew(ArrayPayload& payload)
+{
+  if (payload.IsObjectArray)
+    return;
+
+  auto blobIt = WrittenBlobs.emplace(payload.Key, WrittenBlobs.size() + 1);
+  payload.BlobId = blobIt.first->second;
+  if (!blobIt.second)
+    return;
+
+  WriteRecord(UsdCaptureRecord::BLOB);
+  WriteValue(payload.BlobId);
+  WriteValue(payload.Key.NumBytes);
+  WriteBytes(payload.Data, payload.Key.NumBytes);
+}
+
+void UsdDeviceCapture::WriteArrayPayload(const ArrayPayload& payload)
+{
+  WriteValue(static_cast<uint8_t>(payload.IsObjectArray));
+
+  if (payload.IsObjectArray)
+  {
+    WriteValue(static_cast<uint64_t>(payload.ObjectIds.size()));
+    WriteBytes(payload.ObjectIds.data(), payload.Key.NumBytes);
+  }
+  else
+  {
+    WriteValue(payload.BlobId);
+    WriteValue(payload.Key.NumBytes);
+  }
+}
+
+void UsdDeviceCapture::WriteString(const char* str)
+{
+  uint32_t length = str ? static_cast<uint32_t>(std::strlen(str)) : 0;
+  WriteValue(length);
+  WriteBytes(str, length);
+}
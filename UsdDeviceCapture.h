@@ -0,0 +1,81 @@
+// Copyright 2020 The Khronos Group
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "anari/anari_enums.h"
+#include "UsdDeviceCaptureFormat.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+class UsdDataArray;
+
+// Records the API calls made on a UsdDevice into a binary capture (see UsdDeviceCaptureFormat.h),
+// which can be re-executed with the usdDeviceReplay tool. Array contents are hashed,
+// so identical payloads are only stored once per capture.
+class UsdDeviceCapture
+{
+  public:
+    ~UsdDeviceCapture();
+
+    bool Open(const char* fileName);
+    void Close();
+    bool IsOpen() const { return CaptureFile.is_open(); }
+    const std::string& GetFileName() const { return FileName; }
+
+    // A nullptr object refers to the device
+    void RecordNewObject(const void* object, ANARIDataType type, const char* subtype);
+    void RecordNewArray(const UsdDataArray* array, uint8_t numDims, bool hasAppMemory);
+    void RecordArrayData(const UsdDataArray* array, bool onlyIfChanged);
+    void RecordSetParameter(const void* object, const char* name, ANARIDataType type, const void* mem);
+    void RecordUnsetParameter(const void* object, const char* name);
+    void RecordCommit(const void* object);
+    void RecordRelease(const void* object);
+    void RecordRetain(const void* object);
+    void RecordRenderFrame(const void* frame);
+
+    // Identifies array contents by 128-bit hash and size
+    struct BlobKey
+    {
+      uint64_t Hash[2] = {0, 0};
+      uint64_t NumBytes = 0;
+
+      bool operator==(const BlobKey& other) const
+      {
+        return Hash[0] == other.Hash[0] && Hash[1] == other.Hash[1] && NumBytes == other.NumBytes;
+      }
+    };
+
+  protected:
+    struct BlobKeyHasher
+    {
+      size_t operator()(const BlobKey& key) const { return static_cast<size_t>(key.Hash[0]); }
+    };
+
+    struct ArrayPayload;
+
+    uint64_t GetObjectId(const void* object) const;
+    void GetArrayPayload(const UsdDataArray* array, ArrayPayload& payload) const;
+
+    void WriteRecord(UsdCaptureRecord record) { WriteValue(static_cast<uint8_t>(record)); }
+    void WriteString(const char* str);
+    void WriteBytes(const void* bytes, size_t numBytes) { CaptureFile.write(static_cast<const char*>(bytes), numBytes); }
+    template<typename T>
+    void WriteValue(T value) { WriteBytes(&value, sizeof(T)); }
+
+    // Writes a BLOB record for the payload contents, unless they have been stored before
+    void WriteBlobIfNew(ArrayPayload& payload);
+    void WriteArrayPayload(const ArrayPayload& payload);
+
+    std::ofstream CaptureFile;
+    std::string FileName;
+
+    std::unordered_map<const void*, uint64_t> ObjectIds;
+    uint64_t NextObjectId = usdCaptureDeviceId + 1;
+
+    std::unordered_map<BlobKey, uint64_t, BlobKeyHasher> WrittenBlobs; // Blob id of each stored payload
+    std::unordered_map<uint64_t, BlobKey> LastArrayDataKeys;          // Array id to key of last recorded payload
+};
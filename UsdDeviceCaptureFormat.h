@@ -0,0 +1,53 @@
+// Copyright 2020 The Khronos Group
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+
+// Binary layout of a usd device capture, shared between UsdDeviceCapture and the usdDeviceReplay tool.
+//
+// A capture starts with usdCaptureMagic and usdCaptureVersion (uint32), followed by a sequence of records,
+// each introduced by a UsdCaptureRecord byte and terminated by UsdCaptureRecord::END.
+// All values are little-endian; strings are stored as uint32 length + characters (no terminator).
+// Objects are referred to by capture id; id 0 is a null handle, id 1 is the device itself.
+//
+// NEW_OBJECT:   u64 id, u32 ANARIDataType, str subtype
+// NEW_ARRAY:    u64 id, u32 element ANARIDataType, u8 numDims (1-3), 3x (u64 numItems, i64 byteStride), u8 hasAppMemory, [payload]
+// ARRAY_DATA:   u64 id, payload
+// BLOB:         u64 blob id, u64 size, bytes. Always written before the first payload referring to it.
+// SET_PARAM:    u64 id, str name, u32 ANARIDataType, u8 UsdCaptureParamKind, value
+//                 VALUE: u32 size, bytes (size 0 for null ANARI_VOID_POINTER triggers); STRING: str; OBJECT: u64 id
+// UNSET_PARAM:  u64 id, str name
+// COMMIT, RELEASE, RETAIN, RENDER_FRAME: u64 id
+//
+// An array payload is u8 isObjectArray, followed by either u64 count + count x u64 id (object arrays),
+// or u64 blob id + u64 size referring to a previously written BLOB (data arrays).
+
+static const char usdCaptureMagic[8] = { 'U','S','D','C','A','P','T','\0' };
+static const uint32_t usdCaptureVersion = 3;
+
+static const uint64_t usdCaptureNullId = 0;
+static const uint64_t usdCaptureDeviceId = 1;
+
+enum class UsdCaptureRecord : uint8_t
+{
+  END = 0,
+  NEW_OBJECT,
+  NEW_ARRAY,
+  ARRAY_DATA,
+  BLOB,
+  SET_PARAM,
+  UNSET_PARAM,
+  COMMIT,
+  RELEASE,
+  RETAIN,
+  RENDER_FRAME
+};
+
+enum class UsdCaptureParamKind : uint8_t
+{
+  VALUE = 0,
+  STRING,
+  OBJECT
+};
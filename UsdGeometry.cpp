@@ -39,26 +39,38 @@ namespace
     return (bool)(value & (1 << bit));
   }
 
-  size_t getIndex(const void* indices, ANARIDataType type, size_t elt)
+  // Element idx of an array, following its byte stride, so interleaved (array-of-structs) buffers are read in place
+  const void* getElement(const UsdDataArray* array, size_t idx)
   {
+    return static_cast<const char*>(array->getData()) + (int64_t)idx * array->getLayout().byteStride1;
+  }
+
+  size_t getIndex(const UsdDataArray* indices, size_t elt)
+  {
+    // Indices of vector types are addressed per component
+    ANARIDataType type = indices->getType();
+    bool isVec2 = (type == ANARI_INT32_VEC2 || type == ANARI_UINT32_VEC2 || type == ANARI_INT64_VEC2 || type == ANARI_UINT64_VEC2);
+    size_t comp = isVec2 ? elt % 2 : 0;
+    const void* index = getElement(indices, isVec2 ? elt / 2 : elt);
+
     size_t result;
     switch (type)
     {
       case ANARI_INT32:
       case ANARI_INT32_VEC2:
-        result = (reinterpret_cast<const int*>(indices))[elt];
+        result = (reinterpret_cast<const int*>(index))[comp];
         break;
       case ANARI_UINT32:
       case ANARI_UINT32_VEC2:
-        result = (reinterpret_cast<const uint32_t*>(indices))[elt];
+        result = (reinterpret_cast<const uint32_t*>(index))[comp];
         break;
       case ANARI_INT64:
       case ANARI_INT64_VEC2:
-        result = (reinterpret_cast<const int64_t*>(indices))[elt];
+        result = (reinterpret_cast<const int64_t*>(index))[comp];
         break;
       case ANARI_UINT64:
       case ANARI_UINT64_VEC2:
-        result = (reinterpret_cast<const uint64_t*>(indices))[elt];
+        result = (reinterpret_cast<const uint64_t*>(index))[comp];
         break;
       default:
         result = 0;
@@ -67,72 +79,42 @@ namespace
     return result;
   }
 
-  void getValues1(const void* vertices, ANARIDataType type, size_t idx, float* result)
+  template<int NumComponents>
+  void getValues(const UsdDataArray* array, ANARIDataType floatType, ANARIDataType doubleType, size_t idx, float* result)
   {
-    if (type == ANARI_FLOAT32)
+    ANARIDataType type = array->getType();
+    if (type == floatType)
     {
-      const float* vertf = reinterpret_cast<const float*>(vertices);
-      result[0] = vertf[idx];
+      const float* valf = reinterpret_cast<const float*>(getElement(array, idx));
+      for (int i = 0; i < NumComponents; ++i)
+        result[i] = valf[i];
     }
-    else if (type == ANARI_FLOAT64)
+    else if (type == doubleType)
     {
-      const double* vertd = reinterpret_cast<const double*>(vertices);
-      result[0] = (float)vertd[idx];
+      const double* vald = reinterpret_cast<const double*>(getElement(array, idx));
+      for (int i = 0; i < NumComponents; ++i)
+        result[i] = (float)vald[i];
     }
   }
 
-  void getValues2(const void* vertices, ANARIDataType type, size_t idx, float* result)
+  void getValues1(const UsdDataArray* array, size_t idx, float* result)
   {
-    if (type == ANARI_FLOAT32_VEC2)
-    {
-      const float* vertf = reinterpret_cast<const float*>(vertices);
-      result[0] = vertf[idx * 2];
-      result[1] = vertf[idx * 2 + 1];
-    }
-    else if (type == ANARI_FLOAT64_VEC2)
-    {
-      const double* vertd = reinterpret_cast<const double*>(vertices);
-      result[0] = (float)vertd[idx * 2];
-      result[1] = (float)vertd[idx * 2 + 1];
-    }
+    getValues<1>(array, ANARI_FLOAT32, ANARI_FLOAT64, idx, result);
   }
 
-  void getValues3(const void* vertices, ANARIDataType type, size_t idx, float* result)
+  void getValues2(const UsdDataArray* array, size_t idx, float* result)
   {
-    if (type == ANARI_FLOAT32_VEC3)
-    {
-      const float* vertf = reinterpret_cast<const float*>(vertices);
-      result[0] = vertf[idx * 3];
-      result[1] = vertf[idx * 3 + 1];
-      result[2] = vertf[idx * 3 + 2];
-    }
-    else if (type == ANARI_FLOAT64_VEC3)
-    {
-      const double* vertd = reinterpret_cast<const double*>(vertices);
-      result[0] = (float)vertd[idx * 3];
-      result[1] = (float)vertd[idx * 3 + 1];
-      result[2] = (float)vertd[idx * 3 + 2];
-    }
+    getValues<2>(array, ANARI_FLOAT32_VEC2, ANARI_FLOAT64_VEC2, idx, result);
   }
 
-  void getValues4(const void* vertices, ANARIDataType type, size_t idx, float* result)
+  void getValues3(const UsdDataArray* array, size_t idx, float* result)
   {
-    if (type == ANARI_FLOAT32_VEC4)
-    {
-      const float* vertf = reinterpret_cast<const float*>(vertices);
-      result[0] = vertf[idx * 3];
-      result[1] = vertf[idx * 3 + 1];
-      result[2] = vertf[idx * 3 + 2];
-      result[3] = vertf[idx * 3 + 3];
-    }
-    else if (type == ANARI_FLOAT64_VEC4)
-    {
-      const double* vertd = reinterpret_cast<const double*>(vertices);
-      result[0] = (float)vertd[idx * 3];
-      result[1] = (float)vertd[idx * 3 + 1];
-      result[2] = (float)vertd[idx * 3 + 2];
-      result[3] = (float)vertd[idx * 3 + 3];
-    }
+    getValues<3>(array, ANARI_FLOAT32_VEC3, ANARI_FLOAT64_VEC3, idx, result);
+  }
+
+  void getValues4(const UsdDataArray* array, size_t idx, float* result)
+  {
+    getValues<4>(array, ANARI_FLOAT32_VEC4, ANARI_FLOAT64_VEC4, idx, result);
   }
 
   void genereteIndexedSphereData(UsdGeometryData& paramData, UsdGeometry::TempArrays* tempArrays)
@@ -152,27 +134,25 @@ namespace
       tempArrays->TexCoordsArray.resize(perPrimTexCoords ?  numVertices*2 : 0);
       tempArrays->IdsArray.resize(numVertices, -1); // Always filled, since indices implies necessity for invisibleIds, and therefore also an Id array
 
-      const void* indices = paramData.indices->getData();
       uint64_t numIndices = paramData.indices->getLayout().numItems1;
-      ANARIDataType indexType = paramData.indices->getType();
 
       int64_t maxId = -1;
       for (uint64_t primIdx = 0; primIdx < numIndices; ++primIdx)
       {
-        size_t vertIdx = getIndex(indices, indexType, primIdx);
+        size_t vertIdx = getIndex(paramData.indices, primIdx);
 
         // Normals
         if (perPrimNormals)
         {
           float* normalsDest = &tempArrays->NormalsArray[vertIdx * 3];
-          getValues2(paramData.primitiveNormals->getData(), paramData.primitiveNormals->getType(), primIdx, normalsDest);
+          getValues2(paramData.primitiveNormals, primIdx, normalsDest);
         }
 
         // Scales
         if (perPrimScales)
         {
           float* scalesDest = &tempArrays->ScalesArray[vertIdx];
-          getValues2(paramData.primitiveRadii->getData(), paramData.primitiveRadii->getType(), primIdx, scalesDest);
+          getValues2(paramData.primitiveRadii, primIdx, scalesDest);
         }
 
         // Colors 
@@ -181,22 +161,22 @@ namespace
           float* colorsDest = &tempArrays->ColorsArray[vertIdx * 4];
           colorsDest[3] = 0.0f;
           if (paramData.vertexColors->getType() == ANARI_FLOAT32_VEC3 || paramData.vertexColors->getType() == ANARI_FLOAT64_VEC3)
-            getValues3(paramData.primitiveColors->getData(), paramData.primitiveColors->getType(), primIdx, colorsDest);
+            getValues3(paramData.primitiveColors, primIdx, colorsDest);
           else
-            getValues4(paramData.primitiveColors->getData(), paramData.primitiveColors->getType(), primIdx, colorsDest);
+            getValues4(paramData.primitiveColors, primIdx, colorsDest);
         }
 
         // Texcoords
         if (perPrimTexCoords)
         {
           float* texcoordsDest = &tempArrays->TexCoordsArray[vertIdx * 2];
-          getValues2(paramData.primitiveTexCoords->getData(), paramData.primitiveTexCoords->getType(), primIdx, texcoordsDest);
+          getValues2(paramData.primitiveTexCoords, primIdx, texcoordsDest);
         }
 
         // Ids
         if (paramData.primitiveIds)
         {
-          int64_t id = (int64_t)getIndex(paramData.primitiveIds->getData(), paramData.primitiveIds->getType(), primIdx);
+          int64_t id = (int64_t)getIndex(paramData.primitiveIds, primIdx);
           tempArrays->IdsArray[vertIdx] = id;
           if (id > maxId)
             maxId = id;
@@ -227,14 +207,10 @@ namespace
   {
     const UsdDataArray* vertexArray = paramData.vertexPositions;
     uint64_t numVertices = vertexArray->getLayout().numItems1;
-    const void* vertices = vertexArray->getData();
-    ANARIDataType vertexType = vertexArray->getType();
 
     const UsdDataArray* indexArray = paramData.indices;
     uint64_t numSticks = indexArray ? indexArray->getLayout().numItems1 : numVertices;
     uint64_t numIndices = numSticks * 2;
-    const void* indices = indexArray ? indexArray->getData() : nullptr;
-    ANARIDataType indexType = indexArray ? indexArray->getType() : ANARI_UINT32;
 
     tempArrays->PointsArray.resize(numSticks * 3);
     tempArrays->ScalesArray.resize(numSticks * 3); // Scales are always present
@@ -248,14 +224,14 @@ namespace
     for (size_t i = 0; i < numIndices; i += 2)
     {
       size_t primIdx = i / 2;
-      size_t vertIdx0 = indices ? getIndex(indices, indexType, i) : i;
-      size_t vertIdx1 = indices ? getIndex(indices, indexType, i + 1) : i + 1;
+      size_t vertIdx0 = indexArray ? getIndex(indexArray, i) : i;
+      size_t vertIdx1 = indexArray ? getIndex(indexArray, i + 1) : i + 1;
       assert(vertIdx0 < numVertices);
       assert(vertIdx1 < numVertices);
 
       float point0[3], point1[3];
-      getValues3(vertices, vertexType, vertIdx0, point0);
-      getValues3(vertices, vertexType, vertIdx1, point1);
+      getValues3(vertexArray, vertIdx0, point0);
+      getValues3(vertexArray, vertIdx1, point1);
 
       tempArrays->PointsArray[primIdx * 3] = (point0[0] + point1[0]) * 0.5f;
       tempArrays->PointsArray[primIdx * 3 + 1] = (point0[1] + point1[1]) * 0.5f;
@@ -264,11 +240,11 @@ namespace
       float scaleVal = paramData.radiusConstant;
       if (paramData.vertexRadii)
       {
-        getValues1(paramData.vertexRadii->getData(), paramData.vertexRadii->getType(), vertIdx0, &scaleVal);
+        getValues1(paramData.vertexRadii, vertIdx0, &scaleVal);
       }
       else if (paramData.primitiveRadii)
       {
-        getValues1(paramData.primitiveRadii->getData(), paramData.primitiveRadii->getType(), primIdx, &scaleVal);
+        getValues1(paramData.primitiveRadii, primIdx, &scaleVal);
       }
 
       float segDir[3] = {
@@ -323,47 +299,47 @@ namespace
         float* colorsDest = &tempArrays->ColorsArray[primIdx * 4];
         colorsDest[3] = 0.0f;
         if (paramData.vertexColors->getType() == ANARI_FLOAT32_VEC3 || paramData.vertexColors->getType() == ANARI_FLOAT64_VEC3)
-          getValues3(paramData.vertexColors->getData(), paramData.vertexColors->getType(), vertIdx0, colorsDest);
+          getValues3(paramData.vertexColors, vertIdx0, colorsDest);
         else
-          getValues4(paramData.vertexColors->getData(), paramData.vertexColors->getType(), vertIdx0, colorsDest);
+          getValues4(paramData.vertexColors, vertIdx0, colorsDest);
       }
       else if (paramData.primitiveColors)
       {
         float* colorsDest = &tempArrays->ColorsArray[primIdx * 4];
         colorsDest[3] = 0.0f;
         if (paramData.vertexColors->getType() == ANARI_FLOAT32_VEC3 || paramData.vertexColors->getType() == ANARI_FLOAT64_VEC3)
-          getValues3(paramData.primitiveColors->getData(), paramData.primitiveColors->getType(), primIdx, colorsDest);
+          getValues3(paramData.primitiveColors, primIdx, colorsDest);
         else
-          getValues4(paramData.primitiveColors->getData(), paramData.primitiveColors->getType(), primIdx, colorsDest);
+          getValues4(paramData.primitiveColors, primIdx, colorsDest);
       }
 
       // Texcoords
       if (paramData.vertexTexCoords)
       {
         float* texcoordsDest = &tempArrays->TexCoordsArray[primIdx * 2];
-        getValues2(paramData.vertexTexCoords->getData(), paramData.vertexTexCoords->getType(), vertIdx0, texcoordsDest);
+        getValues2(paramData.vertexTexCoords, vertIdx0, texcoordsDest);
       }
       else if (paramData.primitiveTexCoords)
       {
         float* texcoordsDest = &tempArrays->TexCoordsArray[primIdx * 2];
-        getValues2(paramData.primitiveTexCoords->getData(), paramData.primitiveTexCoords->getType(), primIdx, texcoordsDest);
+        getValues2(paramData.primitiveTexCoords, primIdx, texcoordsDest);
       }
 
       // Ids
       if (paramData.primitiveIds)
       {
-        tempArrays->IdsArray[primIdx] = (int64_t)getIndex(paramData.primitiveIds->getData(), paramData.primitiveIds->getType(), primIdx);
+        tempArrays->IdsArray[primIdx] = (int64_t)getIndex(paramData.primitiveIds, primIdx);
       }
     }
   }
 
   void pushVertex(UsdGeometryData& paramData, UsdGeometry::TempArrays* tempArrays,
-    const void* vertices, ANARIDataType vertexType,
+    const UsdDataArray* vertexArray,
     bool hasNormals, bool hasColors, bool hasTexCoords, bool hasRadii,
     size_t segStart, size_t primIdx)
   {
     float point[3];
-    getValues3(vertices, vertexType, segStart, point);
+    getValues3(vertexArray, segStart, point);
     tempArrays->PointsArray.push_back(point[0]);
     tempArrays->PointsArray.push_back(point[1]);
     tempArrays->PointsArray.push_back(point[2]);
@@ -374,11 +350,11 @@ namespace
       float normals[3];
       if (paramData.vertexNormals)
       {
-        getValues3(paramData.vertexNormals->getData(), paramData.vertexNormals->getType(), segStart, normals);
+        getValues3(paramData.vertexNormals, segStart, normals);
       }
       else if (paramData.primitiveNormals)
       {
-        getValues3(paramData.primitiveNormals->getData(), paramData.primitiveNormals->getType(), primIdx, normals);
+        getValues3(paramData.primitiveNormals, primIdx, normals);
       }
 
       tempArrays->NormalsArray.push_back(normals[0]);
@@ -392,11 +368,11 @@ namespace
       float radii;
       if (paramData.vertexRadii)
       {
-        getValues1(paramData.vertexRadii->getData(), paramData.vertexRadii->getType(), segStart, &radii);
+        getValues1(paramData.vertexRadii, segStart, &radii);
       }
       else if (paramData.primitiveRadii)
       {
-        getValues1(paramData.primitiveRadii->getData(), paramData.primitiveRadii->getType(), primIdx, &radii);
+        getValues1(paramData.primitiveRadii, primIdx, &radii);
       }
 
       tempArrays->ScalesArray.push_back(radii);
@@ -410,16 +386,16 @@ namespace
       if (paramData.vertexColors)
       {
         if (paramData.vertexColors->getType() == ANARI_FLOAT32_VEC3 || paramData.vertexColors->getType() == ANARI_FLOAT64_VEC3)
-          getValues3(paramData.vertexColors->getData(), paramData.vertexColors->getType(), segStart, colors);
+          getValues3(paramData.vertexColors, segStart, colors);
         else
-          getValues4(paramData.vertexColors->getData(), paramData.vertexColors->getType(), segStart, colors);
+          getValues4(paramData.vertexColors, segStart, colors);
       }
       else if (paramData.primitiveColors)
       {
         if (paramData.vertexColors->getType() == ANARI_FLOAT32_VEC3 || paramData.vertexColors->getType() == ANARI_FLOAT64_VEC3)
-          getValues3(paramData.primitiveColors->getData(), paramData.primitiveColors->getType(), primIdx, colors);
+          getValues3(paramData.primitiveColors, primIdx, colors);
         else
-          getValues4(paramData.primitiveColors->getData(), paramData.primitiveColors->getType(), primIdx, colors);
+          getValues4(paramData.primitiveColors, primIdx, colors);
       }
 
       tempArrays->ColorsArray.push_back(colors[0]);
@@ -434,11 +410,11 @@ namespace
       float texCoords[2];
       if (paramData.vertexTexCoords)
       {
-        getValues2(paramData.vertexTexCoords->getData(), paramData.vertexTexCoords->getType(), segStart, texCoords);
+        getValues2(paramData.vertexTexCoords, segStart, texCoords);
       }
       else if (paramData.primitiveTexCoords)
       {
-        getValues2(paramData.primitiveTexCoords->getData(), paramData.primitiveTexCoords->getType(), primIdx, texCoords);
+        getValues2(paramData.primitiveTexCoords, primIdx, texCoords);
       }
 
       tempArrays->TexCoordsArray.push_back(texCoords[0]);
@@ -448,7 +424,7 @@ namespace
 
 #define PUSH_VERTEX(x, y) \
   pushVertex(paramData, tempArrays, \
-    vertices, vertexType, \
+    vertexArray, \
     hasNormals, hasColors, hasTexCoords, hasRadii, \
     x, y)
 
@@ -456,13 +432,9 @@ namespace
   {
     const UsdDataArray* vertexArray = paramData.vertexPositions;
     uint64_t numVertices = vertexArray->getLayout().numItems1;
-    const void* vertices = vertexArray->getData();
-    ANARIDataType vertexType = vertexArray->getType();
 
     const UsdDataArray* indexArray = paramData.indices;
     uint64_t numSegments = indexArray ? indexArray->getLayout().numItems1 : numVertices-1;
-    const void* indices = indexArray ? indexArray->getData() : nullptr;
-    ANARIDataType indexType = indexArray ? indexArray->getType() : ANARI_UINT32;
 
     uint64_t maxNumVerts = numSegments*2;
     tempArrays->CurveLengths.resize(0);
@@ -497,7 +469,7 @@ namespace
     int curveLength = 0;
     for (size_t primIdx = 0; primIdx < numSegments; ++primIdx)
     {
-      size_t segStart = indices ? getIndex(indices, indexType, primIdx) : primIdx;
+      size_t segStart = indexArray ? getIndex(indexArray, primIdx) : primIdx;
 
       if (primIdx != 0 && prevSegEnd != segStart)
       {
@@ -649,9 +621,7 @@ bool UsdGeometry::checkArrayConstraints(const UsdDataArray* vertexArray, const U
 
   const UsdDataLayout& attrLayout = vertexArray ? perVertLayout : perPrimLayout;
 
-  if (AssertOneDimensional(attrLayout, device, debugName, paramName)
-    || AssertNoStride(attrLayout, device, debugName, paramName)
-    )
+  if (AssertOneDimensional(attrLayout, device, debugName, paramName))
   {
     return false;
   }
@@ -684,6 +654,10 @@ bool UsdGeometry::checkGeomParams(UsdDevice* device, const char* debugName)
   success = success && checkArrayConstraints(paramData.vertexRadii, paramData.primitiveRadii, "vertex/primitive.radius", device, debugName);
   success = success && checkArrayConstraints(nullptr, paramData.primitiveIds, "primitive.id", device, debugName);
 
+  // Attribute arrays may be strided (ie. interleaved vertex buffers), indices and ids are passed on as flat arrays
+  success = success && !(paramData.indices && AssertNoStride(paramData.indices->getLayout(), device, debugName, "primitive.index"));
+  success = success && !(paramData.primitiveIds && AssertNoStride(paramData.primitiveIds->getLayout(), device, debugName, "primitive.id"));
+
   if (!success)
     return false;
 
@@ -797,12 +771,14 @@ void UsdGeometry::updateGeomData(UsdBridgeMeshData& meshData)
   meshData.NumPoints = vertices->getLayout().numItems1;
   meshData.Points = vertices->getData();
   meshData.PointsType = AnariToUsdBridgeType(vertices->getType());
+  meshData.PointsStride = vertices->getLayout().byteStride1;
 
   const UsdDataArray* normals = paramData.vertexNormals ? paramData.vertexNormals : paramData.primitiveNormals;
   if (normals)
   {
     meshData.Normals = normals->getData();
     meshData.NormalsType = AnariToUsdBridgeType(normals->getType());
+    meshData.NormalsStride = normals->getLayout().byteStride1;
     meshData.PerPrimNormals = paramData.vertexNormals ? false : true;
   }
   const UsdDataArray* colors = paramData.vertexColors ? paramData.vertexColors : paramData.primitiveColors;
@@ -810,6 +786,7 @@ void UsdGeometry::updateGeomData(UsdBridgeMeshData& meshData)
   {
     meshData.Colors = colors->getData();
     meshData.ColorsType = AnariToUsdBridgeType(colors->getType());
+    meshData.ColorsStride = colors->getLayout().byteStride1;
     meshData.PerPrimColors = paramData.vertexColors ? false : true;
   }
   const UsdDataArray* texCoords = paramData.vertexTexCoords ? paramData.vertexTexCoords : paramData.primitiveTexCoords;
@@ -817,6 +794,7 @@ void UsdGeometry::updateGeomData(UsdBridgeMeshData& meshData)
   {
     meshData.TexCoords = texCoords->getData();
     meshData.TexCoordsType = AnariToUsdBridgeType(texCoords->getType());
+    meshData.TexCoordsStride = texCoords->getLayout().byteStride1;
     meshData.PerPrimTexCoords = paramData.vertexTexCoords ? false : true;
   }
 
@@ -858,6 +836,7 @@ void UsdGeometry::updateGeomData(UsdBridgeInstancerData& instancerData)
     instancerData.NumPoints = vertices->getLayout().numItems1;
     instancerData.Points = vertices->getData();
     instancerData.PointsType = AnariToUsdBridgeType(vertices->getType());
+    instancerData.PointsStride = vertices->getLayout().byteStride1;
 
     // Normals
     if (paramData.indices && tempArrays->NormalsArray.size())
@@ -872,6 +851,7 @@ void UsdGeometry::updateGeomData(UsdBridgeInstancerData& instancerData)
       {
         instancerData.Orientations = normals->getData();
         instancerData.OrientationsType = AnariToUsdBridgeType(normals->getType());
+        instancerData.OrientationsStride = normals->getLayout().byteStride1;
       }
     }
 
@@ -888,6 +868,7 @@ void UsdGeometry::updateGeomData(UsdBridgeInstancerData& instancerData)
       {
         instancerData.Colors = colors->getData();
         instancerData.ColorsType = AnariToUsdBridgeType(colors->getType());
+        instancerData.ColorsStride = colors->getLayout().byteStride1;
       }
     }
 
@@ -904,6 +885,7 @@ void UsdGeometry::updateGeomData(UsdBridgeInstancerData& instancerData)
       {
         instancerData.TexCoords = texCoords->getData();
         instancerData.TexCoordsType = AnariToUsdBridgeType(texCoords->getType());
+        instancerData.TexCoordsStride = texCoords->getLayout().byteStride1;
       }
     }
 
@@ -920,6 +902,7 @@ void UsdGeometry::updateGeomData(UsdBridgeInstancerData& instancerData)
       {
         instancerData.Scales = radii->getData();
         instancerData.ScalesType = AnariToUsdBridgeType(radii->getType());
+        instancerData.ScalesStride = radii->getLayout().byteStride1;
       }
     }
 
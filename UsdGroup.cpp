@@ -75,8 +75,18 @@ void UsdGroup::commit(UsdDevice* device)
           surfaceHandles[i] = usdSurface->getUsdHandle();
         }
 
-        if (numModels)
+        // Only the surfaces added or removed since the last commit are passed to the bridge
+        if (surfaceRefs.update(surfaceHandles.data(), numModels, surfacesTimeVarying, timeStep))
+        {
+          if (!surfaceRefs.removed.empty())
+            usdBridge->RemoveSurfaceRefs(usdHandle, surfaceRefs.removed.data(), surfaceRefs.removed.size(), surfacesTimeVarying, timeStep);
+          if (!surfaceRefs.added.empty())
+            usdBridge->AddSurfaceRefs(usdHandle, surfaceRefs.added.data(), surfaceRefs.added.size(), surfacesTimeVarying, timeStep);
+        }
+        else if (numModels)
           usdBridge->SetSurfaceRefs(usdHandle, &surfaceHandles[0], numModels, surfacesTimeVarying, timeStep);
+        else
+          usdBridge->DeleteSurfaceRefs(usdHandle, surfacesTimeVarying, timeStep);
       }
       else
       {
@@ -86,6 +96,7 @@ void UsdGroup::commit(UsdDevice* device)
     else
     {
       usdBridge->DeleteSurfaceRefs(usdHandle, surfacesTimeVarying, timeStep);
+      surfaceRefs.invalidate();
     }
 
     if (paramData.volumes)
@@ -102,8 +113,17 @@ void UsdGroup::commit(UsdDevice* device)
           volumeHandles[i] = usdVolume->getUsdHandle();
         }
 
-        if (numModels)
+        if (volumeRefs.update(volumeHandles.data(), numModels, volumesTimeVarying, timeStep))
+        {
+          if (!volumeRefs.removed.empty())
+            usdBridge->RemoveVolumeRefs(usdHandle, volumeRefs.removed.data(), volumeRefs.removed.size(), volumesTimeVarying, timeStep);
+          if (!volumeRefs.added.empty())
+            usdBridge->AddVolumeRefs(usdHandle, volumeRefs.added.data(), volumeRefs.added.size(), volumesTimeVarying, timeStep);
+        }
+        else if (numModels)
           usdBridge->SetVolumeRefs(usdHandle, &volumeHandles[0], numModels, volumesTimeVarying, timeStep);
+        else
+          usdBridge->DeleteVolumeRefs(usdHandle, volumesTimeVarying, timeStep);
       }
       else
       {
@@ -113,6 +133,7 @@ void UsdGroup::commit(UsdDevice* device)
     else
     {
       usdBridge->DeleteVolumeRefs(usdHandle, volumesTimeVarying, timeStep);
+      volumeRefs.invalidate();
     }
 
     paramChanged = false;
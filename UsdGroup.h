@@ -4,6 +4,7 @@
 #pragma once
 
 #include "UsdBaseObject.h"
+#include "UsdRefDiff.h"
 
 class UsdDataArray;
 class UsdBridge;
@@ -37,4 +38,6 @@ class UsdGroup : public UsdBridgedBaseObject<UsdGroup, UsdGroupData, UsdGroupHan
   protected:
     std::vector<UsdSurfaceHandle> surfaceHandles; // for convenience
     std::vector<UsdVolumeHandle> volumeHandles; // for convenience
+    UsdRefDiff<UsdSurfaceHandle> surfaceRefs; // surfaceHandles as committed to the bridge
+    UsdRefDiff<UsdVolumeHandle> volumeRefs; // volumeHandles as committed to the bridge
 };
\ No newline at end of file
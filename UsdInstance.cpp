@@ -43,6 +43,34 @@ void UsdInstance::filterResetParam(const char *name)
 }
 
 void UsdInstance::commit(UsdDevice* device)
+{
+  if (device->getParams().pointInstancerThreshold > 0 && paramChanged)
+  {
+    bool anyPointInstanced = false;
+    bool anyPrim = false;
+    for (const auto& worldClassification : worldPointInstanced)
+    {
+      anyPointInstanced = anyPointInstanced || worldClassification.second;
+      anyPrim = anyPrim || !worldClassification.second;
+    }
+
+    // A changed group may change which groups the world point instances
+    if (anyPointInstanced || !anyPrim || paramData.group != worldGroup)
+      ++worldChangeCount;
+
+    // Until a world has classified the instance, and while every world point instances it, its data is authored by the worlds
+    if (!anyPrim)
+    {
+      primOutdated = true;
+      paramChanged = false;
+      return;
+    }
+  }
+
+  commitInstancePrim(device);
+}
+
+void UsdInstance::commitInstancePrim(UsdDevice* device)
 {
   if(!usdBridge)
     return;
@@ -53,7 +81,7 @@ void UsdInstance::commit(UsdDevice* device)
   if (!usdHandle.value)
     isNew = usdBridge->CreateInstance(instanceName, usdHandle);
 
-  if (paramChanged || isNew)
+  if (paramChanged || primOutdated || isNew)
   {
     double timeStep = device->getParams().timeStep;
     bool groupTimeVarying = paramData.timeVarying & 1;
@@ -80,5 +108,6 @@ void UsdInstance::commit(UsdDevice* device)
     }
 
     paramChanged = false;
+    primOutdated = false;
   }
 }
\ No newline at end of file
@@ -5,7 +5,10 @@
 
 #include "UsdBaseObject.h"
 
+#include <unordered_map>
+
 class UsdGroup;
+class UsdWorld;
 
 struct UsdInstanceData
 {
@@ -34,5 +37,18 @@ class UsdInstance : public UsdBridgedBaseObject<UsdInstance, UsdInstanceData, Us
 
     void commit(UsdDevice* device) override;
 
+    // Authors the instance's own prim. With point instancing enabled, the world authors the prims of the
+    // instances it doesn't point instance, as it decides which those are.
+    void commitInstancePrim(UsdDevice* device);
+
+    // Set by a world committing the instance, according to the number of instances of its group in that world
+    void setPointInstanced(const UsdWorld* world, bool pointInstanced) { worldPointInstanced[world] = pointInstanced; worldGroup = paramData.group; }
+    // Counts the commits a world has to pick up: changes to a point instanced instance, or to the group of any instance
+    uint64_t getWorldChangeCount() const { return worldChangeCount; }
+
   protected:
+    std::unordered_map<const UsdWorld*, bool> worldPointInstanced; // Classification by each world that committed the instance
+    bool primOutdated = false; // Changes committed while point instanced, which its own prim lacks
+    const UsdGroup* worldGroup = nullptr;
+    uint64_t worldChangeCount = 0;
 };
\ No newline at end of file
@@ -0,0 +1,73 @@
+// Copyright 2020 The Khronos Group
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "UsdBridge/UsdBridgeData.h"
+
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+// Keeps the bridge handles an object referenced at its last commit, so the next commit only has to pass
+// the references that were added or removed since, instead of the full list.
+template<typename HandleType>
+class UsdRefDiff
+{
+  public:
+    // Records handles as the committed references and fills added/removed with the difference to the previous ones.
+    // Returns false if no difference can be taken, in which case the full list has to be set; timevarying references
+    // can only be diffed within the timestep at which they were committed, as all of them are authored per timestep.
+    bool update(const HandleType* handles, uint64_t numHandles, bool timeVarying, double timeStep)
+    {
+      bool diffable = valid && timeVarying == refsTimeVarying && (!timeVarying || timeStep == refsTimeStep);
+
+      added.clear();
+      removed.clear();
+
+      newRefs.clear();
+      newRefs.reserve(numHandles);
+      for (uint64_t i = 0; i < numHandles; ++i)
+      {
+        if (newRefs.insert(handles[i].value).second && diffable && refs.find(handles[i].value) == refs.end())
+          added.push_back(handles[i]);
+      }
+
+      if (diffable)
+      {
+        for (UsdBridgePrimCache* ref : refs)
+        {
+          if (newRefs.find(ref) == newRefs.end())
+          {
+            HandleType handle;
+            handle.value = ref;
+            removed.push_back(handle);
+          }
+        }
+      }
+
+      refs.swap(newRefs);
+      valid = true;
+      refsTimeVarying = timeVarying;
+      refsTimeStep = timeStep;
+
+      return diffable;
+    }
+
+    // The next update() requires the full list to be set
+    void invalidate()
+    {
+      valid = false;
+      refs.clear();
+    }
+
+    std::vector<HandleType> added;
+    std::vector<HandleType> removed;
+
+  protected:
+    std::unordered_set<UsdBridgePrimCache*> refs;
+    std::unordered_set<UsdBridgePrimCache*> newRefs;
+    bool valid = false;
+    bool refsTimeVarying = false;
+    double refsTimeStep = 0.0;
+};
@@ -13,6 +13,8 @@ DEFINE_PARAMETER_MAP(UsdSpatialField,
   REGISTER_PARAMETER_MACRO("usd::timestep", ANARI_FLOAT64, timeStep)
   REGISTER_PARAMETER_MACRO("usd::timevarying", ANARI_INT32, timeVarying)
   REGISTER_PARAMETER_MACRO("data", ANARI_ARRAY, data)
+  REGISTER_PARAMETER_MACRO("usd::data.dims", ANARI_UINT32_VEC3, dataDims)
+  REGISTER_PARAMETER_MACRO("usd::data.region", ANARI_UINT32_VEC3, dataRegion)
   REGISTER_PARAMETER_MACRO("spacing", ANARI_FLOAT32_VEC3, gridSpacing)
   REGISTER_PARAMETER_MACRO("origin", ANARI_FLOAT32_VEC3, gridOrigin)
 ) // See .h for usage.
@@ -66,8 +68,6 @@ void UsdSpatialField::commit(UsdDevice* device)
   }
 
   const UsdDataLayout& dataLayout = fieldDataArray->getLayout();
-  if (AssertNoStride(dataLayout, device, debugName, "data"))
-    return;
 
   switch (fieldDataArray->getType())
   {
@@ -88,6 +88,22 @@ void UsdSpatialField::commit(UsdDevice* device)
     return;
   }
 
+  const uint32_t* dataDims = this->paramData.dataDims;
+  if (dataDims[0] || dataDims[1] || dataDims[2])
+  {
+    const uint32_t* dataRegion = this->paramData.dataRegion;
+    size_t regionDims[3] = { dataLayout.numItems1, dataLayout.numItems2, dataLayout.numItems3 };
+    for (int i = 0; i < 3; ++i)
+    {
+      if (dataRegion[i] + regionDims[i] > dataDims[i])
+      {
+        device->reportStatus(this, ANARI_SPATIAL_FIELD, ANARI_SEVERITY_ERROR, ANARI_STATUS_INVALID_ARGUMENT,
+          "UsdSpatialField '%s' commit failed: 'data' at 'usd::data.region' exceeds 'usd::data.dims'.", debugName);
+        return;
+      }
+    }
+  }
+
   // Make sure that parameters are set a first time
   paramChanged = paramChanged || isNew;
 
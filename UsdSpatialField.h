@@ -16,6 +16,10 @@ struct UsdSpatialFieldData
   int timeVarying = 0xFFFFFFFF; // Bitmask indicating which attributes are time-varying. 0:data, 1:gridSpacing, 2:gridOrigin
 
   const UsdDataArray* data = nullptr;
+  // Chunked ingest: with nonzero dims, data holds the region of the field at dataRegion (in elements), for fields
+  // submitted as a sequence of regions with one commit each. The field is output once its regions cover dims.
+  uint32_t dataDims[3] = {0, 0, 0};
+  uint32_t dataRegion[3] = {0, 0, 0};
   
   float gridSpacing[3] = {1.0f, 1.0f, 1.0f};
   float gridOrigin[3] = {1.0f, 1.0f, 1.0f};
@@ -139,6 +139,11 @@ bool UsdVolume::UpdateVolume(UsdDevice* device, const char* debugName)
   float* ori = volumeData.Origin;
   float* celldims = volumeData.CellDimensions;
   elts[0] = posLayout.numItems1; elts[1] = posLayout.numItems2; elts[2] = posLayout.numItems3;
+  if (!posLayout.isDense())
+  {
+    int64_t* strides = volumeData.DataStrides;
+    strides[0] = posLayout.byteStride1; strides[1] = posLayout.byteStride2; strides[2] = posLayout.byteStride3;
+  }
   ori[0] = fieldParams.gridOrigin[0]; ori[1] = fieldParams.gridOrigin[1]; ori[2] = fieldParams.gridOrigin[2];
   celldims[0] = fieldParams.gridSpacing[0]; celldims[1] = fieldParams.gridSpacing[1]; celldims[2] = fieldParams.gridSpacing[2];
 
@@ -151,7 +156,19 @@ bool UsdVolume::UpdateVolume(UsdDevice* device, const char* debugName)
   volumeData.TimeVarying = (DMI)(fieldParams.timeVarying | (paramData.timeVarying << UsdBridgeVolumeData::TFDataStart));
 
   double fieldTimeStep = field->paramData.timeStep;
-  usdBridge->SetVolumeData(field->getUsdHandle(), volumeData, fieldTimeStep);
+
+  const uint32_t* dataDims = fieldParams.dataDims;
+  if (dataDims[0] || dataDims[1] || dataDims[2])
+  {
+    // Data is a region of the field
+    size_t regionOffset[3] = { fieldParams.dataRegion[0], fieldParams.dataRegion[1], fieldParams.dataRegion[2] };
+    size_t regionDims[3] = { elts[0], elts[1], elts[2] };
+    elts[0] = dataDims[0]; elts[1] = dataDims[1]; elts[2] = dataDims[2];
+
+    usdBridge->SetVolumeRegionData(field->getUsdHandle(), volumeData, regionOffset, regionDims, fieldTimeStep);
+  }
+  else
+    usdBridge->SetVolumeData(field->getUsdHandle(), volumeData, fieldTimeStep);
 
   return true;
 }
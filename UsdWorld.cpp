@@ -4,6 +4,7 @@
 #include "UsdWorld.h"
 #include "UsdBridge/UsdBridge.h"
 #include "UsdInstance.h"
+#include "UsdGroup.h"
 #include "UsdDevice.h"
 #include "UsdDataArray.h"
 
@@ -12,6 +13,7 @@ DEFINE_PARAMETER_MAP(UsdWorld,
   REGISTER_PARAMETER_MACRO("usd::name", ANARI_STRING, usdName)
   REGISTER_PARAMETER_MACRO("usd::timevarying", ANARI_INT32, timeVarying)
   REGISTER_PARAMETER_MACRO("instance", ANARI_ARRAY, instances)
+  REGISTER_PARAMETER_MACRO("usd::instance.transform", ANARI_ARRAY, instanceTransforms)
 )
 
 
@@ -53,10 +55,27 @@ void UsdWorld::commit(UsdDevice* device)
   if(!usdHandle.value)
     isNew = usdBridge->CreateWorld(debugName, usdHandle);
 
-  if (paramChanged || isNew)
+  // Point instanced groups hold the data of the instances, which may have changed without a change to the world
+  int pointInstancerThreshold = device->getParams().pointInstancerThreshold;
+  bool instancesChanged = false;
+  if (pointInstancerThreshold > 0 && paramData.instances && paramData.instances->getType() == ANARI_INSTANCE)
+  {
+    const ANARIInstance* instances = reinterpret_cast<const ANARIInstance*>(paramData.instances->getData());
+    uint64_t numInstances = paramData.instances->getLayout().numItems1;
+
+    uint64_t changeCount = 0;
+    for (uint64_t i = 0; i < numInstances; ++i)
+      changeCount += reinterpret_cast<const UsdInstance*>(instances[i])->getWorldChangeCount();
+
+    instancesChanged = changeCount != instancesChangeCount;
+    instancesChangeCount = changeCount;
+  }
+
+  if (paramChanged || isNew || instancesChanged)
   {
     double timeStep = device->getParams().timeStep;
-    bool instancesTimeVarying = paramData.timeVarying != 0;
+    bool instancesTimeVarying = paramData.timeVarying & 1;
+    bool transformsTimeVarying = paramData.timeVarying & (1 << 1);
 
     if (paramData.instances)
     {
@@ -65,17 +84,99 @@ void UsdWorld::commit(UsdDevice* device)
         const ANARIInstance* instances = reinterpret_cast<const ANARIInstance*>(paramData.instances->getData());
 
         uint64_t numInstances = paramData.instances->getLayout().numItems1;
-        instanceHandles.resize(numInstances);
+
+        const char* transformsData = nullptr;
+        int64_t transformsStride = 0;
+        if (paramData.instanceTransforms)
+        {
+          const UsdDataLayout& transformsLayout = paramData.instanceTransforms->getLayout();
+          if (paramData.instanceTransforms->getType() != ANARI_FLOAT32_MAT3x4 || transformsLayout.numItems1 != numInstances)
+          {
+            device->reportStatus(this, ANARI_WORLD, ANARI_SEVERITY_ERROR, ANARI_STATUS_INVALID_ARGUMENT,
+              "UsdWorld '%s': 'usd::instance.transform' array should hold an ANARI_FLOAT32_MAT3x4 for each element of 'instance', ignoring it", debugName);
+          }
+          else
+          {
+            transformsData = static_cast<const char*>(paramData.instanceTransforms->getData());
+            transformsStride = transformsLayout.byteStride1;
+          }
+        }
+
+        // Groups with at least pointInstancerThreshold instances are point instanced, instead of referenced from each instance's prim
+        groupInstanceCounts.clear();
+        if (pointInstancerThreshold > 0)
+        {
+          for (uint64_t i = 0; i < numInstances; ++i)
+          {
+            const UsdGroup* group = reinterpret_cast<const UsdInstance*>(instances[i])->getParams().group;
+            if (group)
+              ++groupInstanceCounts[group];
+          }
+        }
+
+        instanceHandles.clear();
+        instancePrimTransforms.clear();
+        groupIndices.clear();
+        groupHandles.clear();
+        instanceGroupIndices.clear();
+        groupInstanceTransforms.clear();
         for (uint64_t i = 0; i < numInstances; ++i)
         {
-          const UsdInstance* usdInstance = reinterpret_cast<const UsdInstance*>(instances[i]);
-          instanceHandles[i] = usdInstance->getUsdHandle();
+          UsdInstance* usdInstance = reinterpret_cast<UsdInstance*>(instances[i]);
+          const UsdInstanceData& instanceData = usdInstance->getParams();
+          const float* transform = transformsData ? reinterpret_cast<const float*>(transformsData + (int64_t)i * transformsStride) : instanceData.transform;
+
+          auto countIt = instanceData.group ? groupInstanceCounts.find(instanceData.group) : groupInstanceCounts.end();
+          if (countIt != groupInstanceCounts.end() && countIt->second >= pointInstancerThreshold)
+          {
+            usdInstance->setPointInstanced(this, true);
+
+            auto groupIt = groupIndices.emplace(instanceData.group, int(groupHandles.size()));
+            if (groupIt.second)
+              groupHandles.push_back(instanceData.group->getUsdHandle());
+
+            instanceGroupIndices.push_back(groupIt.first->second);
+            groupInstanceTransforms.insert(groupInstanceTransforms.end(), transform, transform + 12);
+          }
+          else
+          {
+            // Only authors the prim if the instance was point instanced or changed since its own commit
+            usdInstance->setPointInstanced(this, false);
+            usdInstance->commitInstancePrim(device);
+            instanceHandles.push_back(usdInstance->getUsdHandle());
+            if (transformsData)
+              instancePrimTransforms.insert(instancePrimTransforms.end(), transform, transform + 12);
+          }
         }
 
-        if (numInstances)
-          usdBridge->SetInstanceRefs(usdHandle, &instanceHandles[0], numInstances, instancesTimeVarying, timeStep);
+        UsdBridgeGroupInstancesData groupInstances;
+        groupInstances.Groups = groupHandles.data();
+        groupInstances.NumGroups = groupHandles.size();
+        groupInstances.GroupIndices = instanceGroupIndices.data();
+        groupInstances.Transforms = groupInstanceTransforms.data();
+        groupInstances.NumInstances = instanceGroupIndices.size();
+
+        // Without point instancing, only the instances added to or removed from the world since its last commit are passed to the bridge
+        if (pointInstancerThreshold <= 0 && instanceRefs.update(instanceHandles.data(), instanceHandles.size(), instancesTimeVarying, timeStep))
+        {
+          if (!instanceRefs.removed.empty())
+            usdBridge->RemoveInstanceRefs(usdHandle, instanceRefs.removed.data(), instanceRefs.removed.size(), instancesTimeVarying, timeStep);
+          if (!instanceRefs.added.empty())
+            usdBridge->AddInstanceRefs(usdHandle, instanceRefs.added.data(), instanceRefs.added.size(), instancesTimeVarying, timeStep);
+        }
         else
-          usdBridge->DeleteInstanceRefs(usdHandle, instancesTimeVarying, timeStep);
+        {
+          if (pointInstancerThreshold > 0)
+            instanceRefs.invalidate();
+
+          if (numInstances)
+            usdBridge->SetInstanceRefs(usdHandle, instanceHandles.data(), instanceHandles.size(), groupInstances, instancesTimeVarying, timeStep);
+          else
+            usdBridge->DeleteInstanceRefs(usdHandle, instancesTimeVarying, timeStep);
+        }
+
+        if (!instancePrimTransforms.empty())
+          usdBridge->SetInstanceTransforms(instanceHandles.data(), instancePrimTransforms.data(), instanceHandles.size(), transformsTimeVarying, timeStep);
       }
       else
       {
@@ -86,6 +187,7 @@ void UsdWorld::commit(UsdDevice* device)
     else
     {
       usdBridge->DeleteInstanceRefs(usdHandle, instancesTimeVarying, timeStep);
+      instanceRefs.invalidate();
     }
 
     paramChanged = false;
@@ -4,16 +4,21 @@
 #pragma once
 
 #include "UsdBaseObject.h"
+#include "UsdRefDiff.h"
+
+#include <unordered_map>
 
 class UsdDataArray;
+class UsdGroup;
 
 struct UsdWorldData
 {
   const char* name = nullptr;
   const char* usdName = nullptr;
 
-  int timeVarying = 0xFFFFFFFF; // Bitmask indicating which attributes are time-varying. 0:instances
+  int timeVarying = 0xFFFFFFFF; // Bitmask indicating which attributes are time-varying. 0:instances, 1:instanceTransforms
   const UsdDataArray* instances = nullptr;
+  const UsdDataArray* instanceTransforms = nullptr; // Overrides the transforms of all instances at once
 };
 
 class UsdWorld : public UsdBridgedBaseObject<UsdWorld, UsdWorldData, UsdWorldHandle>
@@ -34,4 +39,14 @@ class UsdWorld : public UsdBridgedBaseObject<UsdWorld, UsdWorldData, UsdWorldHan
 
   protected:
     std::vector<UsdInstanceHandle> instanceHandles; // for convenience
+    UsdRefDiff<UsdInstanceHandle> instanceRefs; // instanceHandles as committed to the bridge
+    std::vector<float> instancePrimTransforms; // instanceTransforms of the instances in instanceHandles
+
+    // Point instanced groups and their instances
+    std::unordered_map<const UsdGroup*, int> groupInstanceCounts;
+    std::unordered_map<const UsdGroup*, int> groupIndices;
+    std::vector<UsdGroupHandle> groupHandles;
+    std::vector<int> instanceGroupIndices;
+    std::vector<float> groupInstanceTransforms;
+    uint64_t instancesChangeCount = 0; // Sum of the world change counts of the instances at the last commit
 };
\ No newline at end of file
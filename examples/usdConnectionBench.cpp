@@ -0,0 +1,262 @@
+// Copyright 2021 NVIDIA Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Local output throughput of the USD bridge connection layer, compared against plain std::ofstream,
+// for many small files (usd layers, clips), large streamed files (vdb volumes) and concurrently streamed files. Reports JSON.
+//
+// Usage: usdConnectionBench [--dir <dir>] [--smallfiles <n>] [--smallsize <kb>] [--largesize <mb>] [--directio]
+//          [--streams <n>] [--maxopen <n>]
+//
+// The concurrent test splits the large file size over <n> threads, each writing its own stream, of which at most
+// <maxopen> are open at the same time.
+//
+// Without --directio, results include the effect of the OS page cache.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Connection/UsdBridgeConnection.h"
+
+struct ConnBenchParams
+{
+  std::string dir = "./usdConnectionBench/";
+  uint64_t numSmallFiles = 2000;
+  uint64_t smallFileSize = 16 << 10;
+  uint64_t largeFileSize = 1ull << 30;
+  bool directIO = false;
+  int numStreams = 8;
+  int maxOpenStreams = 4;
+};
+
+struct ConnBenchResult
+{
+  const char* name;
+  uint64_t numFiles;
+  uint64_t numBytes;
+  double seconds;
+};
+
+static const uint64_t streamChunkSize = 1 << 20; // Matches typical vdb grid buffer writes
+
+static void logFunc(UsdBridgeLogLevel level, void* userData, const char* message)
+{
+  if (level == UsdBridgeLogLevel::ERR)
+    fprintf(stderr, "[ERROR] %s\n", message);
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point startTime)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+static std::string smallFileName(uint64_t i)
+{
+  return "small_" + std::to_string(i) + ".bin";
+}
+
+static void removeSmallFiles(const ConnBenchParams& params, UsdBridgeConnection& conn)
+{
+  for (uint64_t i = 0; i < params.numSmallFiles; ++i)
+    conn.RemoveFile(smallFileName(i).c_str());
+}
+
+static ConnBenchResult benchSmallOfstream(const ConnBenchParams& params, const std::vector<char>& data)
+{
+  auto startTime = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < params.numSmallFiles; ++i)
+  {
+    std::ofstream file(params.dir + smallFileName(i), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+    file.write(data.data(), params.smallFileSize);
+  }
+  return { "smallFiles.ofstream", params.numSmallFiles, params.numSmallFiles * params.smallFileSize, secondsSince(startTime) };
+}
+
+static ConnBenchResult benchSmallConnection(const ConnBenchParams& params, UsdBridgeConnection& conn, const std::vector<char>& data)
+{
+  auto startTime = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < params.numSmallFiles; ++i)
+  {
+    if (!conn.WriteFile(data.data(), params.smallFileSize, smallFileName(i).c_str()))
+      fprintf(stderr, "[ERROR] WriteFile failed\n");
+  }
+  return { "smallFiles.connection", params.numSmallFiles, params.numSmallFiles * params.smallFileSize, secondsSince(startTime) };
+}
+
+static ConnBenchResult benchSmallGather(const ConnBenchParams& params, UsdBridgeConnection& conn, const std::vector<char>& data)
+{
+  // Same contents, split in a header and body range
+  uint64_t headerSize = std::min<uint64_t>(256, params.smallFileSize);
+  UsdBridgeWriteRange ranges[2] = {
+    { data.data(), headerSize },
+    { data.data() + headerSize, params.smallFileSize - headerSize }
+  };
+
+  auto startTime = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < params.numSmallFiles; ++i)
+  {
+    if (!conn.WriteFileGather(ranges, 2, smallFileName(i).c_str()))
+      fprintf(stderr, "[ERROR] WriteFileGather failed\n");
+  }
+  return { "smallFiles.connectionGather", params.numSmallFiles, params.numSmallFiles * params.smallFileSize, secondsSince(startTime) };
+}
+
+static ConnBenchResult benchLargeOfstream(const ConnBenchParams& params, const std::vector<char>& chunk)
+{
+  auto startTime = std::chrono::steady_clock::now();
+  {
+    std::ofstream file(params.dir + "large.bin", std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+    for (uint64_t written = 0; written < params.largeFileSize; written += streamChunkSize)
+      file.write(chunk.data(), std::min(streamChunkSize, params.largeFileSize - written));
+  }
+  return { "largeFile.ofstream", 1, params.largeFileSize, secondsSince(startTime) };
+}
+
+static ConnBenchResult benchLargeConnectionStream(const ConnBenchParams& params, UsdBridgeConnection& conn, const std::vector<char>& chunk)
+{
+  auto startTime = std::chrono::steady_clock::now();
+  std::ostream* stream = conn.GetStream("large.bin");
+  if (stream)
+  {
+    for (uint64_t written = 0; written < params.largeFileSize; written += streamChunkSize)
+      stream->write(chunk.data(), std::min(streamChunkSize, params.largeFileSize - written));
+    conn.FlushStream();
+  }
+  else
+    fprintf(stderr, "[ERROR] GetStream failed\n");
+  return { "largeFile.connectionStream", 1, params.largeFileSize, secondsSince(startTime) };
+}
+
+static ConnBenchResult benchLargeConnectionWrite(const ConnBenchParams& params, UsdBridgeConnection& conn)
+{
+  std::vector<char> data(params.largeFileSize, 'x');
+
+  auto startTime = std::chrono::steady_clock::now();
+  if (!conn.WriteFile(data.data(), data.size(), "large.bin"))
+    fprintf(stderr, "[ERROR] WriteFile failed\n");
+  return { "largeFile.connectionWrite", 1, params.largeFileSize, secondsSince(startTime) };
+}
+
+static std::string streamFileName(int i)
+{
+  return "stream_" + std::to_string(i) + ".bin";
+}
+
+static ConnBenchResult benchConcurrentStreams(const ConnBenchParams& params, UsdBridgeConnection& conn, const std::vector<char>& chunk)
+{
+  uint64_t streamFileSize = params.largeFileSize / params.numStreams;
+
+  auto startTime = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < params.numStreams; ++i)
+  {
+    threads.emplace_back([&conn, &chunk, streamFileSize, i]()
+    {
+      UsdBridgeOutputStream* stream = conn.OpenStream(streamFileName(i).c_str());
+      if (!stream)
+      {
+        fprintf(stderr, "[ERROR] OpenStream failed\n");
+        return;
+      }
+      for (uint64_t written = 0; written < streamFileSize; written += streamChunkSize)
+        stream->GetOutput().write(chunk.data(), std::min(streamChunkSize, streamFileSize - written));
+      if (!conn.CloseStream(stream))
+        fprintf(stderr, "[ERROR] CloseStream failed\n");
+    });
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+  return { "concurrentStreams.connection", (uint64_t)params.numStreams, streamFileSize * params.numStreams, secondsSince(startTime) };
+}
+
+int main(int argc, const char** argv)
+{
+  ConnBenchParams params;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp(argv[i], "--dir") == 0 && i + 1 < argc)
+    {
+      params.dir = argv[++i];
+      if (params.dir.back() != '/' && params.dir.back() != '\\')
+        params.dir += '/';
+    }
+    else if (strcmp(argv[i], "--smallfiles") == 0 && i + 1 < argc)
+      params.numSmallFiles = strtoull(argv[++i], nullptr, 10);
+    else if (strcmp(argv[i], "--smallsize") == 0 && i + 1 < argc)
+      params.smallFileSize = strtoull(argv[++i], nullptr, 10) << 10;
+    else if (strcmp(argv[i], "--largesize") == 0 && i + 1 < argc)
+      params.largeFileSize = strtoull(argv[++i], nullptr, 10) << 20;
+    else if (strcmp(argv[i], "--directio") == 0)
+      params.directIO = true;
+    else if (strcmp(argv[i], "--streams") == 0 && i + 1 < argc)
+      params.numStreams = std::max(atoi(argv[++i]), 1);
+    else if (strcmp(argv[i], "--maxopen") == 0 && i + 1 < argc)
+      params.maxOpenStreams = std::max(atoi(argv[++i]), 1);
+    else
+    {
+      fprintf(stderr, "Usage: %s [--dir <dir>] [--smallfiles <n>] [--smallsize <kb>] [--largesize <mb>] [--directio] [--streams <n>] [--maxopen <n>]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  UsdBridgeConnectionSettings settings;
+  settings.WorkingDirectory = params.dir;
+  settings.DirectIO = params.directIO;
+  settings.MaxOpenStreams = params.maxOpenStreams;
+
+  UsdBridgeLocalConnection conn;
+  if (!conn.Initialize(settings, logFunc, nullptr))
+  {
+    fprintf(stderr, "ERROR: could not initialize output directory %s\n", params.dir.c_str());
+    return 1;
+  }
+
+  std::vector<char> smallData(params.smallFileSize);
+  for (size_t i = 0; i < smallData.size(); ++i)
+    smallData[i] = (char)(i * 31 + 7);
+  std::vector<char> chunk(streamChunkSize);
+  for (size_t i = 0; i < chunk.size(); ++i)
+    chunk[i] = (char)(i * 13 + 3);
+
+  // Output is removed after each test, as overwriting existing files has a different cost than creating them
+  std::vector<ConnBenchResult> results;
+  results.push_back(benchSmallOfstream(params, smallData));
+  removeSmallFiles(params, conn);
+  results.push_back(benchSmallConnection(params, conn, smallData));
+  removeSmallFiles(params, conn);
+  results.push_back(benchSmallGather(params, conn, smallData));
+  removeSmallFiles(params, conn);
+  results.push_back(benchLargeOfstream(params, chunk));
+  conn.RemoveFile("large.bin");
+  results.push_back(benchLargeConnectionStream(params, conn, chunk));
+  conn.RemoveFile("large.bin");
+  results.push_back(benchLargeConnectionWrite(params, conn));
+  conn.RemoveFile("large.bin");
+  results.push_back(benchConcurrentStreams(params, conn, chunk));
+  for (int i = 0; i < params.numStreams; ++i)
+    conn.RemoveFile(streamFileName(i).c_str());
+
+  conn.Shutdown();
+
+  printf("{\n  \"directIO\": %s,\n  \"streams\": %d,\n  \"maxOpenStreams\": %d,\n  \"results\": [\n",
+    params.directIO ? "true" : "false", params.numStreams, params.maxOpenStreams);
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const ConnBenchResult& result = results[i];
+    double megaBytes = result.numBytes / (1024.0 * 1024.0);
+    printf("    { \"name\": \"%s\", \"files\": %llu, \"bytes\": %llu, \"seconds\": %.6f, \"MBps\": %.2f, \"filesPerSecond\": %.1f }%s\n",
+      result.name, (unsigned long long)result.numFiles, (unsigned long long)result.numBytes, result.seconds,
+      result.seconds > 0.0 ? megaBytes / result.seconds : 0.0,
+      result.seconds > 0.0 ? result.numFiles / result.seconds : 0.0,
+      i + 1 < results.size() ? "," : "");
+  }
+  printf("  ]\n}\n");
+
+  return 0;
+}
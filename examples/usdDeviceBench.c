@@ -0,0 +1,919 @@
+// Copyright 2021 NVIDIA Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Synthetic workloads for the USD device, reporting per-phase timings, throughput and peak RSS as JSON.
+//
+// Usage: usdDeviceBench [--location <dir>|void] [--workload <name>|all] [--scale <n>]
+//                       [--timesteps <n>] [--binary] [--pointinstancer <n>] [--batching on|off|compare]
+//                       [--parallel on|off|compare] [--output <file.json>]
+//
+// With "--location void" (default), no files are written and the bridge authoring cost is measured in isolation.
+// With "--batching compare", each workload is run with and without usd::batchchanges.
+// With "--parallel compare", each workload is run with and without usd::parallelwrites.
+// Each run happens in a child process where fork() is available, so its peak RSS is not that of an earlier run.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+#include "anari/anari.h"
+
+const char *g_libraryType = "usd";
+
+typedef struct
+{
+  const char* location;
+  const char* workload;
+  const char* outputFile;
+  uint64_t scale;
+  int timeSteps; // 0 means workload default
+  int outputBinary;
+  int pointInstancerThreshold; // usd::pointinstancer.threshold, 0 disables point instancing
+  const char* batching; // usd::batchchanges: "on", "off" or "compare"
+  const char* parallel; // usd::parallelwrites: "on", "off" or "compare"
+} BenchParams;
+
+typedef struct
+{
+  ANARIDevice dev;
+  const BenchParams* params;
+  uint64_t scale;
+
+  ANARIWorld world;
+  ANARIGeometry geom;
+  ANARIMaterial mat;
+  ANARISurface surface;
+  ANARISpatialField field;
+  ANARIVolume volume;
+  ANARIGroup group;
+  ANARIInstance* instances;
+  uint64_t numInstances;
+  ANARIGeometry* geoms; // Independent geometries, each with its own surface
+  ANARISurface* surfaces;
+  uint64_t numGeoms;
+
+  float* positions;
+  float* attribs;
+  uint32_t* indices;
+  uint64_t numPositions;
+  uint64_t numIndices;
+
+  uint64_t bytesSubmitted;
+  uint64_t numPrimitives;
+} BenchContext;
+
+typedef void (*BenchSetupFunc)(BenchContext* ctx);
+typedef void (*BenchUpdateFunc)(BenchContext* ctx, int timeStep);
+
+typedef struct
+{
+  const char* name;
+  uint64_t defaultScale;
+  int defaultTimeSteps;
+  BenchSetupFunc setup;
+  BenchUpdateFunc update;
+} BenchWorkload;
+
+typedef struct
+{
+  const char* name;
+  uint64_t scale;
+  int timeSteps;
+  int batchChanges;
+  int parallelWrites;
+  double setupSec;
+  double updateSec;
+  double garbageCollectSec;
+  double releaseSec;
+  uint64_t bytesSubmitted;
+  uint64_t numPrimitives;
+  long peakRssKB;
+} BenchResult;
+
+/******************************************************************/
+static double nowSeconds(void)
+{
+#ifdef _WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+static long peakRssKB(void)
+{
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return (long)(counters.PeakWorkingSetSize / 1024);
+  return -1;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+    return usage.ru_maxrss; // Kilobytes on Linux
+  return -1;
+#endif
+}
+
+void statusFunc(void *userData,
+  ANARIDevice device,
+  ANARIObject source,
+  ANARIDataType sourceType,
+  ANARIStatusSeverity severity,
+  ANARIStatusCode code,
+  const char *message)
+{
+  (void)userData;
+  if (severity == ANARI_SEVERITY_FATAL_ERROR) {
+    fprintf(stderr, "[FATAL] %s\n", message);
+  }
+  else if (severity == ANARI_SEVERITY_ERROR) {
+    fprintf(stderr, "[ERROR] %s\n", message);
+  }
+}
+
+/******************************************************************/
+static void setArrayParam(BenchContext* ctx, ANARIObject obj, const char* paramName,
+  const void* data, ANARIDataType type, uint64_t numItems, uint64_t typeSize)
+{
+  ANARIArray1D array = anariNewArray1D(ctx->dev, data, 0, 0, type, numItems, 0);
+  anariCommit(ctx->dev, array);
+  anariSetParameter(ctx->dev, obj, paramName, ANARI_ARRAY, &array);
+  anariRelease(ctx->dev, array);
+
+  ctx->bytesSubmitted += numItems * typeSize;
+}
+
+static void setObjectArrayParam(BenchContext* ctx, ANARIObject obj, const char* paramName,
+  const void* objects, ANARIDataType type, uint64_t numItems)
+{
+  ANARIArray1D array = anariNewArray1D(ctx->dev, objects, 0, 0, type, numItems, 0);
+  anariCommit(ctx->dev, array);
+  anariSetParameter(ctx->dev, obj, paramName, ANARI_ARRAY, &array);
+  anariRelease(ctx->dev, array);
+}
+
+static void setTimeStepParam(BenchContext* ctx, ANARIObject obj, int timeStep)
+{
+  double timeValue = (double)timeStep;
+  anariSetParameter(ctx->dev, obj, "usd::timestep", ANARI_FLOAT64, &timeValue);
+}
+
+// Wraps ctx->geom, ctx->geoms or ctx->volume into surfaces/volume, group, instance and world.
+static void createSceneHierarchy(BenchContext* ctx)
+{
+  ANARIDevice dev = ctx->dev;
+
+  ctx->group = anariNewGroup(dev);
+  anariSetParameter(dev, ctx->group, "name", ANARI_STRING, "benchGroup");
+
+  if (ctx->geom || ctx->geoms)
+  {
+    float kd[] = { 0.8f, 0.8f, 0.8f };
+    ctx->mat = anariNewMaterial(dev, "matte");
+    anariSetParameter(dev, ctx->mat, "name", ANARI_STRING, "benchMaterial");
+    anariSetParameter(dev, ctx->mat, "color", ANARI_FLOAT32_VEC3, kd);
+    anariCommit(dev, ctx->mat);
+  }
+  if (ctx->geoms)
+  {
+    ctx->surfaces = (ANARISurface*)calloc(ctx->numGeoms, sizeof(ANARISurface));
+    for (uint64_t i = 0; i < ctx->numGeoms; ++i)
+    {
+      char surfName[64];
+      snprintf(surfName, sizeof(surfName), "benchSurface_%llu", (unsigned long long)i);
+
+      ctx->surfaces[i] = anariNewSurface(dev);
+      anariSetParameter(dev, ctx->surfaces[i], "name", ANARI_STRING, surfName);
+      anariSetParameter(dev, ctx->surfaces[i], "geometry", ANARI_GEOMETRY, ctx->geoms + i);
+      anariSetParameter(dev, ctx->surfaces[i], "material", ANARI_MATERIAL, &ctx->mat);
+      anariCommit(dev, ctx->surfaces[i]);
+    }
+
+    setObjectArrayParam(ctx, ctx->group, "surface", ctx->surfaces, ANARI_SURFACE, ctx->numGeoms);
+  }
+  if (ctx->geom)
+  {
+    ctx->surface = anariNewSurface(dev);
+    anariSetParameter(dev, ctx->surface, "name", ANARI_STRING, "benchSurface");
+    anariSetParameter(dev, ctx->surface, "geometry", ANARI_GEOMETRY, &ctx->geom);
+    anariSetParameter(dev, ctx->surface, "material", ANARI_MATERIAL, &ctx->mat);
+    anariCommit(dev, ctx->surface);
+
+    setObjectArrayParam(ctx, ctx->group, "surface", &ctx->surface, ANARI_SURFACE, 1);
+  }
+  if (ctx->volume)
+  {
+    setObjectArrayParam(ctx, ctx->group, "volume", &ctx->volume, ANARI_VOLUME, 1);
+  }
+  anariCommit(dev, ctx->group);
+
+  if (!ctx->instances)
+  {
+    ctx->numInstances = 1;
+    ctx->instances = (ANARIInstance*)calloc(1, sizeof(ANARIInstance));
+    ctx->instances[0] = anariNewInstance(dev);
+    anariSetParameter(dev, ctx->instances[0], "name", ANARI_STRING, "benchInstance");
+    anariSetParameter(dev, ctx->instances[0], "group", ANARI_GROUP, &ctx->group);
+    anariCommit(dev, ctx->instances[0]);
+  }
+
+  ctx->world = anariNewWorld(dev);
+  anariSetParameter(dev, ctx->world, "name", ANARI_STRING, "benchWorld");
+  setObjectArrayParam(ctx, ctx->world, "instance", ctx->instances, ANARI_INSTANCE, ctx->numInstances);
+  anariCommit(dev, ctx->world);
+}
+
+/******************************************************************/
+// Triangle mesh: a (scale x scale) vertex grid, displaced per timestep.
+
+static void fillMeshPositions(BenchContext* ctx, int timeStep)
+{
+  uint64_t n = ctx->scale;
+  for (uint64_t y = 0; y < n; ++y)
+  {
+    for (uint64_t x = 0; x < n; ++x)
+    {
+      float* pos = ctx->positions + (y*n + x) * 3;
+      pos[0] = (float)x;
+      pos[1] = (float)y;
+      pos[2] = sinf((float)x * 0.1f + (float)timeStep * 0.2f) * cosf((float)y * 0.1f);
+    }
+  }
+}
+
+static void setupMesh(BenchContext* ctx)
+{
+  uint64_t n = ctx->scale;
+  ctx->numPositions = n * n;
+  ctx->numIndices = (n - 1) * (n - 1) * 2 * 3;
+  ctx->positions = (float*)malloc(ctx->numPositions * 3 * sizeof(float));
+  ctx->indices = (uint32_t*)malloc(ctx->numIndices * sizeof(uint32_t));
+  ctx->numPrimitives = ctx->numIndices / 3;
+
+  uint32_t* idx = ctx->indices;
+  for (uint64_t y = 0; y < n - 1; ++y)
+  {
+    for (uint64_t x = 0; x < n - 1; ++x)
+    {
+      uint32_t v0 = (uint32_t)(y*n + x);
+      *idx++ = v0; *idx++ = v0 + 1; *idx++ = v0 + (uint32_t)n;
+      *idx++ = v0 + 1; *idx++ = v0 + (uint32_t)n + 1; *idx++ = v0 + (uint32_t)n;
+    }
+  }
+
+  ctx->geom = anariNewGeometry(ctx->dev, "triangle");
+  anariSetParameter(ctx->dev, ctx->geom, "name", ANARI_STRING, "benchMesh");
+  setArrayParam(ctx, ctx->geom, "primitive.index", ctx->indices, ANARI_UINT32_VEC3, ctx->numIndices / 3, 3 * sizeof(uint32_t));
+
+  createSceneHierarchy(ctx);
+}
+
+static void updateMesh(BenchContext* ctx, int timeStep)
+{
+  fillMeshPositions(ctx, timeStep);
+
+  setTimeStepParam(ctx, ctx->geom, timeStep);
+  setArrayParam(ctx, ctx->geom, "vertex.position", ctx->positions, ANARI_FLOAT32_VEC3, ctx->numPositions, 3 * sizeof(float));
+  anariCommit(ctx->dev, ctx->geom);
+}
+
+/******************************************************************/
+// Indexed spheres: scale points with per-vertex radii, output through a point instancer.
+
+static void setupSpheres(BenchContext* ctx)
+{
+  ctx->numPositions = ctx->scale;
+  ctx->numIndices = ctx->scale;
+  ctx->positions = (float*)malloc(ctx->numPositions * 3 * sizeof(float));
+  ctx->attribs = (float*)malloc(ctx->numPositions * sizeof(float));
+  ctx->indices = (uint32_t*)malloc(ctx->numIndices * sizeof(uint32_t));
+  ctx->numPrimitives = ctx->numIndices;
+
+  for (uint64_t i = 0; i < ctx->numIndices; ++i)
+  {
+    ctx->indices[i] = (uint32_t)i;
+    ctx->attribs[i] = 0.1f + 0.01f * (float)(i % 10);
+  }
+
+  int usePointInstancer = 1;
+  ctx->geom = anariNewGeometry(ctx->dev, "sphere");
+  anariSetParameter(ctx->dev, ctx->geom, "name", ANARI_STRING, "benchSpheres");
+  anariSetParameter(ctx->dev, ctx->geom, "usd::usepointinstancer", ANARI_INT32, &usePointInstancer);
+  setArrayParam(ctx, ctx->geom, "primitive.index", ctx->indices, ANARI_UINT32, ctx->numIndices, sizeof(uint32_t));
+  setArrayParam(ctx, ctx->geom, "vertex.radius", ctx->attribs, ANARI_FLOAT32, ctx->numPositions, sizeof(float));
+
+  createSceneHierarchy(ctx);
+}
+
+static void updateSpheres(BenchContext* ctx, int timeStep)
+{
+  for (uint64_t i = 0; i < ctx->numPositions; ++i)
+  {
+    float* pos = ctx->positions + i * 3;
+    pos[0] = (float)(i % 100);
+    pos[1] = (float)((i / 100) % 100);
+    pos[2] = (float)(i / 10000) + 0.1f * (float)timeStep;
+  }
+
+  setTimeStepParam(ctx, ctx->geom, timeStep);
+  setArrayParam(ctx, ctx->geom, "vertex.position", ctx->positions, ANARI_FLOAT32_VEC3, ctx->numPositions, 3 * sizeof(float));
+  anariCommit(ctx->dev, ctx->geom);
+}
+
+/******************************************************************/
+// Sticks: scale line segments, converted to cylinders by the device.
+
+static void setupSticks(BenchContext* ctx)
+{
+  ctx->numPositions = ctx->scale * 2;
+  ctx->numIndices = ctx->scale * 2;
+  ctx->positions = (float*)malloc(ctx->numPositions * 3 * sizeof(float));
+  ctx->attribs = (float*)malloc(ctx->scale * sizeof(float));
+  ctx->indices = (uint32_t*)malloc(ctx->numIndices * sizeof(uint32_t));
+  ctx->numPrimitives = ctx->scale;
+
+  for (uint64_t i = 0; i < ctx->numIndices; ++i)
+    ctx->indices[i] = (uint32_t)i;
+  for (uint64_t i = 0; i < ctx->scale; ++i)
+    ctx->attribs[i] = 0.05f;
+
+  ctx->geom = anariNewGeometry(ctx->dev, "cylinder");
+  anariSetParameter(ctx->dev, ctx->geom, "name", ANARI_STRING, "benchSticks");
+  setArrayParam(ctx, ctx->geom, "primitive.index", ctx->indices, ANARI_UINT32_VEC2, ctx->numIndices / 2, 2 * sizeof(uint32_t));
+  setArrayParam(ctx, ctx->geom, "primitive.radius", ctx->attribs, ANARI_FLOAT32, ctx->scale, sizeof(float));
+
+  createSceneHierarchy(ctx);
+}
+
+static void updateSticks(BenchContext* ctx, int timeStep)
+{
+  for (uint64_t i = 0; i < ctx->scale; ++i)
+  {
+    float* pos = ctx->positions + i * 6;
+    pos[0] = (float)(i % 100); pos[1] = (float)(i / 100); pos[2] = 0.0f;
+    pos[3] = pos[0] + 0.5f; pos[4] = pos[1] + 0.5f; pos[5] = 1.0f + 0.1f * (float)timeStep;
+  }
+
+  setTimeStepParam(ctx, ctx->geom, timeStep);
+  setArrayParam(ctx, ctx->geom, "vertex.position", ctx->positions, ANARI_FLOAT32_VEC3, ctx->numPositions, 3 * sizeof(float));
+  anariCommit(ctx->dev, ctx->geom);
+}
+
+/******************************************************************/
+// Curves: scale curves of 16 segments each.
+
+#define BENCH_CURVE_SEGMENTS 16
+
+static void setupCurves(BenchContext* ctx)
+{
+  uint64_t vertsPerCurve = BENCH_CURVE_SEGMENTS + 1;
+  ctx->numPositions = ctx->scale * vertsPerCurve;
+  ctx->numIndices = ctx->scale * BENCH_CURVE_SEGMENTS;
+  ctx->positions = (float*)malloc(ctx->numPositions * 3 * sizeof(float));
+  ctx->indices = (uint32_t*)malloc(ctx->numIndices * sizeof(uint32_t));
+  ctx->numPrimitives = ctx->numIndices;
+
+  for (uint64_t c = 0; c < ctx->scale; ++c)
+    for (uint64_t s = 0; s < BENCH_CURVE_SEGMENTS; ++s)
+      ctx->indices[c * BENCH_CURVE_SEGMENTS + s] = (uint32_t)(c * vertsPerCurve + s);
+
+  float radius = 0.02f;
+  ctx->geom = anariNewGeometry(ctx->dev, "curve");
+  anariSetParameter(ctx->dev, ctx->geom, "name", ANARI_STRING, "benchCurves");
+  anariSetParameter(ctx->dev, ctx->geom, "radius", ANARI_FLOAT32, &radius);
+  setArrayParam(ctx, ctx->geom, "primitive.index", ctx->indices, ANARI_UINT32, ctx->numIndices, sizeof(uint32_t));
+
+  createSceneHierarchy(ctx);
+}
+
+static void updateCurves(BenchContext* ctx, int timeStep)
+{
+  uint64_t vertsPerCurve = BENCH_CURVE_SEGMENTS + 1;
+  for (uint64_t c = 0; c < ctx->scale; ++c)
+  {
+    for (uint64_t v = 0; v < vertsPerCurve; ++v)
+    {
+      float* pos = ctx->positions + (c * vertsPerCurve + v) * 3;
+      pos[0] = (float)(c % 100) + 0.2f * sinf((float)v * 0.5f + (float)timeStep * 0.1f);
+      pos[1] = (float)(c / 100);
+      pos[2] = (float)v * 0.25f;
+    }
+  }
+
+  setTimeStepParam(ctx, ctx->geom, timeStep);
+  setArrayParam(ctx, ctx->geom, "vertex.position", ctx->positions, ANARI_FLOAT32_VEC3, ctx->numPositions, 3 * sizeof(float));
+  anariCommit(ctx->dev, ctx->geom);
+}
+
+/******************************************************************/
+// Structured volumes: a scale^3 float field with a linear transfer function.
+
+static void setupVolumeCommon(BenchContext* ctx, int preClassified)
+{
+  ANARIDevice dev = ctx->dev;
+  uint64_t n = ctx->scale;
+  ctx->numPositions = n * n * n;
+  ctx->attribs = (float*)malloc(ctx->numPositions * sizeof(float));
+  ctx->numPrimitives = ctx->numPositions;
+
+  ctx->field = anariNewSpatialField(dev, "structuredRegular");
+  anariSetParameter(dev, ctx->field, "name", ANARI_STRING, "benchField");
+
+  float tfColors[] = { 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+  float tfOpacities[] = { 0.0f, 0.5f, 1.0f };
+  float valueRange[] = { -1.0f, 1.0f };
+
+  ctx->volume = anariNewVolume(dev, "scivis");
+  anariSetParameter(dev, ctx->volume, "name", ANARI_STRING, "benchVolume");
+  anariSetParameter(dev, ctx->volume, "usd::preclassified", ANARI_BOOL, &preClassified);
+  anariSetParameter(dev, ctx->volume, "valueRange", ANARI_FLOAT32_VEC2, valueRange);
+  setArrayParam(ctx, ctx->volume, "color", tfColors, ANARI_FLOAT32_VEC3, 3, 3 * sizeof(float));
+  setArrayParam(ctx, ctx->volume, "opacity", tfOpacities, ANARI_FLOAT32, 3, sizeof(float));
+}
+
+static void setupVolume(BenchContext* ctx)
+{
+  setupVolumeCommon(ctx, 0);
+}
+
+static void setupVolumePreclassified(BenchContext* ctx)
+{
+  setupVolumeCommon(ctx, 1);
+}
+
+static void updateVolume(BenchContext* ctx, int timeStep)
+{
+  ANARIDevice dev = ctx->dev;
+  uint64_t n = ctx->scale;
+  for (uint64_t z = 0; z < n; ++z)
+    for (uint64_t y = 0; y < n; ++y)
+      for (uint64_t x = 0; x < n; ++x)
+        ctx->attribs[(z*n + y)*n + x] = sinf((float)(x + timeStep) * 0.1f) * cosf((float)y * 0.1f) * sinf((float)z * 0.05f);
+
+  ANARIArray3D array = anariNewArray3D(dev, ctx->attribs, 0, 0, ANARI_FLOAT32, n, n, n, 0, 0, 0);
+  anariCommit(dev, array);
+  setTimeStepParam(ctx, ctx->field, timeStep);
+  anariSetParameter(dev, ctx->field, "data", ANARI_ARRAY, &array);
+  anariRelease(dev, array);
+  anariCommit(dev, ctx->field);
+  ctx->bytesSubmitted += ctx->numPositions * sizeof(float);
+
+  if (timeStep == 0)
+  {
+    anariSetParameter(dev, ctx->volume, "field", ANARI_SPATIAL_FIELD, &ctx->field);
+    anariCommit(dev, ctx->volume);
+    createSceneHierarchy(ctx);
+  }
+  else
+    anariCommit(dev, ctx->volume);
+}
+
+/******************************************************************/
+// Instance hierarchy: scale instances of one shared group, transforms animated per timestep.
+
+static void setupInstances(BenchContext* ctx)
+{
+  uint64_t savedScale = ctx->scale;
+  ctx->scale = 8; // Small shared mesh
+  setupMesh(ctx);
+  updateMesh(ctx, 0);
+  ctx->scale = savedScale;
+
+  // setupMesh created a single instance and world; replace the instance array
+  ANARIDevice dev = ctx->dev;
+  anariRelease(dev, ctx->instances[0]);
+  free(ctx->instances);
+
+  ctx->numInstances = ctx->scale;
+  ctx->instances = (ANARIInstance*)calloc(ctx->numInstances, sizeof(ANARIInstance));
+  ctx->numPrimitives = ctx->numInstances;
+  for (uint64_t i = 0; i < ctx->numInstances; ++i)
+  {
+    char instName[64];
+    snprintf(instName, sizeof(instName), "benchInstance_%llu", (unsigned long long)i);
+
+    ctx->instances[i] = anariNewInstance(dev);
+    anariSetParameter(dev, ctx->instances[i], "name", ANARI_STRING, instName);
+    anariSetParameter(dev, ctx->instances[i], "group", ANARI_GROUP, &ctx->group);
+  }
+
+  setObjectArrayParam(ctx, ctx->world, "instance", ctx->instances, ANARI_INSTANCE, ctx->numInstances);
+}
+
+static void updateInstances(BenchContext* ctx, int timeStep)
+{
+  for (uint64_t i = 0; i < ctx->numInstances; ++i)
+  {
+    float transform[12] = { 1, 0, 0, 0, 1, 0, 0, 0, 1,
+      (float)(i % 100) * 10.0f, (float)(i / 100) * 10.0f, (float)timeStep };
+    anariSetParameter(ctx->dev, ctx->instances[i], "transform", ANARI_FLOAT32_MAT3x4, transform);
+    anariCommit(ctx->dev, ctx->instances[i]);
+    ctx->bytesSubmitted += sizeof(transform);
+  }
+}
+
+// Same instances, with all transforms submitted as a single array on the world
+static void updateInstancesBulk(BenchContext* ctx, int timeStep)
+{
+  if (!ctx->attribs)
+  {
+    ctx->attribs = (float*)malloc(ctx->numInstances * 12 * sizeof(float));
+    for (uint64_t i = 0; i < ctx->numInstances; ++i)
+      anariCommit(ctx->dev, ctx->instances[i]);
+  }
+
+  for (uint64_t i = 0; i < ctx->numInstances; ++i)
+  {
+    float transform[12] = { 1, 0, 0, 0, 1, 0, 0, 0, 1,
+      (float)(i % 100) * 10.0f, (float)(i / 100) * 10.0f, (float)timeStep };
+    memcpy(ctx->attribs + i * 12, transform, sizeof(transform));
+  }
+  setArrayParam(ctx, ctx->world, "usd::instance.transform", ctx->attribs, ANARI_FLOAT32_MAT3x4, ctx->numInstances, 12 * sizeof(float));
+}
+
+/******************************************************************/
+// Many meshes: scale independent 32x32 vertex grids, each displaced and committed per timestep.
+
+static const uint64_t manyMeshesRes = 32;
+
+static void setupManyMeshes(BenchContext* ctx)
+{
+  uint64_t n = manyMeshesRes;
+  ctx->numPositions = n * n;
+  ctx->numIndices = (n - 1) * (n - 1) * 2 * 3;
+  ctx->positions = (float*)malloc(ctx->numPositions * 3 * sizeof(float));
+  ctx->indices = (uint32_t*)malloc(ctx->numIndices * sizeof(uint32_t));
+  ctx->numGeoms = ctx->scale;
+  ctx->numPrimitives = ctx->numGeoms * (ctx->numIndices / 3);
+
+  uint32_t* idx = ctx->indices;
+  for (uint64_t y = 0; y < n - 1; ++y)
+  {
+    for (uint64_t x = 0; x < n - 1; ++x)
+    {
+      uint32_t v0 = (uint32_t)(y*n + x);
+      *idx++ = v0; *idx++ = v0 + 1; *idx++ = v0 + (uint32_t)n;
+      *idx++ = v0 + 1; *idx++ = v0 + (uint32_t)n + 1; *idx++ = v0 + (uint32_t)n;
+    }
+  }
+
+  ctx->geoms = (ANARIGeometry*)calloc(ctx->numGeoms, sizeof(ANARIGeometry));
+  for (uint64_t i = 0; i < ctx->numGeoms; ++i)
+  {
+    char geomName[64];
+    snprintf(geomName, sizeof(geomName), "benchMesh_%llu", (unsigned long long)i);
+
+    ctx->geoms[i] = anariNewGeometry(ctx->dev, "triangle");
+    anariSetParameter(ctx->dev, ctx->geoms[i], "name", ANARI_STRING, geomName);
+    setArrayParam(ctx, ctx->geoms[i], "primitive.index", ctx->indices, ANARI_UINT32_VEC3, ctx->numIndices / 3, 3 * sizeof(uint32_t));
+  }
+
+  createSceneHierarchy(ctx);
+}
+
+static void updateManyMeshes(BenchContext* ctx, int timeStep)
+{
+  uint64_t n = manyMeshesRes;
+  for (uint64_t i = 0; i < ctx->numGeoms; ++i)
+  {
+    for (uint64_t y = 0; y < n; ++y)
+    {
+      for (uint64_t x = 0; x < n; ++x)
+      {
+        float* pos = ctx->positions + (y*n + x) * 3;
+        pos[0] = (float)(x + (i % 100) * n);
+        pos[1] = (float)(y + (i / 100) * n);
+        pos[2] = sinf((float)x * 0.1f + (float)(timeStep + i) * 0.2f) * cosf((float)y * 0.1f);
+      }
+    }
+
+    setTimeStepParam(ctx, ctx->geoms[i], timeStep);
+    setArrayParam(ctx, ctx->geoms[i], "vertex.position", ctx->positions, ANARI_FLOAT32_VEC3, ctx->numPositions, 3 * sizeof(float));
+    anariCommit(ctx->dev, ctx->geoms[i]);
+  }
+}
+
+/******************************************************************/
+static const BenchWorkload workloads[] = {
+  { "mesh", 1024, 1, setupMesh, updateMesh },
+  { "spheres", 1000000, 1, setupSpheres, updateSpheres },
+  { "sticks", 200000, 1, setupSticks, updateSticks },
+  { "curves", 20000, 1, setupCurves, updateCurves },
+  { "volume", 128, 1, setupVolume, updateVolume },
+  { "volumePreclassified", 128, 1, setupVolumePreclassified, updateVolume },
+  { "instances", 10000, 4, setupInstances, updateInstances },
+  { "instancesBulk", 10000, 4, setupInstances, updateInstancesBulk },
+  { "timeseries", 128, 100, setupMesh, updateMesh },
+  { "manyMeshes", 2000, 4, setupManyMeshes, updateManyMeshes }
+};
+
+static void releaseContext(BenchContext* ctx)
+{
+  ANARIDevice dev = ctx->dev;
+  for (uint64_t i = 0; i < ctx->numInstances; ++i)
+    anariRelease(dev, ctx->instances[i]);
+  if (ctx->world) anariRelease(dev, ctx->world);
+  if (ctx->group) anariRelease(dev, ctx->group);
+  if (ctx->surface) anariRelease(dev, ctx->surface);
+  for (uint64_t i = 0; i < ctx->numGeoms; ++i)
+  {
+    if (ctx->surfaces) anariRelease(dev, ctx->surfaces[i]);
+    anariRelease(dev, ctx->geoms[i]);
+  }
+  if (ctx->mat) anariRelease(dev, ctx->mat);
+  if (ctx->geom) anariRelease(dev, ctx->geom);
+  if (ctx->volume) anariRelease(dev, ctx->volume);
+  if (ctx->field) anariRelease(dev, ctx->field);
+
+  free(ctx->instances);
+  free(ctx->surfaces);
+  free(ctx->geoms);
+  free(ctx->positions);
+  free(ctx->attribs);
+  free(ctx->indices);
+}
+
+static ANARIDevice createDevice(ANARILibrary lib, const BenchParams* params, int batchChanges, int parallelWrites)
+{
+  ANARIDevice dev = anariNewDevice(lib, "usd");
+  if (!dev)
+    return NULL;
+
+  anariSetParameter(dev, dev, "usd::serialize.location", ANARI_STRING, params->location);
+  anariSetParameter(dev, dev, "usd::serialize.outputbinary", ANARI_BOOL, &params->outputBinary);
+  anariSetParameter(dev, dev, "usd::pointinstancer.threshold", ANARI_INT32, &params->pointInstancerThreshold);
+  anariSetParameter(dev, dev, "usd::batchchanges", ANARI_BOOL, &batchChanges);
+  anariSetParameter(dev, dev, "usd::parallelwrites", ANARI_BOOL, &parallelWrites);
+  anariCommit(dev, dev);
+
+  return dev;
+}
+
+static void runWorkload(ANARILibrary lib, const BenchParams* params, const BenchWorkload* workload, int batchChanges, int parallelWrites, BenchResult* result)
+{
+  BenchContext ctx;
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.params = params;
+  ctx.scale = params->scale ? params->scale : workload->defaultScale;
+  ctx.dev = createDevice(lib, params, batchChanges, parallelWrites);
+  if (!ctx.dev)
+    return;
+
+  int timeSteps = params->timeSteps ? params->timeSteps : workload->defaultTimeSteps;
+
+  ANARIRenderer renderer = anariNewRenderer(ctx.dev, "default");
+  ANARIFrame frame = anariNewFrame(ctx.dev);
+  anariSetParameter(ctx.dev, frame, "renderer", ANARI_RENDERER, &renderer);
+  anariCommit(ctx.dev, frame);
+
+  double t0 = nowSeconds();
+
+  workload->setup(&ctx);
+
+  double t1 = nowSeconds();
+
+  for (int timeStep = 0; timeStep < timeSteps; ++timeStep)
+  {
+    double timeValue = (double)timeStep;
+    anariSetParameter(ctx.dev, ctx.dev, "usd::timestep", ANARI_FLOAT64, &timeValue);
+
+    workload->update(&ctx, timeStep);
+
+    if (ctx.world)
+    {
+      anariCommit(ctx.dev, ctx.world);
+      anariSetParameter(ctx.dev, frame, "world", ANARI_WORLD, &ctx.world);
+      anariCommit(ctx.dev, frame);
+    }
+    anariRenderFrame(ctx.dev, frame);
+    anariFrameReady(ctx.dev, frame, ANARI_WAIT);
+  }
+
+  double t2 = nowSeconds();
+
+  anariSetParameter(ctx.dev, ctx.dev, "usd::garbagecollect", ANARI_VOID_POINTER, 0);
+
+  double t3 = nowSeconds();
+
+  releaseContext(&ctx);
+  anariRelease(ctx.dev, renderer);
+  anariRelease(ctx.dev, frame);
+  anariRelease(ctx.dev, ctx.dev);
+
+  double t4 = nowSeconds();
+
+  result->name = workload->name;
+  result->scale = ctx.scale;
+  result->timeSteps = timeSteps;
+  result->batchChanges = batchChanges;
+  result->parallelWrites = parallelWrites;
+  result->setupSec = t1 - t0;
+  result->updateSec = t2 - t1;
+  result->garbageCollectSec = t3 - t2;
+  result->releaseSec = t4 - t3;
+  result->bytesSubmitted = ctx.bytesSubmitted;
+  result->numPrimitives = ctx.numPrimitives;
+  result->peakRssKB = peakRssKB();
+}
+
+// Runs the workload in a child process, which reports its own peak RSS, as the peak of a process never decreases.
+// Without fork(), the peak is that of the bench process so far.
+static void runWorkloadIsolated(ANARILibrary lib, const BenchParams* params, const BenchWorkload* workload, int batchChanges, int parallelWrites, BenchResult* result)
+{
+#ifdef _WIN32
+  runWorkload(lib, params, workload, batchChanges, parallelWrites, result);
+#else
+  int resultPipe[2];
+  if (pipe(resultPipe) != 0)
+  {
+    runWorkload(lib, params, workload, batchChanges, parallelWrites, result);
+    return;
+  }
+
+  fflush(stdout);
+  fflush(stderr);
+
+  pid_t child = fork();
+  if (child == 0)
+  {
+    close(resultPipe[0]);
+    runWorkload(lib, params, workload, batchChanges, parallelWrites, result);
+    ssize_t numWritten = write(resultPipe[1], result, sizeof(BenchResult)); // The name points into the workload table, which is at the same address in the parent
+    close(resultPipe[1]);
+    _exit(numWritten == (ssize_t)sizeof(BenchResult) ? 0 : 1);
+  }
+
+  close(resultPipe[1]);
+  if (child < 0)
+  {
+    close(resultPipe[0]);
+    runWorkload(lib, params, workload, batchChanges, parallelWrites, result);
+    return;
+  }
+
+  ssize_t numRead = read(resultPipe[0], result, sizeof(BenchResult));
+  close(resultPipe[0]);
+
+  int status = 0;
+  if (waitpid(child, &status, 0) != child || numRead != (ssize_t)sizeof(BenchResult))
+    memset(result, 0, sizeof(BenchResult));
+#endif
+}
+
+static void writeResults(FILE* out, const BenchParams* params, const BenchResult* results, int numResults)
+{
+#ifdef _WIN32
+  const char* peakRssScope = "process";
+#else
+  const char* peakRssScope = "workload";
+#endif
+  fprintf(out, "{\n  \"location\": \"%s\",\n  \"outputBinary\": %s,\n  \"pointInstancerThreshold\": %d,\n  \"peakRssScope\": \"%s\",\n  \"workloads\": [",
+    params->location, params->outputBinary ? "true" : "false", params->pointInstancerThreshold, peakRssScope);
+
+  for (int i = 0; i < numResults; ++i)
+  {
+    const BenchResult* r = results + i;
+    double totalSec = r->setupSec + r->updateSec + r->garbageCollectSec + r->releaseSec;
+    double authorSec = r->setupSec + r->updateSec;
+    double mbPerSec = authorSec > 0.0 ? ((double)r->bytesSubmitted / (1024.0*1024.0)) / authorSec : 0.0;
+    double primsPerSec = r->updateSec > 0.0 ? ((double)r->numPrimitives * r->timeSteps) / r->updateSec : 0.0;
+
+    fprintf(out, "%s\n    {\n"
+      "      \"name\": \"%s\",\n"
+      "      \"scale\": %llu,\n"
+      "      \"timeSteps\": %d,\n"
+      "      \"batchChanges\": %s,\n"
+      "      \"parallelWrites\": %s,\n"
+      "      \"phases\": { \"setup\": %.6f, \"update\": %.6f, \"garbageCollect\": %.6f, \"release\": %.6f, \"total\": %.6f },\n"
+      "      \"bytesSubmitted\": %llu,\n"
+      "      \"throughputMBps\": %.3f,\n"
+      "      \"primitivesPerSec\": %.1f,\n"
+      "      \"peakRssKB\": %ld\n"
+      "    }",
+      i ? "," : "",
+      r->name, (unsigned long long)r->scale, r->timeSteps, r->batchChanges ? "true" : "false", r->parallelWrites ? "true" : "false",
+      r->setupSec, r->updateSec, r->garbageCollectSec, r->releaseSec, totalSec,
+      (unsigned long long)r->bytesSubmitted, mbPerSec, primsPerSec, r->peakRssKB);
+  }
+
+  fprintf(out, "\n  ]\n}\n");
+}
+
+int main(int argc, const char **argv)
+{
+  BenchParams params;
+  memset(&params, 0, sizeof(params));
+  params.location = "void";
+  params.workload = "all";
+  params.batching = "on";
+  params.parallel = "off";
+
+  for (int i = 1; i < argc; ++i)
+  {
+    int hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--location") == 0 && hasValue)
+      params.location = argv[++i];
+    else if (strcmp(argv[i], "--workload") == 0 && hasValue)
+      params.workload = argv[++i];
+    else if (strcmp(argv[i], "--scale") == 0 && hasValue)
+      params.scale = strtoull(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--timesteps") == 0 && hasValue)
+      params.timeSteps = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--output") == 0 && hasValue)
+      params.outputFile = argv[++i];
+    else if (strcmp(argv[i], "--binary") == 0)
+      params.outputBinary = 1;
+    else if (strcmp(argv[i], "--pointinstancer") == 0 && hasValue)
+      params.pointInstancerThreshold = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--batching") == 0 && hasValue
+      && (strcmp(argv[i + 1], "on") == 0 || strcmp(argv[i + 1], "off") == 0 || strcmp(argv[i + 1], "compare") == 0))
+      params.batching = argv[++i];
+    else if (strcmp(argv[i], "--parallel") == 0 && hasValue
+      && (strcmp(argv[i + 1], "on") == 0 || strcmp(argv[i + 1], "off") == 0 || strcmp(argv[i + 1], "compare") == 0))
+      params.parallel = argv[++i];
+    else
+    {
+      fprintf(stderr, "Usage: %s [--location <dir>|void] [--workload <name>|all] [--scale <n>] [--timesteps <n>] [--binary] [--pointinstancer <n>] [--batching on|off|compare] [--parallel on|off|compare] [--output <file.json>]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  ANARILibrary lib = anariLoadLibrary(g_libraryType, statusFunc, NULL);
+  if (!lib) {
+    fprintf(stderr, "ERROR: could not load library '%s'\n", g_libraryType);
+    return 1;
+  }
+
+  const int numWorkloads = (int)(sizeof(workloads) / sizeof(workloads[0]));
+  BenchResult results[4 * sizeof(workloads) / sizeof(workloads[0])];
+  int numResults = 0;
+
+  // Batching modes to run each workload with, in order
+  int compareBatching = strcmp(params.batching, "compare") == 0;
+  int batchModes[2] = { strcmp(params.batching, "off") != 0, 0 };
+  int numBatchModes = compareBatching ? 2 : 1;
+
+  // Parallel write modes to run each workload with, in order
+  int compareParallel = strcmp(params.parallel, "compare") == 0;
+  int parallelModes[2] = { strcmp(params.parallel, "on") == 0, 1 };
+  int numParallelModes = compareParallel ? 2 : 1;
+
+  for (int w = 0; w < numWorkloads; ++w)
+  {
+    if (strcmp(params.workload, "all") != 0 && strcmp(params.workload, workloads[w].name) != 0)
+      continue;
+
+    for (int b = 0; b < numBatchModes; ++b)
+    {
+      for (int p = 0; p < numParallelModes; ++p)
+      {
+        fprintf(stderr, "running workload '%s'%s%s...\n", workloads[w].name,
+          compareBatching ? (batchModes[b] ? " with batching" : " without batching") : "",
+          compareParallel ? (parallelModes[p] ? " with parallel writes" : " without parallel writes") : "");
+
+        memset(results + numResults, 0, sizeof(BenchResult));
+        runWorkloadIsolated(lib, &params, workloads + w, batchModes[b], parallelModes[p], results + numResults);
+        if (results[numResults].name)
+          ++numResults;
+      }
+    }
+  }
+
+  if (numResults == 0)
+  {
+    fprintf(stderr, "ERROR: no workload named '%s' was run\n", params.workload);
+    anariUnloadLibrary(lib);
+    return 1;
+  }
+
+  FILE* out = params.outputFile ? fopen(params.outputFile, "w") : stdout;
+  if (!out) {
+    fprintf(stderr, "ERROR: could not open '%s' for writing\n", params.outputFile);
+    anariUnloadLibrary(lib);
+    return 1;
+  }
+  writeResults(out, &params, results, numResults);
+  if (out != stdout)
+    fclose(out);
+
+  anariUnloadLibrary(lib);
+
+  return 0;
+}
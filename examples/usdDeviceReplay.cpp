@@ -0,0 +1,467 @@
+// Copyright 2021 NVIDIA Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Re-executes a capture recorded by the USD device (usd::capture.file or ANARI_USD_CAPTURE_FILE) at full speed.
+//
+// Usage: usdDeviceReplay <capture file> [--location <dir>|void]
+//
+// --location overrides any usd::serialize.location recorded in the capture.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "anari/anari.h"
+#include "UsdDeviceCaptureFormat.h"
+
+static const char *g_libraryType = "usd";
+
+static void statusFunc(void *userData,
+  ANARIDevice device,
+  ANARIObject source,
+  ANARIDataType sourceType,
+  ANARIStatusSeverity severity,
+  ANARIStatusCode code,
+  const char *message)
+{
+  if (severity == ANARI_SEVERITY_FATAL_ERROR) {
+    fprintf(stderr, "[FATAL] %s\n", message);
+  }
+  else if (severity == ANARI_SEVERITY_ERROR) {
+    fprintf(stderr, "[ERROR] %s\n", message);
+  }
+  else if (severity == ANARI_SEVERITY_WARNING) {
+    fprintf(stderr, "[WARN ] %s\n", message);
+  }
+}
+
+class CaptureReader
+{
+public:
+  bool open(const char *fileName)
+  {
+    file.open(fileName, std::ios_base::in | std::ios_base::binary);
+    if (!file.is_open())
+      return false;
+
+    char magic[sizeof(usdCaptureMagic)];
+    uint32_t version = 0;
+    file.read(magic, sizeof(magic));
+    read(version);
+
+    return file.good() && std::memcmp(magic, usdCaptureMagic, sizeof(magic)) == 0
+      && version == usdCaptureVersion;
+  }
+
+  template <typename T>
+  bool read(T &value)
+  {
+    file.read(reinterpret_cast<char *>(&value), sizeof(T));
+    return file.good();
+  }
+
+  bool readBytes(void *bytes, uint64_t numBytes)
+  {
+    file.read(static_cast<char *>(bytes), numBytes);
+    return file.good();
+  }
+
+  bool readString(std::string &str)
+  {
+    uint32_t length = 0;
+    if (!read(length))
+      return false;
+    str.resize(length);
+    return length == 0 || readBytes(&str[0], length);
+  }
+
+private:
+  std::ifstream file;
+};
+
+class CaptureReplay
+{
+public:
+  CaptureReplay(ANARIDevice dev, const char *locationOverride)
+    : dev(dev), locationOverride(locationOverride)
+  {
+    objects[usdCaptureDeviceId] = dev;
+  }
+
+  bool run(CaptureReader &reader)
+  {
+    uint8_t record = 0;
+    while (reader.read(record))
+    {
+      ++numRecords;
+      bool success = true;
+      switch (static_cast<UsdCaptureRecord>(record))
+      {
+      case UsdCaptureRecord::END: return true;
+      case UsdCaptureRecord::NEW_OBJECT: success = replayNewObject(reader); break;
+      case UsdCaptureRecord::NEW_ARRAY: success = replayNewArray(reader); break;
+      case UsdCaptureRecord::ARRAY_DATA: success = replayArrayData(reader); break;
+      case UsdCaptureRecord::BLOB: success = readBlob(reader); break;
+      case UsdCaptureRecord::SET_PARAM: success = replaySetParameter(reader); break;
+      case UsdCaptureRecord::UNSET_PARAM: success = replayUnsetParameter(reader); break;
+      case UsdCaptureRecord::COMMIT:
+      case UsdCaptureRecord::RELEASE:
+      case UsdCaptureRecord::RETAIN:
+      case UsdCaptureRecord::RENDER_FRAME:
+        success = replayObjectCall(reader, static_cast<UsdCaptureRecord>(record)); break;
+      default:
+        fprintf(stderr, "ERROR: unknown record type %d\n", (int)record);
+        return false;
+      }
+      if (!success)
+      {
+        fprintf(stderr, "ERROR: truncated or corrupt capture at record %llu\n", (unsigned long long)numRecords);
+        return false;
+      }
+    }
+
+    fprintf(stderr, "WARNING: capture ends without END record, it may be incomplete\n");
+    return true;
+  }
+
+  uint64_t numRecords = 0;
+  uint64_t numFrames = 0;
+  uint64_t numBlobBytes = 0;
+
+private:
+  struct ArrayPayload
+  {
+    bool isObjectArray = false;
+    std::vector<uint64_t> objectIds;
+    const std::vector<char> *blob = nullptr;
+  };
+
+  ANARIObject getObject(uint64_t id) const
+  {
+    auto it = objects.find(id);
+    return it != objects.end() ? it->second : nullptr;
+  }
+
+  bool readPayload(CaptureReader &reader, ArrayPayload &payload)
+  {
+    uint8_t isObjectArray = 0;
+    if (!reader.read(isObjectArray))
+      return false;
+    payload.isObjectArray = isObjectArray != 0;
+
+    if (payload.isObjectArray)
+    {
+      uint64_t count = 0;
+      if (!reader.read(count))
+        return false;
+      payload.objectIds.resize(count);
+      return count == 0 || reader.readBytes(payload.objectIds.data(), count * sizeof(uint64_t));
+    }
+
+    uint64_t blobId = 0, size = 0;
+    if (!reader.read(blobId) || !reader.read(size))
+      return false;
+    auto blobIt = blobs.find(blobId);
+    if (blobIt == blobs.end() || blobIt->second.size() != size)
+      return false;
+    payload.blob = &blobIt->second;
+    return true;
+  }
+
+  void copyPayload(const ArrayPayload &payload, void *dest, uint64_t destSize) const
+  {
+    if (!dest)
+      return;
+
+    if (payload.isObjectArray)
+    {
+      ANARIObject *handles = static_cast<ANARIObject *>(dest);
+      uint64_t count = std::min<uint64_t>(payload.objectIds.size(), destSize / sizeof(ANARIObject));
+      for (uint64_t i = 0; i < count; ++i)
+        handles[i] = getObject(payload.objectIds[i]);
+    }
+    else
+      std::memcpy(dest, payload.blob->data(), std::min<uint64_t>(payload.blob->size(), destSize));
+  }
+
+  uint64_t payloadSize(const ArrayPayload &payload) const
+  {
+    return payload.isObjectArray ? payload.objectIds.size() * sizeof(ANARIObject) : payload.blob->size();
+  }
+
+  bool readBlob(CaptureReader &reader)
+  {
+    uint64_t blobId = 0, size = 0;
+    if (!reader.read(blobId) || !reader.read(size))
+      return false;
+
+    std::vector<char> &blob = blobs[blobId];
+    blob.resize(size);
+    numBlobBytes += size;
+    return size == 0 || reader.readBytes(blob.data(), size);
+  }
+
+  bool replayNewObject(CaptureReader &reader)
+  {
+    uint64_t id = 0;
+    uint32_t type = 0;
+    std::string subtype;
+    if (!reader.read(id) || !reader.read(type) || !reader.readString(subtype))
+      return false;
+
+    const char *sub = subtype.c_str();
+    ANARIObject object = nullptr;
+    switch ((ANARIDataType)type)
+    {
+    case ANARI_SAMPLER: object = anariNewSampler(dev, sub); break;
+    case ANARI_MATERIAL: object = anariNewMaterial(dev, sub); break;
+    case ANARI_GEOMETRY: object = anariNewGeometry(dev, sub); break;
+    case ANARI_SPATIAL_FIELD: object = anariNewSpatialField(dev, sub); break;
+    case ANARI_SURFACE: object = anariNewSurface(dev); break;
+    case ANARI_VOLUME: object = anariNewVolume(dev, sub); break;
+    case ANARI_GROUP: object = anariNewGroup(dev); break;
+    case ANARI_INSTANCE: object = anariNewInstance(dev); break;
+    case ANARI_WORLD: object = anariNewWorld(dev); break;
+    case ANARI_RENDERER: object = anariNewRenderer(dev, sub); break;
+    case ANARI_FRAME: object = anariNewFrame(dev); break;
+    default:
+      fprintf(stderr, "WARNING: skipping object of unsupported type %u\n", type);
+      break;
+    }
+    objects[id] = object;
+    return true;
+  }
+
+  bool replayNewArray(CaptureReader &reader)
+  {
+    uint64_t id = 0;
+    uint32_t type = 0;
+    uint8_t numDims = 0;
+    uint64_t numItems[3] = {0, 0, 0};
+    int64_t byteStrides[3] = {0, 0, 0};
+    uint8_t hasAppMemory = 0;
+    if (!reader.read(id) || !reader.read(type) || !reader.read(numDims))
+      return false;
+    for (int i = 0; i < 3; ++i)
+    {
+      if (!reader.read(numItems[i]) || !reader.read(byteStrides[i]))
+        return false;
+    }
+    if (!reader.read(hasAppMemory))
+      return false;
+
+    // App memory is owned by the replay until exit, so it outlives any use by the device
+    void *appMemory = nullptr;
+    if (hasAppMemory)
+    {
+      ArrayPayload payload;
+      if (!readPayload(reader, payload))
+        return false;
+
+      uint64_t size = payloadSize(payload);
+      appMemoryBuffers.emplace_back(new char[size > 0 ? size : 1]);
+      appMemory = appMemoryBuffers.back().get();
+      copyPayload(payload, appMemory, size);
+    }
+
+    ANARIDataType elementType = (ANARIDataType)type;
+    ANARIObject array = nullptr;
+    // The recorded dimensionality is used, as trailing dimensions of size 1 don't reveal it
+    if (numDims == 3)
+      array = anariNewArray3D(dev, appMemory, nullptr, nullptr, elementType,
+        numItems[0], numItems[1], numItems[2], byteStrides[0], byteStrides[1], byteStrides[2]);
+    else if (numDims == 2)
+      array = anariNewArray2D(dev, appMemory, nullptr, nullptr, elementType,
+        numItems[0], numItems[1], byteStrides[0], byteStrides[1]);
+    else
+      array = anariNewArray1D(dev, appMemory, nullptr, nullptr, elementType,
+        numItems[0], byteStrides[0]);
+
+    objects[id] = array;
+    return true;
+  }
+
+  bool replayArrayData(CaptureReader &reader)
+  {
+    uint64_t id = 0;
+    ArrayPayload payload;
+    if (!reader.read(id) || !readPayload(reader, payload))
+      return false;
+
+    ANARIArray array = (ANARIArray)getObject(id);
+    if (array)
+    {
+      void *mapped = anariMapArray(dev, array);
+      copyPayload(payload, mapped, payloadSize(payload));
+      anariUnmapArray(dev, array);
+    }
+    return true;
+  }
+
+  bool replaySetParameter(CaptureReader &reader)
+  {
+    uint64_t id = 0;
+    std::string name;
+    uint32_t type = 0;
+    uint8_t kind = 0;
+    if (!reader.read(id) || !reader.readString(name) || !reader.read(type) || !reader.read(kind))
+      return false;
+
+    ANARIObject object = getObject(id);
+    switch (static_cast<UsdCaptureParamKind>(kind))
+    {
+    case UsdCaptureParamKind::OBJECT:
+    {
+      uint64_t valueId = 0;
+      if (!reader.read(valueId))
+        return false;
+      ANARIObject value = getObject(valueId);
+      if (object)
+        anariSetParameter(dev, object, name.c_str(), (ANARIDataType)type, &value);
+      break;
+    }
+    case UsdCaptureParamKind::STRING:
+    {
+      std::string value;
+      if (!reader.readString(value))
+        return false;
+      if (locationOverride && id == usdCaptureDeviceId && name == "usd::serialize.location")
+        value = locationOverride;
+      if (object)
+        anariSetParameter(dev, object, name.c_str(), (ANARIDataType)type, value.c_str());
+      break;
+    }
+    default:
+    {
+      uint32_t size = 0;
+      if (!reader.read(size))
+        return false;
+      valueBuffer.resize(size);
+      if (size > 0 && !reader.readBytes(valueBuffer.data(), size))
+        return false;
+      if (object)
+        anariSetParameter(dev, object, name.c_str(), (ANARIDataType)type, size > 0 ? valueBuffer.data() : nullptr);
+      break;
+    }
+    }
+    return true;
+  }
+
+  bool replayUnsetParameter(CaptureReader &reader)
+  {
+    uint64_t id = 0;
+    std::string name;
+    if (!reader.read(id) || !reader.readString(name))
+      return false;
+
+    ANARIObject object = getObject(id);
+    if (object)
+      anariUnsetParameter(dev, object, name.c_str());
+    return true;
+  }
+
+  bool replayObjectCall(CaptureReader &reader, UsdCaptureRecord record)
+  {
+    uint64_t id = 0;
+    if (!reader.read(id))
+      return false;
+
+    ANARIObject object = getObject(id);
+    if (!object)
+      return true;
+
+    switch (record)
+    {
+    case UsdCaptureRecord::COMMIT: anariCommit(dev, object); break;
+    case UsdCaptureRecord::RELEASE: anariRelease(dev, object); break;
+    case UsdCaptureRecord::RETAIN: anariRetain(dev, object); break;
+    case UsdCaptureRecord::RENDER_FRAME:
+      anariRenderFrame(dev, (ANARIFrame)object);
+      anariFrameReady(dev, (ANARIFrame)object, ANARI_WAIT);
+      ++numFrames;
+      break;
+    default: break;
+    }
+    return true;
+  }
+
+  ANARIDevice dev;
+  const char *locationOverride;
+
+  std::unordered_map<uint64_t, ANARIObject> objects;
+  std::unordered_map<uint64_t, std::vector<char>> blobs;
+  std::vector<std::unique_ptr<char[]>> appMemoryBuffers;
+  std::vector<char> valueBuffer;
+};
+
+int main(int argc, const char **argv)
+{
+  const char *captureFile = nullptr;
+  const char *locationOverride = nullptr;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp(argv[i], "--location") == 0 && i + 1 < argc)
+      locationOverride = argv[++i];
+    else if (!captureFile && argv[i][0] != '-')
+      captureFile = argv[i];
+    else
+    {
+      fprintf(stderr, "Usage: %s <capture file> [--location <dir>|void]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  if (!captureFile)
+  {
+    fprintf(stderr, "Usage: %s <capture file> [--location <dir>|void]\n", argv[0]);
+    return 1;
+  }
+
+  CaptureReader reader;
+  if (!reader.open(captureFile))
+  {
+    fprintf(stderr, "ERROR: '%s' is not a valid USD device capture\n", captureFile);
+    return 1;
+  }
+
+  ANARILibrary lib = anariLoadLibrary(g_libraryType, statusFunc, NULL);
+  if (!lib) {
+    fprintf(stderr, "ERROR: could not load library '%s'\n", g_libraryType);
+    return 1;
+  }
+
+  ANARIDevice dev = anariNewDevice(lib, "usd");
+  if (!dev) {
+    fprintf(stderr, "ERROR: could not create device\n");
+    anariUnloadLibrary(lib);
+    return 1;
+  }
+
+  bool success = false;
+  double seconds = 0.0;
+  {
+    CaptureReplay replay(dev, locationOverride);
+
+    auto startTime = std::chrono::steady_clock::now();
+    success = replay.run(reader);
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    printf("{\n  \"capture\": \"%s\",\n  \"success\": %s,\n  \"records\": %llu,\n  \"frames\": %llu,\n"
+      "  \"blobBytes\": %llu,\n  \"seconds\": %.6f\n}\n",
+      captureFile, success ? "true" : "false", (unsigned long long)replay.numRecords,
+      (unsigned long long)replay.numFrames, (unsigned long long)replay.numBlobBytes, seconds);
+
+    anariRelease(dev, dev);
+  }
+
+  anariUnloadLibrary(lib);
+
+  return success ? 0 : 1;
+}